@@ -40,9 +40,18 @@ enum struct UpdateMode : std::uint8_t {
     None,   ///< The creator will throw an exception (unless the OverwriteMode is not None).
     Append, ///< The creator will append the new items to the existing archive.
     Update, ///< New items whose path already exists in the archive will overwrite the old ones, other will be appended.
+    Sync,   ///< Like Update, but old items with the same size and modification time as the new ones are kept as-is.
     BIT7Z_DEPRECATED_ENUMERATOR( Overwrite, Update, "Since v4.0. Please use the UpdateMode::Update enumerator." ) ///< @deprecated since v4.0; please use the UpdateMode::Update enumerator.
 };
 
+/**
+ * @brief Enumeration representing the order in which the new items are passed to the output archive.
+ */
+enum struct SortStrategy : std::uint8_t {
+    None,  ///< The new items are compressed in the same order in which they were added.
+    ByType ///< The new items are sorted by extension, then by name, then by size (like 7-Zip's -mqs switch).
+};
+
 /**
  * @brief The EncryptionScope enum represents the scope of encryption applied when setting a password on an archive.
  */
@@ -148,6 +157,38 @@ class BitAbstractArchiveCreator : public BitAbstractArchiveHandler {
          */
         BIT7Z_NODISCARD auto storeOpenFiles() const noexcept -> bool;
 
+        /**
+         * @return whether the metadata of the files found while indexing directories is read only
+         *         when needed during the compression.
+         */
+        BIT7Z_NODISCARD auto lazyFileMetadata() const noexcept -> bool;
+
+        /**
+         * @return whether identical input files are detected and stored only once (where the format allows it).
+         */
+        BIT7Z_NODISCARD auto deduplicateFiles() const noexcept -> bool;
+
+        /**
+         * @return the strategy used for sorting the new items before compressing them.
+         */
+        BIT7Z_NODISCARD auto sortStrategy() const noexcept -> SortStrategy;
+
+        /**
+         * @return whether the input files are probed for detecting the incompressible ones.
+         */
+        BIT7Z_NODISCARD auto storeIncompressibleFiles() const noexcept -> bool;
+
+        /**
+         * @return the size of the blocks in which the output archive files are written,
+         *         or zero if the writes are not buffered.
+         */
+        BIT7Z_NODISCARD auto writeBufferSize() const noexcept -> std::uint32_t;
+
+        /**
+         * @return whether the archives compressed to standard output streams are always written sequentially.
+         */
+        BIT7Z_NODISCARD auto sequentialOutput() const noexcept -> bool;
+
         /**
          * @brief Sets up a password for the output archives.
          *
@@ -341,6 +382,103 @@ class BitAbstractArchiveCreator : public BitAbstractArchiveHandler {
          */
         void setStoreOpenFiles( bool storeOpenFiles ) noexcept;
 
+        /**
+         * @brief Sets whether the metadata of the files found while indexing directories (e.g., their size and
+         *        timestamps) is read only when needed during the compression, rather than when adding them.
+         *
+         * When enabled, indexing a directory only lists its content, using the file types reported by the directory
+         * listing; the metadata of each file is then read when 7-Zip first asks for it. Hence, adding large directory
+         * trees is much faster, and the metadata reads are spread over the compression rather than preceding it.
+         *
+         * @note Errors reading the metadata of a file are reported by the compression, rather than when adding it.
+         *
+         * @param lazyFileMetadata if true, the metadata of the indexed files will be read only when needed.
+         */
+        void setLazyFileMetadata( bool lazyFileMetadata ) noexcept;
+
+        /**
+         * @brief Sets whether the input files with identical content should be detected before the compression.
+         *
+         * The files are first grouped by size, and only the files having the same size as some other file
+         * are hashed to find the identical ones. Then:
+         *  - in tar archives, each duplicate file is stored as a hard link to the first copy of its content;
+         *  - in the other formats, each duplicate file is compressed right after the first copy of its content,
+         *    so that solid formats (e.g., 7z) can encode it as a cheap match of the previous data.
+         *
+         * @note WIM archives always store identical content only once, regardless of this option.
+         *
+         * @param deduplicateFiles if true, identical input files will be detected and deduplicated.
+         */
+        void setDeduplicateFiles( bool deduplicateFiles ) noexcept;
+
+        /**
+         * @brief Sets the strategy used for sorting the new items before compressing them.
+         *
+         * Sorting the items by type puts files with similar content next to each other; hence, in solid archives,
+         * they share the same solid blocks and dictionaries, improving both the compression ratio and speed.
+         *
+         * @note Directories are not sorted, and they are kept before the files. Moreover, the items of an
+         *       updated archive are kept in their original order, before the new ones.
+         *
+         * @param strategy the sort strategy to be used.
+         */
+        void setSortStrategy( SortStrategy strategy ) noexcept;
+
+        /**
+         * @brief Sets whether the input files should be probed for detecting the incompressible ones
+         *        (e.g., JPEG images, videos, archives, and encrypted files) before the compression.
+         *
+         * Each file is judged incompressible if it has the extension of an already compressed file type,
+         * or if the first block of its content has an entropy close to the one of random data.
+         * If all the new files are incompressible, they are stored without compression (i.e., using the Copy method),
+         * avoiding to waste time compressing them. The incompressible files found by the last compression
+         * can be retrieved using BitOutputArchive::incompressibleItems().
+         *
+         * @note Storing without compression is possible only for formats supporting multiple compression methods
+         *       (i.e., 7z and zip), and if no dictionary or word size was set.
+         *       Moreover, 7-Zip uses the same compression method for all the new items:
+         *       if only some files are incompressible, all the files are compressed as usual; in this case,
+         *       the zip format still stores each incompressible file as-is when compressing it does not reduce
+         *       its size, and the LZMA2 method stores the incompressible chunks of data as-is.
+         *
+         * @param storeIncompressibleFiles if true, the incompressible input files will be detected.
+         */
+        void setStoreIncompressibleFiles( bool storeIncompressibleFiles ) noexcept;
+
+        /**
+         * @brief Sets the size of the blocks in which the creator writes the output archive files.
+         *
+         * The many small writes made by 7-Zip while compressing are coalesced in memory, and written to the file
+         * only when a whole block is ready; short seeks back for patching the archive headers are served in memory
+         * too, as long as the patched data is still in the current block.
+         *
+         * @note By default, the size is zero, i.e., the writes are not buffered.
+         *
+         * @note This setting does not apply to multi-volume archives.
+         *
+         * @param size  the size of the write buffer blocks, in bytes.
+         */
+        void setWriteBufferSize( std::uint32_t size ) noexcept;
+
+        /**
+         * @brief Sets whether the archives compressed to standard output streams must be written sequentially.
+         *
+         * In sequential mode, the archive is written from start to end without ever seeking back in the output
+         * stream (e.g., zip archives store the sizes and CRCs of the items in data descriptors after their data);
+         * hence, the output stream can be non-seekable (e.g., a pipe or a socket), and the data is delivered to it
+         * as soon as it is compressed.
+         *
+         * @note Only the formats having the FormatFeatures::SequentialOutput feature (i.e., tar, gzip, bzip2, xz,
+         *       and zip) can be written sequentially; compressing to a sequential output with other formats throws
+         *       a BitException.
+         *
+         * @note By default, this option is false, and the sequential mode is used only when the output stream
+         *       is detected to be non-seekable (i.e., when it does not report its current position).
+         *
+         * @param sequentialOutput if true, the archives are always written sequentially to standard output streams.
+         */
+        void setSequentialOutput( bool sequentialOutput ) noexcept;
+
         /**
          * @brief Sets a property for the output archive format as described by the 7-zip documentation
          * (e.g., https://sevenzip.osdn.jp/chm/cmdline/switches/method.htm).
@@ -398,6 +536,12 @@ class BitAbstractArchiveCreator : public BitAbstractArchiveHandler {
         std::uint32_t mThreadsCount;
         bool mStoreSymbolicLinks;
         bool mStoreOpenFiles;
+        bool mLazyFileMetadata;
+        bool mDeduplicateFiles;
+        SortStrategy mSortStrategy;
+        bool mStoreIncompressibleFiles;
+        std::uint32_t mWriteBufferSize;
+        bool mSequentialOutput;
         std::map< std::wstring, BitPropVariant > mExtraProperties;
 };
 
@@ -185,6 +185,16 @@ class BitAbstractArchiveHandler {
          */
         BIT7Z_NODISCARD auto overwriteMode() const noexcept -> OverwriteMode;
 
+        /**
+         * @return the size of the blocks in which input files are read, or zero if input files are not buffered.
+         */
+        BIT7Z_NODISCARD auto readBufferSize() const noexcept -> std::uint32_t;
+
+        /**
+         * @return a boolean value indicating whether the archive files opened by the handler are memory-mapped.
+         */
+        BIT7Z_NODISCARD auto useMemoryMapping() const noexcept -> bool;
+
         /**
          * @brief Sets up a password to be used by the archive handler.
          *
@@ -271,6 +281,36 @@ class BitAbstractArchiveHandler {
          */
         void setOverwriteMode( OverwriteMode mode );
 
+        /**
+         * @brief Sets the size of the blocks in which the handler reads the input files (i.e., the archives
+         * to be opened, and the files to be compressed).
+         *
+         * Small reads are then served from memory rather than from the file, and the previously read block
+         * is kept too, so that short backward seeks (e.g., while parsing archive headers) are served from memory.
+         * Reads larger than the block size bypass the buffer.
+         *
+         * @note By default, the size is zero, i.e., input files are not buffered.
+         *
+         * @param size  the size of the read buffer blocks, in bytes.
+         */
+        void setReadBufferSize( std::uint32_t size ) noexcept;
+
+        /**
+         * @brief Sets whether the handler must memory-map the archive files it opens (including the volumes
+         * of multi-volume archives).
+         *
+         * Reading a memory-mapped archive does not need any system call, which speeds up the formats whose
+         * handlers make many small random reads (e.g., zip, 7z, iso, and wim).
+         *
+         * @note Files that cannot be mapped (e.g., pipes, or files too big for the address space of the process)
+         * are read normally.
+         *
+         * @note The archive files must not be truncated by other processes while they are open.
+         *
+         * @param useMapping  if true, the handler will memory-map the archive files.
+         */
+        void setUseMemoryMapping( bool useMapping ) noexcept;
+
     protected:
         explicit BitAbstractArchiveHandler(
             const Bit7zLibrary& lib,
@@ -283,6 +323,8 @@ class BitAbstractArchiveHandler {
         tstring mPassword;
         bool mRetainDirectories;
         OverwriteMode mOverwriteMode;
+        std::uint32_t mReadBufferSize;
+        bool mUseMemoryMapping;
 
         //CALLBACKS
         TotalCallback mTotalCallback;
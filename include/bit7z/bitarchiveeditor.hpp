@@ -37,6 +37,14 @@ enum struct DeletePolicy : std::uint8_t {
     RecurseDirs  ///< Delete the item; if it is a folder, its contents are recursively deleted too.
 };
 
+/**
+ * @brief Enumeration representing when the archive should be reopened after applying the changes to it.
+ */
+enum struct ReopenPolicy : std::uint8_t {
+    Immediate, ///< Reopen the archive right after applying the changes.
+    Deferred   ///< Reopen the archive only when the next operation needs to read it.
+};
+
 /**
  * @brief The BitArchiveEditor class allows creating new file archives or updating old ones.
  *        Update operations supported are the addition of new items,
@@ -204,8 +212,14 @@ class BIT7Z_MAYBE_UNUSED BitArchiveEditor final : public BitArchiveWriter {
 
         /**
          * @brief Applies the requested changes (i.e., rename/update/delete operations) to the input archive.
+         *
+         * @note With ReopenPolicy::Deferred, the edited archive is not opened again until some operation needs
+         *       to read it (e.g., renaming, updating, or deleting an item); hence, applying changes that only add
+         *       new items, or destroying the editor right after applying the changes, avoids reopening it.
+         *
+         * @param policy the policy to be used for reopening the edited archive.
          */
-        void applyChanges();
+        void applyChanges( ReopenPolicy policy = ReopenPolicy::Immediate );
 
     private:
         EditedItems mEditedItems;
@@ -222,6 +236,8 @@ class BIT7Z_MAYBE_UNUSED BitArchiveEditor final : public BitArchiveWriter {
 
         auto hasNewProperties( std::uint32_t index ) const noexcept -> bool override;
 
+        auto hasEditedItems() const noexcept -> bool override;
+
         void markItemAsDeleted( std::uint32_t index );
 
         void setEditedItem( std::uint32_t index, BitInputItem&& item );
@@ -13,6 +13,7 @@
 #include "bit7zlibrary.hpp"
 #include "bitabstractarchiveopener.hpp"
 #include "bitarchiveiteminfo.hpp"
+#include "bitbufferview.hpp"
 #include "bitdefines.hpp"
 #include "bitexception.hpp"
 #include "bitformat.hpp"
@@ -150,6 +151,45 @@ class BitArchiveReader final : public BitAbstractArchiveOpener, public BitInputA
             const tstring& password = {}
         ) = delete;
 
+        /**
+         * @brief Constructs a BitArchiveReader object, opening the archive in the bytes referenced by the given view.
+         *
+         * @note The bytes are not copied: the reader reads them on later extraction, so they must outlive
+         * the BitArchiveReader.
+         *
+         * @param lib           the 7z library used.
+         * @param inArchive     the view of the bytes of the archive to be read.
+         * @param archiveStart  whether to search for the archive's start throughout the entire file
+         *                      or only at the beginning.
+         * @param format        the format of the input archive.
+         * @param password      (optional) the password needed for opening the input archive.
+         */
+        BitArchiveReader(
+            const Bit7zLibrary& lib,
+            BitBufferView inArchive,
+            ArchiveStartOffset archiveStart,
+            const BitInFormat& format BIT7Z_DEFAULT_FORMAT,
+            const tstring& password = {}
+        );
+
+        /**
+         * @brief Constructs a BitArchiveReader object, opening the archive in the bytes referenced by the given view.
+         *
+         * @note The bytes are not copied: the reader reads them on later extraction, so they must outlive
+         * the BitArchiveReader.
+         *
+         * @param lib           the 7z library used.
+         * @param inArchive     the view of the bytes of the archive to be read.
+         * @param format        the format of the input archive.
+         * @param password      (optional) the password needed for opening the input archive.
+         */
+        BitArchiveReader(
+            const Bit7zLibrary& lib,
+            BitBufferView inArchive,
+            const BitInFormat& format BIT7Z_DEFAULT_FORMAT,
+            const tstring& password = {}
+        );
+
         /**
          * @brief Constructs a BitArchiveReader object, opening the archive from the standard input stream.
          *
@@ -0,0 +1,32 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITBUFFERINGMETRICS_HPP
+#define BITBUFFERINGMETRICS_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace bit7z {
+
+/**
+ * @brief Statistics about the buffering of the data streamed from a parent archive to a nested one.
+ */
+struct BufferingMetrics {
+    std::uint64_t memoryLimit;                  ///< The current memory limit of the buffers (in bytes).
+    std::uint64_t peakMemoryUsage;              ///< The peak memory used by the buffers (in bytes).
+    std::chrono::nanoseconds producerStallTime; ///< Time spent by the parent archive waiting for room in the buffers.
+    std::chrono::nanoseconds consumerStallTime; ///< Time spent by the nested archive waiting for new data.
+    std::uint32_t growCount;                    ///< Number of times the adaptive memory limit was increased.
+    std::uint32_t shrinkCount;                  ///< Number of times the adaptive memory limit was decreased.
+};
+
+} // namespace bit7z
+
+#endif //BITBUFFERINGMETRICS_HPP
@@ -0,0 +1,131 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITBUFFERVIEW_HPP
+#define BITBUFFERVIEW_HPP
+
+#include "bitdefines.hpp"
+#include "bittypes.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace bit7z {
+
+// NOLINTBEGIN(*-explicit-conversions, *-avoid-c-arrays, *-pro-bounds-pointer-arithmetic)
+/**
+ * @brief A non-owning, read-only view over a contiguous sequence of bytes.
+ *
+ * BitBufferView is essentially a C++11-compatible equivalent of `std::span< const byte_t >`.
+ * It allows using data held in memory regions not owned by a buffer_t (e.g., memory-mapped files,
+ * arenas, or std::string objects) as input of compression and extraction operations, without copying it.
+ *
+ * @note The viewed bytes must outlive any object using the view.
+ */
+class BitBufferView final {
+    public:
+        using element_type = const byte_t;
+        using value_type = byte_t;
+        using size_type = std::size_t;
+        using const_pointer = const byte_t*;
+        using const_iterator = const_pointer;
+
+        /**
+         * @brief Constructs an empty BitBufferView.
+         */
+        constexpr BitBufferView() noexcept : mData{ nullptr }, mSize{ 0 } {}
+
+        /**
+         * @brief Constructs a BitBufferView referencing the given bytes.
+         *
+         * @param data  a pointer to the first byte to be viewed.
+         * @param size  the number of bytes to be viewed.
+         */
+        constexpr BitBufferView( const_pointer data, size_type size ) noexcept
+            : mData{ size == 0 ? nullptr : data }, mSize{ data == nullptr ? 0 : size } {}
+
+        /**
+         * @brief Constructs a BitBufferView referencing the bytes stored in the given buffer.
+         *
+         * @note This constructor can't be constexpr until C++20 due to std::vector's methods.
+         *
+         * @param buffer  the buffer to be viewed.
+         */
+        /* implicit */ BitBufferView( const buffer_t& buffer ) noexcept
+            : BitBufferView{ buffer.data(), buffer.size() } {}
+
+        /**
+         * @brief Constructs a BitBufferView referencing the bytes stored in the given std::array.
+         *
+         * @tparam N      the number of bytes in the array.
+         * @param buffer  the array to be viewed.
+         */
+        template< std::size_t N >
+        /* implicit */ constexpr BitBufferView( const std::array< byte_t, N >& buffer ) noexcept
+            : BitBufferView{ buffer.data(), N } {}
+
+        /**
+         * @brief Constructs a BitBufferView referencing the bytes stored in the given C array.
+         *
+         * @tparam N      the number of bytes in the array.
+         * @param buffer  the array to be viewed.
+         */
+        template< std::size_t N >
+        /* implicit */ constexpr BitBufferView( const byte_t (&buffer)[ N ] ) noexcept
+            : BitBufferView{ static_cast< const_pointer >( buffer ), N } {}
+
+        /**
+         * @return a pointer to the beginning of the viewed bytes.
+         */
+        BIT7Z_NODISCARD
+        constexpr auto data() const noexcept -> const_pointer {
+            return mData;
+        }
+
+        /**
+         * @return the number of viewed bytes.
+         */
+        BIT7Z_NODISCARD
+        constexpr auto size() const noexcept -> size_type {
+            return mSize;
+        }
+
+        /**
+         * @return true if and only if the view does not reference any byte.
+         */
+        BIT7Z_NODISCARD
+        constexpr auto empty() const noexcept -> bool {
+            return mSize == 0;
+        }
+
+        /**
+         * @return an iterator to the beginning of the viewed bytes.
+         */
+        BIT7Z_NODISCARD
+        constexpr auto begin() const noexcept -> const_iterator {
+            return mData;
+        }
+
+        /**
+         * @return an iterator to the end of the viewed bytes.
+         */
+        BIT7Z_NODISCARD
+        constexpr auto end() const noexcept -> const_iterator {
+            return mData + mSize;
+        }
+
+    private:
+        const_pointer mData;
+        size_type mSize;
+};
+// NOLINTEND(*-explicit-conversions, *-avoid-c-arrays, *-pro-bounds-pointer-arithmetic)
+
+} // namespace bit7z
+
+#endif //BITBUFFERVIEW_HPP
@@ -17,6 +17,7 @@
 #include "bitabstractarchivecreator.hpp"
 #include "bitformat.hpp"
 #include "bitoutputarchive.hpp"
+#include "bitsegmentedbuffer.hpp"
 #include "bittypes.hpp"
 
 #include <ostream>
@@ -100,6 +101,23 @@ class BitCompressor : public BitAbstractArchiveCreator {
             outputArchive.compressTo( outBuffer );
         }
 
+        /**
+         * @brief Compresses the input file to the output segmented buffer.
+         *
+         * @param inFile     the file to be compressed.
+         * @param outBuffer  the segmented buffer going to contain the output archive.
+         * @param inputName  (optional) the name to give to the compressed file inside the output archive.
+         */
+        void compressFile(
+            Input inFile,
+            BitSegmentedBuffer& outBuffer,
+            const tstring& inputName = {}
+        ) const {
+            BitOutputArchive outputArchive{ *this };
+            outputArchive.addFile( inFile, inputName );
+            outputArchive.compressTo( outBuffer );
+        }
+
         /**
          * @brief Compresses the input file to the output stream.
          *
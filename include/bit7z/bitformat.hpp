@@ -27,7 +27,8 @@ enum struct FormatFeatures : std::uint8_t {
     CompressionLevel = 1u << 2u, ///< The format is able to use different compression levels.
     Encryption       = 1u << 3u, ///< The format supports archive encryption.
     HeaderEncryption = 1u << 4u, ///< The format can encrypt the file names.
-    MultipleMethods  = 1u << 5u  ///< The format can use different compression methods.
+    MultipleMethods  = 1u << 5u, ///< The format can use different compression methods.
+    SequentialOutput = 1u << 6u  ///< The format can be written to non-seekable output streams.
 };
 
 /**
@@ -12,6 +12,7 @@
 #include "bit7zlibrary.hpp"
 #include "bitabstractarchivehandler.hpp"
 #include "bitarchiveitemoffset.hpp"
+#include "bitbufferview.hpp"
 #include "bitdefines.hpp"
 #include "bitformat.hpp"
 #include "bitfs.hpp"
@@ -108,6 +109,23 @@ class BitInputArchive {
             ArchiveStartOffset startOffset = ArchiveStartOffset::None
         );
 
+        /**
+         * @brief Constructs a BitInputArchive object, opening the archive in the bytes referenced by the given view.
+         *
+         * @note The bytes are not copied, so they must outlive this object.
+         *
+         * @param handler     the reference to the BitAbstractArchiveHandler object containing all the settings to
+         *                    be used for reading the input archive
+         * @param inBuffer    the view of the bytes of the input archive
+         * @param startOffset (optional) whether to search for the archive's start throughout the entire file
+         *                    or only at the beginning. The default behavior is to search at the beginning.
+         */
+        BitInputArchive(
+            const BitAbstractArchiveHandler& handler,
+            BitBufferView inBuffer,
+            ArchiveStartOffset startOffset = ArchiveStartOffset::None
+        );
+
         /**
          * @brief Constructs a BitInputArchive object, opening the archive by reading the given input stream.
          *
@@ -690,6 +708,8 @@ class BitInputArchive {
 
         void extractSequentially( BufferQueue& queue, std::uint32_t index ) const;
 
+        void extractSequentially( BufferQueue& queue, FilterCallback filterCallback ) const;
+
         void extractArchive( ExtractCallback* callback, std::int32_t mode, BitIndicesView indices = {} ) const;
 
         BIT7Z_NODISCARD
@@ -707,7 +727,16 @@ class BitInputArchive {
         const BitAbstractArchiveHandler& mArchiveHandler;
         tstring mArchivePath;
 
-        explicit BitInputArchive( const BitAbstractArchiveHandler& handler, const BitArchiveItemOffset& nestedItem );
+        /* Creates the archive object of a nested archive, which is opened sequentially only when needed.
+         * If the format is BitFormat::Auto, the archive object is created by setNestedArchiveFormat. */
+        BitInputArchive(
+            const BitAbstractArchiveHandler& handler,
+            const tstring& nestedArchivePath,
+            const BitInFormat& format
+        );
+
+        // Recreates the archive object of a nested archive using the given (detected) format.
+        void setNestedArchiveFormat( const BitInFormat& format );
 
         BIT7Z_NODISCARD
         auto openArchiveStream(
@@ -10,11 +10,13 @@
 #ifndef BITINPUTITEM_HPP
 #define BITINPUTITEM_HPP
 
+#include "bitbufferview.hpp"
 #include "bitfs.hpp"
 #include "bitinputarchive.hpp"
 
 #include <cstdint>
 #include <functional>
+#include <limits>
 
 struct ISequentialInStream;
 
@@ -38,7 +40,7 @@ struct FilesystemInputItem final {
 #endif
 };
 
-using BufferInputItem = std::reference_wrapper< const buffer_t >;
+using BufferInputItem = BitBufferView;
 
 using StdInputItem = std::reference_wrapper< std::istream >;
 
@@ -59,6 +61,7 @@ struct InputItemProperties final {
     FILETIME creationTime;
     std::uint32_t attributes;
     InputItemType inputType;
+    bool lazyMetadata; // If true, only the type of the (filesystem) item is known, and its metadata must be read.
 };
 
 } // namespace detail
@@ -69,6 +72,12 @@ struct InputItemProperties final {
  */
 class BitInputItem final {
     public:
+        /**
+         * @brief The value returned by size() for items whose size is not known before compressing them
+         *        (e.g., non-seekable standard streams like pipes).
+         */
+        static constexpr std::uint64_t kUnknownSize = std::numeric_limits< std::uint64_t >::max();
+
         explicit BitInputItem( const bit7zfs::path& itemPath, SymlinkPolicy symlinkPolicy = SymlinkPolicy::Follow );
 
         BitInputItem(
@@ -77,10 +86,17 @@ class BitInputItem final {
             SymlinkPolicy symlinkPolicy = SymlinkPolicy::Follow
         );
 
-        BitInputItem( const bit7zfs::path& searchPath, const bit7zfs::directory_entry& entry, SymlinkPolicy symlinkPolicy );
+        BitInputItem(
+            const bit7zfs::path& searchPath,
+            const bit7zfs::directory_entry& entry,
+            SymlinkPolicy symlinkPolicy,
+            bool lazyMetadata = false
+        );
 
         BitInputItem( const buffer_t& buffer, const tstring& path );
 
+        BitInputItem( BitBufferView buffer, const tstring& path );
+
         BitInputItem( std::istream& stream, const tstring& path );
 
         BitInputItem( const BitInputArchive& inputArchive, std::uint32_t index, const tstring& newPath );
@@ -98,7 +114,15 @@ class BitInputItem final {
         auto isSymLink() const noexcept -> bool;
 
         /**
-         * @return the uncompressed size of the item, in bytes.
+         * @return true if the size of the item is known before compressing it.
+         */
+        BIT7Z_NODISCARD
+        auto hasKnownSize() const noexcept -> bool;
+
+        /**
+         * @note For filesystem items indexed with lazy metadata, this reads the item's metadata if needed.
+         *
+         * @return the uncompressed size of the item, in bytes, or kUnknownSize if it is not known in advance.
          */
         BIT7Z_NODISCARD
         auto size() const noexcept -> std::uint64_t;
@@ -110,6 +134,8 @@ class BitInputItem final {
         auto path() const -> const native_string&;
 
         /**
+         * @note For filesystem items indexed with lazy metadata, this reads the item's metadata if needed.
+         *
          * @return the filesystem attributes of the item.
          */
         BIT7Z_NODISCARD
@@ -160,14 +186,28 @@ class BitInputItem final {
     private:
         friend class BitOutputArchive;
         friend class BitArchiveEditor;
+        friend class InputItemsStore;
 
         // For internal use only: provides the input stream for this item to be used during compression.
         // On Windows, storeOpenFiles requests shared read/write access, allowing the compression of files
-        // locked by other processes. Returns S_OK on success, or an error HRESULT otherwise.
+        // locked by other processes. A non-zero readBufferSize makes file items read in blocks of that size.
+        // Returns S_OK on success, or an error HRESULT otherwise.
         BIT7Z_NODISCARD
-        auto getStream( ISequentialInStream** inStream, bool storeOpenFiles ) const -> HRESULT;
+        auto getStream( ISequentialInStream** inStream, bool storeOpenFiles, std::uint32_t readBufferSize ) const
+            -> HRESULT;
+
+        // For internal use only: reads the metadata of the filesystem item at the given path.
+        BIT7Z_NODISCARD
+        static auto readFileProperties( const native_string& itemPath, SymlinkPolicy symlinkPolicy )
+            -> detail::InputItemProperties;
+
+        // For internal use only: reads the metadata of the item, if it was not read yet.
+        void loadMetadata() const;
+
+        void tryLoadMetadata() const noexcept;
 
-        detail::InputItemProperties mProperties;
+        // Note: the metadata of lazily indexed filesystem items is read on first use, even from const methods.
+        mutable detail::InputItemProperties mProperties;
         // Note: we need to store paths as strings rather than bit7zfs::path as the public API is in C++14.
         native_string mPath; // std::wstring on Windows, std::string elsewhere.
         sevenzip_string mInArchivePath; // std::wstring on every OS, used by 7-Zip.
@@ -0,0 +1,66 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITINPUTSOURCE_HPP
+#define BITINPUTSOURCE_HPP
+
+#include "bitdefines.hpp"
+#include "bitinputitem.hpp"
+
+#include <cstdint>
+
+namespace bit7z {
+
+/**
+ * @brief The BitInputSource abstract class represents a source of items to be compressed,
+ *        which are produced only when the compression needs them, rather than being all stored in memory.
+ *
+ * During the compression, the items are requested in increasing index order, and the same item
+ * might be requested more than once in a row (e.g., once for each of its properties).
+ * Moreover, some archive formats read all the items' properties before reading their content,
+ * so the items might be requested again in a second pass.
+ *
+ * @note The number of items must be known in advance, as it is required by 7-Zip before starting the compression.
+ */
+class BitInputSource {
+    public:
+        BitInputSource() = default;
+
+        BitInputSource( const BitInputSource& ) = default;
+
+        BitInputSource( BitInputSource&& ) = default;
+
+        auto operator=( const BitInputSource& ) -> BitInputSource& = default;
+
+        auto operator=( BitInputSource&& ) -> BitInputSource& = default;
+
+        virtual ~BitInputSource() = default;
+
+        /**
+         * @return the number of items produced by the source.
+         */
+        BIT7Z_NODISCARD
+        virtual auto itemsCount() const -> std::uint32_t = 0;
+
+        /**
+         * @brief Produces the item at the given index.
+         *
+         * @note The content of the item (e.g., the file) is opened only when it is actually compressed.
+         *
+         * @param index the index of the item to be produced, in the range [0, itemsCount() - 1].
+         *
+         * @return the item at the given index.
+         */
+        BIT7Z_NODISCARD
+        virtual auto item( std::uint32_t index ) const -> BitInputItem = 0;
+};
+
+} // namespace bit7z
+
+#endif //BITINPUTSOURCE_HPP
@@ -11,6 +11,7 @@
 #define BITITEMSVECTOR_HPP
 
 #include "bitabstractarchivehandler.hpp"
+#include "bitbufferview.hpp"
 #include "bitfs.hpp"
 #include "bitinputitem.hpp"
 #include "bittypes.hpp"
@@ -27,6 +28,7 @@ struct IndexingOptions {
     bool retainFolderStructure = false;
     bool onlyFiles = false;
     SymlinkPolicy symlinkPolicy = SymlinkPolicy::Follow;
+    bool lazyMetadata = false;
 };
 /** @endcond **/
 
@@ -134,11 +136,13 @@ void indexFile(
 /**
  * @brief Indexes the given buffer, using the given name as a path when compressed in archives.
  *
+ * @note The buffer is not copied: the viewed bytes must outlive the indexed item.
+ *
  * @param outVector the output vector.
  * @param inBuffer  the buffer containing the file to be indexed in the vector.
  * @param name      user-defined path to be used inside archives.
  */
-void indexBuffer( BitItemsVector& outVector, const buffer_t& inBuffer, const tstring& name );
+void indexBuffer( BitItemsVector& outVector, BitBufferView inBuffer, const tstring& name );
 
 /**
  * @brief Indexes the given standard input stream, using the given name as a path when compressed in archives.
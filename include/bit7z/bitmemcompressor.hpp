@@ -10,6 +10,7 @@
 #ifndef BITMEMCOMPRESSOR_HPP
 #define BITMEMCOMPRESSOR_HPP
 
+#include "bitbufferview.hpp"
 #include "bitcompressor.hpp"
 #include "bitdefines.hpp"
 #include "bittypes.hpp"
@@ -22,8 +23,11 @@ namespace bit7z {
  *
  * It let decide various properties of the produced archive, such as the password
  * protection and the compression level desired.
+ *
+ * The input data can be given either as buffer_t objects or as views of memory regions
+ * not owned by a buffer_t (e.g., memory-mapped files); in both cases, the data is not copied.
  */
-using BitMemCompressor BIT7Z_MAYBE_UNUSED = BitCompressor< const buffer_t& >;
+using BitMemCompressor BIT7Z_MAYBE_UNUSED = BitCompressor< BitBufferView >;
 
 } // namespace bit7z
 #endif // BITMEMCOMPRESSOR_HPP
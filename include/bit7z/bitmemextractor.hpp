@@ -10,6 +10,7 @@
 #ifndef BITMEMEXTRACTOR_HPP
 #define BITMEMEXTRACTOR_HPP
 
+#include "bitbufferview.hpp"
 #include "bitdefines.hpp"
 #include "bitextractor.hpp"
 #include "bittypes.hpp"
@@ -18,8 +19,11 @@ namespace bit7z {
 
 /**
  * @brief The BitMemExtractor alias allows extracting the content of in-memory archives.
+ *
+ * The input archives can be given either as buffer_t objects or as views of memory regions
+ * not owned by a buffer_t (e.g., memory-mapped files); in both cases, the archive is not copied.
  */
-using BitMemExtractor BIT7Z_MAYBE_UNUSED = BitExtractor< const buffer_t& >;
+using BitMemExtractor BIT7Z_MAYBE_UNUSED = BitExtractor< BitBufferView >;
 
 } // namespace bit7z
 
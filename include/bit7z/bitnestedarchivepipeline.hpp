@@ -0,0 +1,127 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITNESTEDARCHIVEPIPELINE_HPP
+#define BITNESTEDARCHIVEPIPELINE_HPP
+
+#include "bitarchivereader.hpp"
+#include "bitnestedarchivereader.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace bit7z {
+
+/**
+ * @brief The BitNestedArchivePipeline class allows reading archives nested at an arbitrary depth
+ *        (e.g., the tarball inside a .tar.gz archive, which is itself inside a .tar archive).
+ *
+ * Each nesting level is streamed sequentially into the next one, without extracting any intermediate
+ * archive to disk or fully into memory. The memory budget of the pipeline is split among its stages.
+ */
+class BitNestedArchivePipeline final {
+    public:
+        /**
+         * @brief Constructs a BitNestedArchivePipeline object, opening the outermost archive.
+         *
+         * @note The nested archives are not opened by the constructor, they will be opened only when needed.
+         *
+         * @param lib         the 7z library used.
+         * @param nestedPath  the path of the innermost archive, where each nesting level is separated by "!/"
+         *                    (e.g., "archive.tar!/folder/inner.tar.gz!/inner.tar").
+         * @param formats     the formats of the archives in the path, from the outermost to the innermost one.
+         * @param password    (optional) the password needed for opening the archives.
+         *
+         * @throws BitException if the path doesn't contain at least one nested archive, if the number of formats
+         *                      doesn't match the number of archives in the path, or if the first nested archive
+         *                      cannot be found in the outermost one.
+         */
+        BitNestedArchivePipeline(
+            const Bit7zLibrary& lib,
+            const tstring& nestedPath,
+            const std::vector< std::reference_wrapper< const BitInFormat > >& formats,
+            const tstring& password = {}
+        );
+
+        BitNestedArchivePipeline( const BitNestedArchivePipeline& ) = delete;
+
+        BitNestedArchivePipeline( BitNestedArchivePipeline&& ) = delete;
+
+        auto operator=( const BitNestedArchivePipeline& ) -> BitNestedArchivePipeline& = delete;
+
+        auto operator=( BitNestedArchivePipeline&& ) -> BitNestedArchivePipeline& = delete;
+
+        ~BitNestedArchivePipeline();
+
+        /**
+         * @return the reader of the innermost archive of the pipeline.
+         */
+        BIT7Z_NODISCARD
+        auto archive() noexcept -> BitNestedArchiveReader&;
+
+        /**
+         * @return the reader of the innermost archive of the pipeline.
+         */
+        BIT7Z_NODISCARD
+        auto archive() const noexcept -> const BitNestedArchiveReader&;
+
+        /**
+         * @return the number of nested archives streamed by the pipeline.
+         */
+        BIT7Z_NODISCARD
+        auto stagesCount() const noexcept -> std::size_t;
+
+        /**
+         * @return the max memory usage limit of the whole pipeline.
+         */
+        BIT7Z_NODISCARD
+        auto maxMemoryUsage() const noexcept -> std::uint64_t;
+
+        /**
+         * @brief Sets the max memory usage limit of the whole pipeline, which is split evenly among its stages.
+         *
+         * @note Each stage is always allowed to use at least the minimum amount of memory
+         *       required by BitNestedArchiveReader.
+         *
+         * @param value the max memory limit to be used (in bytes).
+         */
+        void setMaxMemoryUsage( std::uint64_t value ) noexcept;
+
+        /**
+         * @brief Enables the adaptive memory usage of all the stages of the pipeline.
+         *
+         * The given bounds refer to the whole pipeline, and they are split evenly among its stages.
+         *
+         * @param minValue the minimum memory limit of the pipeline (in bytes).
+         * @param maxValue the maximum memory limit of the pipeline (in bytes).
+         *
+         * @see BitNestedArchiveReader::setAdaptiveMemoryUsage
+         */
+        void setAdaptiveMemoryUsage( std::uint64_t minValue, std::uint64_t maxValue ) noexcept;
+
+        /**
+         * @brief Stops the extractions running in all the stages of the pipeline, if any.
+         *
+         * It can be called from another thread while reading the innermost archive: the running operation
+         * then fails with a BitException. The next operation on the pipeline reopens all its archives.
+         */
+        void cancel() noexcept;
+
+    private:
+        std::vector< tstring > mPathComponents;
+        BitArchiveReader mOuterArchive;
+        std::vector< std::unique_ptr< BitNestedArchiveReader > > mStages; // From the outermost to the innermost.
+        std::uint64_t mMaxMemoryUsage;
+};
+
+} // namespace bit7z
+
+#endif //BITNESTEDARCHIVEPIPELINE_HPP
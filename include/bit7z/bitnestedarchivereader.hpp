@@ -12,10 +12,18 @@
 
 #include "bitabstractarchiveopener.hpp"
 #include "bitarchiveiteminfo.hpp"
+#include "bitbufferingmetrics.hpp"
 #include "bitinputarchive.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+
 namespace bit7z {
 
+class CSynchronizedInStream;
+
 /**
  * @brief The BitNestedArchiveReader class allows reading and extracting nested archives
  *        (e.g., the tarball inside a .tar.gz archive).
@@ -30,11 +38,9 @@ class BitNestedArchiveReader final : public BitAbstractArchiveOpener {
          * @param lib           the 7z library used.
          * @param parentArchive the parent archive containing the nested archive.
          * @param index         the index of the nested archive within the parent archive.
-         * @param format        the format of the nested archive.
+         * @param format        the format of the nested archive (if BitFormat::Auto, the format is detected
+         *                      from the signature at the beginning of the nested archive when first opening it).
          * @param password      (optional) the password needed for opening the nested archive.
-         *
-         * @throws BitException if the format is BitFormat::Auto
-         *                      (automatic format detection of nested archives is not supported).
          */
         BitNestedArchiveReader(
             const Bit7zLibrary& lib,
@@ -51,11 +57,9 @@ class BitNestedArchiveReader final : public BitAbstractArchiveOpener {
          *
          * @param lib           the 7z library used.
          * @param parentArchive the parent archive containing the nested archive.
-         * @param format        the format of the nested archive.
+         * @param format        the format of the nested archive (if BitFormat::Auto, the format is detected
+         *                      from the signature at the beginning of the nested archive when first opening it).
          * @param password      (optional) the password needed for opening the nested archive.
-         *
-         * @throws BitException if the format is BitFormat::Auto
-         *                      (automatic format detection of nested archives is not supported).
          */
         BitNestedArchiveReader(
             const Bit7zLibrary& lib,
@@ -64,6 +68,16 @@ class BitNestedArchiveReader final : public BitAbstractArchiveOpener {
             const tstring& password = {}
         );
 
+        BitNestedArchiveReader( const BitNestedArchiveReader& ) = delete;
+
+        BitNestedArchiveReader( BitNestedArchiveReader&& ) = delete;
+
+        auto operator=( const BitNestedArchiveReader& ) -> BitNestedArchiveReader& = delete;
+
+        auto operator=( BitNestedArchiveReader&& ) -> BitNestedArchiveReader& = delete;
+
+        ~BitNestedArchiveReader() override;
+
         /**
          * @return the max memory usage limit applied while extracting the parent archive.
          */
@@ -71,7 +85,8 @@ class BitNestedArchiveReader final : public BitAbstractArchiveOpener {
         auto maxMemoryUsage() const noexcept -> std::uint64_t;
 
         /**
-         * @return the detected format of the file.
+         * @return the detected format of the file (BitFormat::Auto if the format must be detected,
+         *         but the nested archive wasn't opened yet).
          */
         BIT7Z_NODISCARD
         auto detectedFormat() const noexcept -> const BitInFormat&;
@@ -141,27 +156,77 @@ class BitNestedArchiveReader final : public BitAbstractArchiveOpener {
         /**
          * @brief Sets the max memory usage limit to be used while extracting the parent archive.
          *
+         * @note This disables the adaptive memory usage, if previously enabled.
+         *
          * @param value the max memory limit to be used (in bytes).
          */
         void setMaxMemoryUsage( std::uint64_t value ) noexcept;
 
+        /**
+         * @brief Enables the adaptive memory usage while extracting the parent archive.
+         *
+         * The memory limit starts from the current max memory usage (clamped within the given bounds),
+         * and it is then grown or shrunk depending on how long the extraction of the parent archive and
+         * the reading of the nested one wait for each other. The limit reached by an extraction is used
+         * as the starting limit of the next one.
+         *
+         * @param minValue the minimum memory limit to be used (in bytes).
+         * @param maxValue the maximum memory limit to be used (in bytes).
+         */
+        void setAdaptiveMemoryUsage( std::uint64_t minValue, std::uint64_t maxValue ) noexcept;
+
+        /**
+         * @return the buffering statistics of the last extraction of the parent archive.
+         */
+        BIT7Z_NODISCARD
+        auto bufferingMetrics() const -> BufferingMetrics;
+
     private:
-        BitInputArchive mNestedArchive;
+        mutable BitInputArchive mNestedArchive; // Mutable, as its format might be detected only when opening it.
         const BitInputArchive& mParentArchive;
+        const BitNestedArchiveReader* mParentReader; // Non-null only if the parent archive is a nested one too.
         std::uint32_t mIndexInParent;
-        std::uint64_t mMaxMemoryUsage;
+        tstring mPathInParent; // If not empty, the nested archive is found by path rather than by index.
+        mutable std::uint64_t mMaxMemoryUsage;
+        std::uint64_t mMinAdaptiveMemoryUsage; // Adaptive memory usage is enabled only if greater than zero.
+        std::uint64_t mMaxAdaptiveMemoryUsage;
 
         mutable std::uint32_t mCachedItemsCount;
         mutable std::uint32_t mLastReadItem; // TODO: Use std::optional< std::uint32_t > once we move to C++17
         mutable std::size_t mOpenCount;
+        mutable CSynchronizedInStream* mInStream; // Owned reference to the stream the nested archive is read from.
+        mutable std::mutex mStreamMutex; // Guards the replacement of mInStream, which can be cancelled by other threads.
+        mutable std::atomic_bool mCancelled; // If true, the stream was cancelled, and the archive must be reopened.
+
+        /* Constructs a reader of the nested archive having the given path inside the archive read by parentReader.
+         * Reopening this archive also reopens the parent one, i.e., the two readers form a streaming pipeline. */
+        BitNestedArchiveReader(
+            const Bit7zLibrary& lib,
+            const BitNestedArchiveReader& parentReader,
+            const tstring& pathInParent,
+            const BitInFormat& format,
+            const tstring& password
+        );
 
         void openSequentially() const;
 
+        void stopExtraction() const noexcept;
+
+        // Cancels the extraction of the parent archive (if running), without waiting for it to end.
+        void cancelExtraction() const noexcept;
+
+        BIT7Z_NODISCARD
+        auto extractionError() const noexcept -> std::exception_ptr;
+
+        void rethrowExtractionError() const;
+
         BIT7Z_NODISCARD
         auto needReopen( std::uint32_t index = 0 ) const -> bool;
 
         BIT7Z_NODISCARD
         auto calculateItemsCount() const -> std::uint32_t;
+
+        friend class BitNestedArchivePipeline;
 };
 
 } // namespace bit7z
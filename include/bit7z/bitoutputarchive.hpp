@@ -12,23 +12,31 @@
 
 #include "bitabstractarchivecreator.hpp"
 #include "bitabstractarchivehandler.hpp"
+#include "bitbufferview.hpp"
 #include "bitexception.hpp" //for FailedFiles
 #include "bitinputarchive.hpp"
+#include "bitinputsource.hpp"
 #include "bititemsvector.hpp"
 #include "bitpropvariant.hpp"
+#include "bitsegmentedbuffer.hpp"
 #include "bittypes.hpp"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <istream>
 #include <map>
 #include <memory>
 #include <ostream>
 #include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 //! @cond IGNORE_BLOCK_IN_DOXYGEN
 struct ISequentialInStream;
+struct ISequentialOutStream;
 
 template< typename T >
 class CMyComPtr;
@@ -57,8 +65,27 @@ using DeletedItems = std::set< std::uint32_t >;
  *         if i >= mInputArchiveItemsCount, the item is new (added by the user); */
 enum class InputIndex : std::uint32_t {}; // NOLINT(*-enum-size)
 
+class InputItemsStore;
 class UpdateCallback;
 
+/**
+ * @brief The reason why an input file was judged incompressible.
+ */
+enum struct IncompressibleReason : std::uint8_t {
+    Extension,  ///< The file has the extension of an already compressed file type (e.g., jpg, mp4, zip).
+    HighEntropy ///< The first block of the file looks like random data (e.g., compressed or encrypted data).
+};
+
+/**
+ * @brief An input file judged incompressible (see BitAbstractArchiveCreator::setStoreIncompressibleFiles).
+ */
+struct IncompressibleItem {
+    tstring path;                ///< The filesystem path of the file.
+    IncompressibleReason reason; ///< Why the file was judged incompressible.
+    bool stored;                 ///< Whether the file was stored without compression (see the note of
+                                 ///< BitAbstractArchiveCreator::setStoreIncompressibleFiles on when this happens).
+};
+
 /**
  * @brief The BitOutputArchive class, given a creator object, allows creating new archives.
  */
@@ -167,6 +194,26 @@ class BitOutputArchive {
          */
         void addItems( const std::map< tstring, tstring >& inPaths );
 
+        /**
+         * @brief Adds all the items produced by the given input source.
+         *
+         * The items are not stored by the output archive: they are requested to the source
+         * only when needed during the compression.
+         *
+         * @note The input source must outlive the compression of the output archive.
+         *
+         * @param inputSource the source producing the items to be added to the output archive.
+         */
+        void addItems( const BitInputSource& inputSource );
+
+        /**
+         * @brief Deleted overload preventing the addition of a temporary input source.
+         *
+         * The output archive only keeps a reference to the source, which is used later when compressing;
+         * a temporary would dangle, so passing one is rejected at compile time.
+         */
+        void addItems( BitInputSource&& inputSource ) = delete;
+
         /**
          * @brief Adds the given file path, with an optional user-defined path to be used in the output archive.
          *
@@ -197,10 +244,28 @@ class BitOutputArchive {
          */
         auto addFile( buffer_t&& inBuffer, const tstring& name ) -> BitInputItem& = delete;
 
+        /**
+         * @brief Adds the bytes referenced by the given view as a file, using the given name as a path when
+         *        compressed in the output archive.
+         *
+         * @note The bytes are not copied: they are read only when compressing, so they must outlive this object.
+         *
+         * @param inBuffer  the view of the bytes of the file to be added to the output archive.
+         * @param name      user-defined path to be used inside the output archive.
+         *
+         * @return a reference to the input item just added, valid until the next call that adds items to the archive.
+         */
+        auto addFile( BitBufferView inBuffer, const tstring& name ) -> BitInputItem&;
+
         /**
          * @brief Adds the given standard input stream, using the given name as a path when compressed
          *        in the output archive.
          *
+         * @note The stream can be non-seekable (e.g., a pipe or a socket): in this case, its size is not known
+         *       in advance (see BitInputItem::kUnknownSize), and it is compressed until its end is reached.
+         *       The formats storing the size of the items after their data (e.g., 7z, zip, and gzip)
+         *       will store the actual number of bytes read.
+         *
          * @param inStream  the input stream to be added.
          * @param name      the name of the file inside the output archive.
          *
@@ -299,10 +364,68 @@ class BitOutputArchive {
          */
         void compressTo( buffer_t& outBuffer );
 
+        /**
+         * @brief Compresses all the items added to this object to the specified segmented buffer.
+         *
+         * @note Unlike a buffer_t, the segmented buffer never needs to move the already written data
+         * when it grows, so it is better suited for big in-memory archives.
+         *
+         * @param outBuffer the output segmented buffer.
+         */
+        void compressTo( BitSegmentedBuffer& outBuffer );
+
+        /**
+         * @brief Compresses all the items added to this object to the specified pre-allocated buffer.
+         *
+         * @note If the buffer is too small, the compression is still completed (discarding the exceeding data),
+         * so that the thrown exception can report the buffer size actually needed.
+         *
+         * @param outBuffer the pre-allocated output buffer.
+         * @param size      the size (capacity) of the output buffer.
+         *
+         * @throws BitException with the BitError::InsufficientOutputBufferSize error code if the output archive
+         *         does not fit the buffer.
+         *
+         * @return the size of the output archive, i.e., the number of bytes written to the buffer.
+         */
+        auto compressTo( byte_t* outBuffer, std::size_t size ) -> std::size_t;
+
+        /**
+         * @brief Compresses all the items added to this object to the specified pre-allocated buffer.
+         *
+         * @tparam N        the size (capacity) of the output buffer.
+         * @param outBuffer the pre-allocated output buffer.
+         *
+         * @return the size of the output archive, i.e., the number of bytes written to the buffer.
+         */
+        template< std::size_t N >
+        auto compressTo( std::array< byte_t, N >& outBuffer ) -> std::size_t {
+            return compressTo( outBuffer.data(), outBuffer.size() );
+        }
+
+        /**
+         * @brief Compresses all the items added to this object to the specified pre-allocated buffer.
+         *
+         * @tparam N        the size (capacity) of the output buffer.
+         * @param outBuffer the pre-allocated output buffer.
+         *
+         * @return the size of the output archive, i.e., the number of bytes written to the buffer.
+         */
+        template< std::size_t N >
+        auto compressTo( byte_t (&outBuffer)[ N ] ) -> std::size_t { // NOLINT(*-avoid-c-arrays)
+            return compressTo( outBuffer, N );
+        }
+
         /**
          * @brief Compresses all the items added to this object to the specified buffer.
          *
+         * @note If the output stream is not seekable (or the archive creator requires a sequential output),
+         *       the archive is written sequentially, without ever seeking back in the stream
+         *       (see BitAbstractArchiveCreator::setSequentialOutput).
+         *
          * @param outStream the output standard stream.
+         *
+         * @throws BitException if the archive must be written sequentially, but the output format does not support it.
          */
         void compressTo( std::ostream& outStream );
 
@@ -311,6 +434,17 @@ class BitOutputArchive {
          */
         auto itemsCount() const -> std::uint32_t;
 
+        /**
+         * @brief Returns the input files that the last compression judged incompressible.
+         *
+         * @note The list is filled only if the creator's storeIncompressibleFiles() option is enabled.
+         *       The files are actually stored without compression only if all the new files are incompressible
+         *       (and the format allows it): the stored flag of the items tells whether this was the case.
+         *
+         * @return the incompressible input files found by the last compression.
+         */
+        auto incompressibleItems() const noexcept -> const std::vector< IncompressibleItem >&;
+
         /**
          * @return a constant reference to the BitAbstractArchiveHandler object containing the
          *         settings for writing the output archive.
@@ -345,13 +479,29 @@ class BitOutputArchive {
 
         auto indexInArchive( std::uint32_t index ) const noexcept -> std::uint32_t;
 
-        auto inputArchive() const -> BitInputArchive* {
-            return mInputArchive.get();
-        }
+        /**
+         * @return the input archive (if any), opening it if it was set via setDeferredInputArchive().
+         */
+        auto inputArchive() const -> BitInputArchive*;
 
-        void setInputArchive( std::unique_ptr< BitInputArchive >&& inputArchive ) {
-            mInputArchive = std::move( inputArchive );
-        }
+        /**
+         * @return the path of the input archive file (if any), without opening it.
+         */
+        auto inputArchivePath() const -> tstring;
+
+        /**
+         * @brief Replaces the input archive with the given one, discarding all the pending changes.
+         */
+        void setInputArchive( std::unique_ptr< BitInputArchive >&& inputArchive );
+
+        /**
+         * @brief Replaces the input archive with the given archive file, just written by this object,
+         * discarding all the pending changes.
+         *
+         * The archive file is opened only when first needed (e.g., by inputArchive()), while its items count
+         * is already known, as it is the number of items that this object has just written to it.
+         */
+        void setDeferredInputArchive( const tstring& archivePath );
 
         auto inputArchiveItemsCount() const -> std::uint32_t {
             return mInputArchiveItemsCount;
@@ -369,21 +519,41 @@ class BitOutputArchive {
             return !mDeletedItems.empty();
         }
 
-        auto hasNewItems() const -> bool {
-            return !mNewItems.empty();
-        }
+        auto hasNewItems() const -> bool;
+
+        /**
+         * @return whether some items of the input archive have been modified (e.g., renamed or updated).
+         */
+        virtual auto hasEditedItems() const noexcept -> bool;
 
         friend class UpdateCallback;
 
     private:
         const BitAbstractArchiveCreator& mArchiveCreator;
 
-        std::unique_ptr< BitInputArchive > mInputArchive;
+        // Note: the input archive is opened lazily after setDeferredInputArchive(), hence they are mutable.
+        mutable std::unique_ptr< BitInputArchive > mInputArchive;
+        mutable tstring mDeferredInputArchivePath;
         std::uint32_t mInputArchiveItemsCount;
 
+        // The new items are moved to the store as soon as possible: mNewItems holds at most the item just added
+        // by addFile, whose reference is given back to the user.
+        std::unique_ptr< InputItemsStore > mItemsStore;
         BitItemsVector mNewItems;
+        std::vector< std::reference_wrapper< const BitInputSource > > mInputSources;
         DeletedItems mDeletedItems;
 
+        // The new files judged incompressible, and whether all the new items were stored without compression.
+        std::vector< IncompressibleItem > mIncompressibleItems;
+        bool mStoreNewItems{ false };
+
+        // The new items having the same content of a previous new item (InputIndex -> InputIndex of the first copy).
+        std::unordered_map< std::uint32_t, std::uint32_t > mDuplicateItems;
+
+        // The last item produced by the input sources, as 7-Zip usually requests each item several times in a row.
+        mutable std::unique_ptr< BitInputItem > mSourceItem;
+        mutable std::size_t mSourceItemIndex{ 0 };
+
         mutable FailedFiles mFailedFiles;
 
         /* mInputIndices:
@@ -393,15 +563,20 @@ class BitOutputArchive {
          * If there are some deleted items, then 'i' is not equal to mInputIndices[i]
          * (at least for values of i greater than the index of the first deleted item).
          *
-         * Otherwise, if there are no deleted items, the vector is empty, and itemInputIndex(i)
+         * The same happens if the new items are reordered (see BitAbstractArchiveCreator::setSortStrategy
+         * and BitAbstractArchiveCreator::setDeduplicateFiles).
+         *
+         * Otherwise, if there are no deleted or reordered items, the vector is empty, and itemInputIndex(i)
          * will return InputIndex with value i.
          *
          * This vector is either empty, or it has size equal to itemsCount() (thanks to updateInputIndices()). */
         std::vector< InputIndex > mInputIndices;
 
-        auto initOutArchive() const -> CMyComPtr< IOutArchive >;
+        auto initOutArchive() -> CMyComPtr< IOutArchive >;
+
+        auto hasInputArchive() const noexcept -> bool;
 
-        auto initOutFileStream( const bit7zfs::path& outArchive ) const -> CMyComPtr< IOutStream >;
+        void discardChanges();
 
         BitOutputArchive(
             const BitAbstractArchiveCreator& creator,
@@ -411,11 +586,48 @@ class BitOutputArchive {
 
         void compressToFile( const bit7zfs::path& outFile, UpdateCallback* updateCallback );
 
-        void compressOut( IOutArchive* outArc, IOutStream* outStream, UpdateCallback* updateCallback );
+        auto appendInPlace( const bit7zfs::path& outFile, UpdateCallback* updateCallback ) -> bool;
+
+        auto fitsInZipArchive( std::uint64_t appendOffset ) const -> bool;
+
+        void compressOut( IOutArchive* outArc, ISequentialOutStream* outStream, UpdateCallback* updateCallback );
+
+        void markUpdatedItems( IOutArchive* outArc );
+
+        void updateItems( IOutArchive* outArc, ISequentialOutStream* outStream, UpdateCallback* updateCallback );
 
         void setArchiveProperties( IOutArchive* outArchive ) const;
 
         void updateInputIndices();
+
+        void sortNewItems();
+
+        auto isUnchangedItem( std::uint32_t oldItemIndex, std::uint32_t newItemIndex, std::uint64_t timePrecision ) const
+            -> bool;
+
+        void probeCompressibility();
+
+        void findDuplicateItems();
+
+        void groupDuplicateItems();
+
+        auto linksDuplicateItems() const -> bool;
+
+        auto duplicatedItem( InputIndex index ) const -> const std::uint32_t*;
+
+        auto newItemFilePath( std::size_t newItemIndex ) const -> native_string;
+
+        void storeNewItems();
+
+        auto storedItemsCount() const noexcept -> std::size_t;
+
+        auto newItemsCount() const -> std::size_t;
+
+        auto sourcesItemsCount() const -> std::uint32_t;
+
+        auto newItem( std::size_t newItemIndex ) const -> const BitInputItem&;
+
+        void resetSourceItem() noexcept;
 };
 
 } // namespace bit7z
@@ -0,0 +1,126 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITSEGMENTEDBUFFER_HPP
+#define BITSEGMENTEDBUFFER_HPP
+
+#include "bitdefines.hpp"
+#include "bittypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bit7z {
+
+/**
+ * @brief A read-only view of a contiguous segment of a BitSegmentedBuffer.
+ *
+ * @note The members have the same meaning as the ones of POSIX's iovec and Windows' WSABUF structs,
+ * so a list of segments can be easily converted for a scatter-gather I/O call (e.g., writev).
+ */
+struct BitBufferSegment {
+    const byte_t* data;  ///< A pointer to the first byte of the segment.
+    std::size_t size;    ///< The number of bytes in the segment.
+};
+
+/**
+ * @brief A byte buffer made of a list of fixed-size segments, each allocated separately.
+ *
+ * Unlike a buffer_t, growing a BitSegmentedBuffer never moves the already written data:
+ * new segments are just appended to the list.
+ * Hence, it can hold big in-memory archives without needing a single contiguous memory block,
+ * and without the temporary double memory usage due to the reallocations of a std::vector.
+ */
+class BitSegmentedBuffer final {
+    public:
+        /**
+         * @brief Constructs an empty BitSegmentedBuffer.
+         *
+         * @param segmentSize the size (in bytes) of the segments of the buffer (default: 1 MiB).
+         *
+         * @throws BitException if the segment size is zero.
+         */
+        explicit BitSegmentedBuffer( std::size_t segmentSize = 1024 * 1024 );
+
+        /**
+         * @return the size (in bytes) of the segments of the buffer.
+         */
+        BIT7Z_NODISCARD auto segmentSize() const noexcept -> std::size_t;
+
+        /**
+         * @return the number of bytes stored in the buffer.
+         */
+        BIT7Z_NODISCARD auto size() const noexcept -> std::uint64_t;
+
+        /**
+         * @return true if and only if the buffer does not contain any byte.
+         */
+        BIT7Z_NODISCARD auto empty() const noexcept -> bool;
+
+        /**
+         * @brief Removes all the bytes from the buffer, releasing its segments.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Resizes the buffer to contain the given number of bytes.
+         *
+         * If the buffer grows, the new bytes are zero-initialized.
+         *
+         * @param newSize the new size (in bytes) of the buffer.
+         */
+        void resize( std::uint64_t newSize );
+
+        /**
+         * @brief Writes the given data at the given offset of the buffer, growing the buffer if needed.
+         *
+         * @note If the offset is greater than the current size, the gap is filled with zeros.
+         *
+         * @param offset the offset (in bytes) where to write the data.
+         * @param data   the data to be written.
+         * @param size   the number of bytes to be written.
+         */
+        void write( std::uint64_t offset, const byte_t* data, std::size_t size );
+
+        /**
+         * @brief Reads the bytes of the buffer starting from the given offset.
+         *
+         * @param offset the offset (in bytes) of the first byte to be read.
+         * @param data   the output memory where to copy the read bytes.
+         * @param size   the maximum number of bytes to be read.
+         *
+         * @return the number of bytes actually read (less than size if the end of the buffer was reached).
+         */
+        auto read( std::uint64_t offset, byte_t* data, std::size_t size ) const -> std::size_t;
+
+        /**
+         * @brief Returns a scatter-gather view of the content of the buffer.
+         *
+         * @note The returned segments are valid until the buffer is modified or destroyed.
+         *
+         * @return the list of the segments of the buffer, in order; only the last one can be smaller
+         *         than the segment size.
+         */
+        BIT7Z_NODISCARD auto segments() const -> std::vector< BitBufferSegment >;
+
+        /**
+         * @return a contiguous copy of the content of the buffer.
+         */
+        BIT7Z_NODISCARD auto toBuffer() const -> buffer_t;
+
+    private:
+        std::size_t mSegmentSize;
+        std::vector< buffer_t > mSegments;
+        std::uint64_t mSize;
+};
+
+} // namespace bit7z
+
+#endif //BITSEGMENTEDBUFFER_HPP
@@ -0,0 +1,59 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef BITVOLUMEHANDLES_HPP
+#define BITVOLUMEHANDLES_HPP
+
+#include "bitdefines.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bit7z {
+
+/**
+ * @brief The counters of the file handles opened for the volumes of multi-volume archives.
+ *
+ * All the multi-volume archives read or written by the process share a single budget of open handles:
+ * when the budget is exhausted, the least recently used volume among all the archives is closed
+ * (and reopened later, if needed).
+ *
+ * @note On Windows, there is no open-handles limit to work around, so all the counters are always zero.
+ */
+struct VolumeHandlesStats {
+    std::size_t openHandles;    ///< The number of volume handles currently open.
+    std::size_t maxOpenHandles; ///< The maximum number of volume handles that can be open at the same time.
+    std::uint64_t opens;        ///< The total number of volume handles opened (reopenings included).
+    std::uint64_t evictions;    ///< The total number of volume handles closed to stay within the budget.
+};
+
+/**
+ * @return the current counters of the file handles opened for the volumes of multi-volume archives.
+ */
+BIT7Z_NODISCARD auto volumeHandlesStats() -> VolumeHandlesStats;
+
+/**
+ * @brief Sets the maximum number of volume handles that all the multi-volume archives of the process
+ * can keep open at the same time.
+ *
+ * By default, the budget is half of the maximum number of files the process can open
+ * (after reserving a few handles for other needs of the process), and at least 3 handles.
+ *
+ * @note The limit is a soft one: if all the volumes that could be closed are being used by other threads,
+ *       the budget is temporarily exceeded rather than failing the operation.
+ *       Moreover, each multi-volume archive being read might open the volume following the one being read
+ *       in advance, and such a handle is accounted only when the reading reaches its volume.
+ *
+ * @param maxHandles the maximum number of open volume handles (0 restores the default budget).
+ */
+void setMaxVolumeHandles( std::size_t maxHandles );
+
+} // namespace bit7z
+
+#endif //BITVOLUMEHANDLES_HPP
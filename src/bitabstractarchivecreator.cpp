@@ -145,7 +145,13 @@ BitAbstractArchiveCreator::BitAbstractArchiveCreator(
     mVolumeSize( 0 ),
     mThreadsCount( 0 ),
     mStoreSymbolicLinks{ false },
-    mStoreOpenFiles{ false } {
+    mStoreOpenFiles{ false },
+    mLazyFileMetadata{ false },
+    mDeduplicateFiles{ false },
+    mSortStrategy{ SortStrategy::None },
+    mStoreIncompressibleFiles{ false },
+    mWriteBufferSize{ 0 },
+    mSequentialOutput{ false } {
     setRetainDirectories( false );
 }
 
@@ -216,6 +222,30 @@ auto BitAbstractArchiveCreator::storeOpenFiles() const noexcept -> bool {
     return mStoreOpenFiles;
 }
 
+auto BitAbstractArchiveCreator::lazyFileMetadata() const noexcept -> bool {
+    return mLazyFileMetadata;
+}
+
+auto BitAbstractArchiveCreator::deduplicateFiles() const noexcept -> bool {
+    return mDeduplicateFiles;
+}
+
+auto BitAbstractArchiveCreator::sortStrategy() const noexcept -> SortStrategy {
+    return mSortStrategy;
+}
+
+auto BitAbstractArchiveCreator::storeIncompressibleFiles() const noexcept -> bool {
+    return mStoreIncompressibleFiles;
+}
+
+auto BitAbstractArchiveCreator::writeBufferSize() const noexcept -> std::uint32_t {
+    return mWriteBufferSize;
+}
+
+auto BitAbstractArchiveCreator::sequentialOutput() const noexcept -> bool {
+    return mSequentialOutput;
+}
+
 void BitAbstractArchiveCreator::setPassword( const tstring& password ) {
     setPassword( password, mCryptHeaders ? EncryptionScope::DataAndHeaders : EncryptionScope::DataOnly );
 }
@@ -340,6 +370,30 @@ void BitAbstractArchiveCreator::setStoreOpenFiles( bool storeOpenFiles ) noexcep
     mStoreOpenFiles = storeOpenFiles;
 }
 
+void BitAbstractArchiveCreator::setLazyFileMetadata( bool lazyFileMetadata ) noexcept {
+    mLazyFileMetadata = lazyFileMetadata;
+}
+
+void BitAbstractArchiveCreator::setDeduplicateFiles( bool deduplicateFiles ) noexcept {
+    mDeduplicateFiles = deduplicateFiles;
+}
+
+void BitAbstractArchiveCreator::setSortStrategy( SortStrategy strategy ) noexcept {
+    mSortStrategy = strategy;
+}
+
+void BitAbstractArchiveCreator::setStoreIncompressibleFiles( bool storeIncompressibleFiles ) noexcept {
+    mStoreIncompressibleFiles = storeIncompressibleFiles;
+}
+
+void BitAbstractArchiveCreator::setWriteBufferSize( std::uint32_t size ) noexcept {
+    mWriteBufferSize = size;
+}
+
+void BitAbstractArchiveCreator::setSequentialOutput( bool sequentialOutput ) noexcept {
+    mSequentialOutput = sequentialOutput;
+}
+
 namespace {
 auto dictionaryPropertyName( const BitInOutFormat& format, BitCompressionMethod method ) -> const wchar_t* {
     if ( format == BitFormat::SevenZip ) {
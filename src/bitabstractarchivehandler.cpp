@@ -26,7 +26,9 @@ BitAbstractArchiveHandler::BitAbstractArchiveHandler(
 ) : mLibrary{ lib },
     mPassword{ std::move( password ) },
     mRetainDirectories{ true },
-    mOverwriteMode{ overwriteMode } {}
+    mOverwriteMode{ overwriteMode },
+    mReadBufferSize{ 0 },
+    mUseMemoryMapping{ false } {}
 
 auto BitAbstractArchiveHandler::library() const noexcept -> const Bit7zLibrary& {
     return mLibrary;
@@ -68,6 +70,14 @@ auto BitAbstractArchiveHandler::overwriteMode() const noexcept -> OverwriteMode
     return mOverwriteMode;
 }
 
+auto BitAbstractArchiveHandler::readBufferSize() const noexcept -> std::uint32_t {
+    return mReadBufferSize;
+}
+
+auto BitAbstractArchiveHandler::useMemoryMapping() const noexcept -> bool {
+    return mUseMemoryMapping;
+}
+
 void BitAbstractArchiveHandler::setPassword( const tstring& password ) {
     mPassword = password;
 }
@@ -104,4 +114,12 @@ void BitAbstractArchiveHandler::setOverwriteMode( OverwriteMode mode ) {
     mOverwriteMode = mode;
 }
 
+void BitAbstractArchiveHandler::setReadBufferSize( std::uint32_t size ) noexcept {
+    mReadBufferSize = size;
+}
+
+void BitAbstractArchiveHandler::setUseMemoryMapping( bool useMapping ) noexcept {
+    mUseMemoryMapping = useMapping;
+}
+
 } // namespace bit7z
@@ -219,15 +219,19 @@ void BitArchiveEditor::setUpdateMode( UpdateMode mode ) {
     BitAbstractArchiveCreator::setUpdateMode( mode );
 }
 
-void BitArchiveEditor::applyChanges() {
+void BitArchiveEditor::applyChanges( ReopenPolicy policy ) {
     if ( !hasNewItems() && mEditedItems.empty() && !hasDeletedIndexes() ) {
         // Nothing to do here.
         return;
     }
-    const auto& archivePath = inputArchive()->archivePath();
+    const auto archivePath = inputArchivePath();
     compressTo( archivePath );
     mEditedItems.clear();
-    setInputArchive( std::make_unique< BitInputArchive >( *this, archivePath, ArchiveStartOffset::FileStart ) );
+    if ( policy == ReopenPolicy::Deferred ) {
+        setDeferredInputArchive( archivePath );
+    } else {
+        setInputArchive( std::make_unique< BitInputArchive >( *this, archivePath, ArchiveStartOffset::FileStart ) );
+    }
 }
 
 auto BitArchiveEditor::findItem( const tstring& itemPath ) const -> std::uint32_t {
@@ -290,7 +294,7 @@ auto BitArchiveEditor::itemStream( InputIndex index, ISequentialInStream** inStr
     }
 
     // The user wants to update the old item in the archive.
-    return res->second.getStream( inStream, creator().storeOpenFiles() );
+    return res->second.getStream( inStream, creator().storeOpenFiles(), creator().readBufferSize() );
 }
 
 auto BitArchiveEditor::hasNewData( std::uint32_t index ) const noexcept -> bool {
@@ -313,4 +317,8 @@ auto BitArchiveEditor::hasNewProperties( std::uint32_t index ) const noexcept ->
     return mappedIndex >= inputArchiveItemsCount() || isEditedItem;
 }
 
+auto BitArchiveEditor::hasEditedItems() const noexcept -> bool {
+    return !mEditedItems.empty();
+}
+
 } // namespace bit7z
@@ -64,6 +64,21 @@ BitArchiveReader::BitArchiveReader(
     const tstring& password
 ) : BitAbstractArchiveOpener( lib, format, password ), BitInputArchive( *this, inArchive ) {}
 
+BitArchiveReader::BitArchiveReader(
+    const Bit7zLibrary& lib,
+    BitBufferView inArchive,
+    ArchiveStartOffset archiveStart,
+    const BitInFormat& format,
+    const tstring& password
+) : BitAbstractArchiveOpener( lib, format, password ), BitInputArchive( *this, inArchive, archiveStart ) {}
+
+BitArchiveReader::BitArchiveReader(
+    const Bit7zLibrary& lib,
+    BitBufferView inArchive,
+    const BitInFormat& format,
+    const tstring& password
+) : BitAbstractArchiveOpener( lib, format, password ), BitInputArchive( *this, inArchive ) {}
+
 BitArchiveReader::BitArchiveReader(
     const Bit7zLibrary& lib,
     std::istream& inArchive,
@@ -26,13 +26,14 @@ const BitInOutFormat Zip(
     BIT7Z_STRING( ".zip" ),
     BitCompressionMethod::Deflate,
     FormatFeatures::MultipleFiles | FormatFeatures::CompressionLevel |
-    FormatFeatures::Encryption | FormatFeatures::MultipleMethods
+    FormatFeatures::Encryption | FormatFeatures::MultipleMethods |
+    FormatFeatures::SequentialOutput
 );
 const BitInOutFormat BZip2(
     0x02,
     BIT7Z_STRING( ".bz2" ),
     BitCompressionMethod::BZip2,
-    FormatFeatures::CompressionLevel
+    FormatFeatures::CompressionLevel | FormatFeatures::SequentialOutput
 );
 const BitInFormat Rar( 0x03 );
 const BitInFormat Arj( 0x04 ); //-V112
@@ -55,7 +56,7 @@ const BitInOutFormat Xz(
     BIT7Z_STRING( ".xz" ),
     // NOLINT(*-identifier-length)
     BitCompressionMethod::Lzma2,
-    FormatFeatures::CompressionLevel
+    FormatFeatures::CompressionLevel | FormatFeatures::SequentialOutput
 );
 const BitInFormat Ppmd( 0x0D );
 const BitInFormat Zstd( 0x0E );
@@ -113,13 +114,13 @@ const BitInOutFormat Tar(
     0xEE,
     BIT7Z_STRING( ".tar" ),
     BitCompressionMethod::Copy,
-    FormatFeatures::MultipleFiles
+    FormatFeatures::MultipleFiles | FormatFeatures::SequentialOutput
 );
 const BitInOutFormat GZip(
     0xEF,
     BIT7Z_STRING( ".gz" ),
     BitCompressionMethod::Deflate,
-    FormatFeatures::CompressionLevel
+    FormatFeatures::CompressionLevel | FormatFeatures::SequentialOutput
 );
 } // namespace BitFormat
 
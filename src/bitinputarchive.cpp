@@ -20,13 +20,14 @@
 #include "bitformat.hpp"
 #include "internal/bufferextractcallback.hpp"
 #include "internal/cbufferinstream.hpp"
-#include "internal/cfileinstream.hpp"
+#include "internal/cmappedfileinstream.hpp"
 #include "internal/cmultivolumeinstream.hpp"
 #include "internal/cstdinstream.hpp"
 #include "internal/extractcallback.hpp"
 #include "internal/fileextractcallback.hpp"
 #include "internal/fixedbufferextractcallback.hpp"
 #include "internal/fsutil.hpp"
+#include "internal/inplaceappender.hpp"
 #include "internal/opencallback.hpp"
 #include "internal/openerror.hpp"
 #include "internal/operationresult.hpp"
@@ -270,11 +271,16 @@ BitInputArchive::BitInputArchive(
 ) : mDetectedFormat{ detectFormat( handler.format(), arcPath ) },
     mArchiveHandler{ handler },
     mArchivePath{ pathToTstring( arcPath ) } {
+    // Restoring the archive if a previous in-place append was interrupted (unless an append is still in progress).
+    InPlaceAppender::tryRecover( arcPath );
+
+    const auto useMemoryMapping = handler.useMemoryMapping();
+    const auto readBufferSize = handler.readBufferSize();
     CMyComPtr< IInStream > fileStream;
     if ( *mDetectedFormat != BitFormat::Split && arcPath.extension() == ".001" ) {
-        fileStream = bit7z::make_com< CMultiVolumeInStream, IInStream >( arcPath );
+        fileStream = bit7z::make_com< CMultiVolumeInStream, IInStream >( arcPath, useMemoryMapping, readBufferSize );
     } else {
-        fileStream = bit7z::make_com< CFileInStream, IInStream >( arcPath.native() );
+        fileStream = makeFileInStream( arcPath, useMemoryMapping, readBufferSize );
     }
     mInArchive = openArchiveStream( arcPath, fileStream, startOffset );
 }
@@ -283,6 +289,12 @@ BitInputArchive::BitInputArchive(
     const BitAbstractArchiveHandler& handler,
     const buffer_t& inBuffer,
     ArchiveStartOffset startOffset
+) : BitInputArchive{ handler, BitBufferView{ inBuffer }, startOffset } {}
+
+BitInputArchive::BitInputArchive(
+    const BitAbstractArchiveHandler& handler,
+    BitBufferView inBuffer,
+    ArchiveStartOffset startOffset
 ) : mDetectedFormat{ &handler.format() }, // if auto, detect the format from content, otherwise try the passed format.
     mArchiveHandler{ handler } {
     const auto bufStream = bit7z::make_com< CBufferInStream, IInStream >( inBuffer );
@@ -299,12 +311,30 @@ BitInputArchive::BitInputArchive(
     mInArchive = openArchiveStream( fs::path{}, stdStream, startOffset );
 }
 
-BitInputArchive::BitInputArchive( const BitAbstractArchiveHandler& handler, const BitArchiveItemOffset& nestedItem )
-    : mDetectedFormat{ &handler.format() },
-      mArchiveHandler{ handler },
-      mArchivePath{ nestedItem.path() } {
-    CMyComPtr< IInArchive > arc = mArchiveHandler.library().initInArchive( mArchiveHandler.format() );
+BitInputArchive::BitInputArchive(
+    const BitAbstractArchiveHandler& handler,
+    const tstring& nestedArchivePath,
+    const BitInFormat& format
+) : mInArchive{ nullptr },
+    mDetectedFormat{ &format },
+    mArchiveHandler{ handler },
+    mArchivePath{ nestedArchivePath } {
+#ifdef BIT7Z_AUTO_FORMAT
+    if ( format == BitFormat::Auto ) {
+        return; // The format will be detected from the content of the nested archive when opening it.
+    }
+#endif
+    CMyComPtr< IInArchive > arc = mArchiveHandler.library().initInArchive( format );
+    mInArchive = arc.Detach();
+}
+
+void BitInputArchive::setNestedArchiveFormat( const BitInFormat& format ) {
+    CMyComPtr< IInArchive > arc = mArchiveHandler.library().initInArchive( format );
+    if ( mInArchive != nullptr ) {
+        mInArchive->Release();
+    }
     mInArchive = arc.Detach();
+    mDetectedFormat = &format;
 }
 
 BitInputArchive::BitInputArchive(
@@ -1079,6 +1109,15 @@ void BitInputArchive::extractSequentially( BufferQueue& queue, std::uint32_t ind
     extractArchive( extractCallback, NAskMode::kExtract, index );
 }
 
+void BitInputArchive::extractSequentially( BufferQueue& queue, FilterCallback filterCallback ) const {
+    const auto extractCallback = bit7z::make_com< SequentialExtractCallback, ExtractCallback >(
+        *this,
+        queue,
+        std::move( filterCallback )
+    );
+    extractArchive( extractCallback, NAskMode::kExtract );
+}
+
 void BitInputArchive::extractArchive( ExtractCallback* callback, std::int32_t mode, BitIndicesView indices ) const {
     const auto numItems = indices.empty() ? std::numeric_limits< std::uint32_t >::max() : indices.size();
     const HRESULT res = mInArchive->Extract( indices.data(), numItems, mode, callback );
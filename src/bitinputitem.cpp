@@ -14,10 +14,10 @@
 
 #include "bitexception.hpp"
 #include "internal/cbufferinstream.hpp"
-#include "internal/cfileinstream.hpp"
-#include "internal/csymlinkinstream.hpp"
+#include "internal/cstdinstream.hpp"
 #include "internal/dateutil.hpp"
 #include "internal/fsutil.hpp"
+#include "internal/inputitemutil.hpp"
 #include "internal/stringutil.hpp"
 #include "internal/util.hpp"
 
@@ -53,11 +53,24 @@ auto fileSize(
 BIT7Z_NODISCARD
 BIT7Z_ALWAYS_INLINE
 auto streamSize( std::istream& stream ) -> std::uint64_t {
+    // Note: non-seekable streams (e.g., pipes and sockets) have no position, so their size is unknown
+    // until they are read; in this case, we leave the stream as it is, and compress it until its end.
+    const std::istream::pos_type kInvalidPos{ -1 };
     const auto originalPos = stream.tellg();
+    if ( originalPos == kInvalidPos ) {
+        return BitInputItem::kUnknownSize;
+    }
+
     stream.seekg( 0, std::ios::end ); // seeking to the end of the stream
-    const auto result = static_cast< std::uint64_t >( stream.tellg() - originalPos ); // size of the stream
+    const auto endPos = stream.tellg();
+    if ( endPos == kInvalidPos ) {
+        stream.clear();
+        stream.seekg( originalPos );
+        return BitInputItem::kUnknownSize;
+    }
+
     stream.seekg( originalPos ); // seeking back to the original position in the stream
-    return result;
+    return static_cast< std::uint64_t >( endPos - originalPos ); // size of the stream
 }
 
 BIT7Z_NODISCARD
@@ -67,9 +80,6 @@ auto getFileTime( const BitInputArchive& inputArchive, std::uint32_t index, BitP
     return creationTime.isFileTime() ? creationTime.getFileTime() : currentFileTime();
 }
 
-#define HAS_FLAG( attributes, x ) \
-    ( ( ( attributes ) & static_cast< decltype( attributes ) >( x ) ) == static_cast< decltype( attributes ) >( x ) )
-
 auto fileType( const FileMetadata& fileMetadata ) noexcept -> fs::file_type {
 #ifdef _WIN32
     if ( HAS_FLAG( fileMetadata.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY ) ) {
@@ -102,7 +112,8 @@ auto fileProperties( const fs::path& itemPath, SymlinkPolicy policy ) -> InputIt
         fileMetadata.ftLastAccessTime,
         fileMetadata.ftCreationTime,
         static_cast< std::uint32_t >( fileMetadata.dwFileAttributes ),
-        InputItemType::Filesystem
+        InputItemType::Filesystem,
+        false
     };
 #else
     std::uint32_t fileAttributes = type == fs::file_type::directory ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_ARCHIVE;
@@ -121,14 +132,29 @@ auto fileProperties( const fs::path& itemPath, SymlinkPolicy policy ) -> InputIt
         toFILETIME( fileMetadata.st_atime ),
         toFILETIME( fileMetadata.st_ctime ),
         fileAttributes,
-        InputItemType::Filesystem
+        InputItemType::Filesystem,
+        false
     };
 #endif
 }
 
+// Note: we use the file type cached by the directory entry, so usually no stat call is needed.
+BIT7Z_NODISCARD
+auto lazyFileProperties( const fs::directory_entry& entry, SymlinkPolicy policy ) -> InputItemProperties {
+    std::error_code error;
+    const bool isSymlink = policy == SymlinkPolicy::DoNotFollow && entry.is_symlink( error );
+    const bool isDirectory = !isSymlink && entry.is_directory( error );
+
+    std::uint32_t fileAttributes = isDirectory ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_ARCHIVE;
+    if ( isSymlink ) {
+        fileAttributes |= FILE_ATTRIBUTE_REPARSE_POINT;
+    }
+    return { 0, {}, {}, {}, fileAttributes, InputItemType::Filesystem, true };
+}
+
 BIT7Z_NODISCARD
 BIT7Z_ALWAYS_INLINE
-auto bufferProperties( const buffer_t& buffer ) -> InputItemProperties {
+auto bufferProperties( BitBufferView buffer ) -> InputItemProperties {
     const auto currentTime = currentFileTime();
     return {
         sizeof( byte_t ) * static_cast< std::uint64_t >( buffer.size() ),
@@ -136,7 +162,8 @@ auto bufferProperties( const buffer_t& buffer ) -> InputItemProperties {
         currentTime,
         currentTime,
         static_cast< std::uint32_t >( FILE_ATTRIBUTE_NORMAL ),
-        InputItemType::Buffer
+        InputItemType::Buffer,
+        false
     };
 }
 
@@ -150,7 +177,8 @@ auto streamProperties( std::istream& stream ) -> InputItemProperties {
         currentTime,
         currentTime,
         static_cast< std::uint32_t >( FILE_ATTRIBUTE_NORMAL ),
-        InputItemType::StdStream
+        InputItemType::StdStream,
+        false
     };
 }
 
@@ -163,13 +191,16 @@ auto renamedItemProperties( const BitInputArchive& inputArchive, std::uint32_t i
         getFileTime( inputArchive, index, BitProperty::ATime ),
         getFileTime( inputArchive, index, BitProperty::CTime ),
         inputArchive.itemProperty( index, BitProperty::Attrib ).getUInt32(),
-        InputItemType::RenamedItem
+        InputItemType::RenamedItem,
+        false
     };
 }
 } // namespace
 
 namespace fsutil = filesystem::fsutil;
 
+constexpr std::uint64_t BitInputItem::kUnknownSize;
+
 BitInputItem::BitInputItem( const fs::path& itemPath, SymlinkPolicy symlinkPolicy )
     : BitInputItem{ itemPath, fs::path{}, symlinkPolicy } {}
 
@@ -179,13 +210,20 @@ BitInputItem::BitInputItem( const fs::path& itemPath, const fs::path& inArchiveP
       mInArchivePath{ pathToSevenzipString( !inArchivePath.empty() ? inArchivePath : fsutil::inArchivePath( itemPath ) ) },
       mFilesystemItem{ symlinkPolicy } {}
 
-BitInputItem::BitInputItem( const fs::path& searchPath, const fs::directory_entry& entry, SymlinkPolicy symlinkPolicy )
-    : mProperties{ fileProperties( entry.path(), symlinkPolicy ) },
+BitInputItem::BitInputItem(
+    const fs::path& searchPath,
+    const fs::directory_entry& entry,
+    SymlinkPolicy symlinkPolicy,
+    bool lazyMetadata
+) : mProperties{ lazyMetadata ? lazyFileProperties( entry, symlinkPolicy ) : fileProperties( entry.path(), symlinkPolicy ) },
       mPath{ entry.path().native() },
       mInArchivePath{ pathToSevenzipString( fsutil::inArchivePath( entry.path(), searchPath ) ) },
       mFilesystemItem{ symlinkPolicy } {}
 
 BitInputItem::BitInputItem( const buffer_t& buffer, const tstring& path )
+    : BitInputItem{ BitBufferView{ buffer }, path } {}
+
+BitInputItem::BitInputItem( BitBufferView buffer, const tstring& path )
     : mProperties{ bufferProperties( buffer ) },
       mPath{ NATIVE( path ) },
       mInArchivePath{ WIDEN( path ) },
@@ -204,14 +242,19 @@ BitInputItem::BitInputItem( const BitInputArchive& inputArchive, std::uint32_t i
       mRenamedItem{ RenamedInputItemInitTag{} } {}
 
 auto BitInputItem::isDir() const noexcept -> bool {
-    return HAS_FLAG( mProperties.attributes, FILE_ATTRIBUTE_DIRECTORY );
+    return isDirectoryItem( mProperties.attributes );
 }
 
 auto BitInputItem::isSymLink() const noexcept -> bool {
-    return HAS_FLAG( mProperties.attributes, FILE_ATTRIBUTE_REPARSE_POINT );
+    return isSymlinkItem( mProperties.attributes );
+}
+
+auto BitInputItem::hasKnownSize() const noexcept -> bool {
+    return size() != kUnknownSize;
 }
 
 auto BitInputItem::size() const noexcept -> std::uint64_t {
+    tryLoadMetadata();
     return mProperties.size;
 }
 
@@ -220,6 +263,7 @@ auto BitInputItem::path() const -> const native_string& {
 }
 
 auto BitInputItem::attributes() const noexcept -> std::uint32_t {
+    tryLoadMetadata();
     return mProperties.attributes;
 }
 
@@ -228,36 +272,22 @@ auto BitInputItem::inArchivePath() const -> const sevenzip_string& {
 }
 
 auto BitInputItem::itemProperty( BitProperty property ) const -> BitPropVariant {
-    BitPropVariant prop;
-    switch ( property ) {
-        case BitProperty::Path:
-            prop = mInArchivePath;
-            break;
-        case BitProperty::IsDir:
-            prop = isDir();
-            break;
-        case BitProperty::Size:
-            prop = mProperties.size;
-            break;
-        case BitProperty::Attrib:
-            prop = mProperties.attributes;
-            break;
-        case BitProperty::CTime:
-            prop = mProperties.creationTime;
-            break;
-        case BitProperty::ATime:
-            prop = mProperties.lastAccessTime;
-            break;
-        case BitProperty::MTime:
-            prop = mProperties.lastWriteTime;
-            break;
-        default: //empty prop
-            break;
+    // Note: the path and the item type are known even if the metadata was not read yet.
+    if ( property != BitProperty::Path && property != BitProperty::IsDir ) {
+        loadMetadata();
+    }
+
+    if ( property == BitProperty::Path ) {
+        return BitPropVariant{ mInArchivePath };
     }
-    return prop;
+    return inputItemProperty( mProperties, property );
 }
 
-auto BitInputItem::getStream( ISequentialInStream** inStream, bool storeOpenFiles ) const -> HRESULT try {
+auto BitInputItem::getStream(
+    ISequentialInStream** inStream,
+    bool storeOpenFiles,
+    std::uint32_t readBufferSize
+) const -> HRESULT try {
     if ( isDir() ) {
         return S_OK;
     }
@@ -265,11 +295,8 @@ auto BitInputItem::getStream( ISequentialInStream** inStream, bool storeOpenFile
     CMyComPtr< ISequentialInStream > inStreamLoc;
     if ( mProperties.inputType == InputItemType::Filesystem ) {
         // NOLINTNEXTLINE(*-pro-type-union-access)
-        if ( mFilesystemItem.symlinkPolicy == SymlinkPolicy::DoNotFollow && isSymLink() ) {
-            inStreamLoc = bit7z::make_com< CSymlinkInStream >( mPath );
-        } else {
-            inStreamLoc = bit7z::make_com< CFileInStream >( mPath, storeOpenFiles );
-        }
+        const auto symlinkPolicy = mFilesystemItem.symlinkPolicy;
+        inStreamLoc = makeFileItemStream( mPath, mProperties.attributes, symlinkPolicy, storeOpenFiles, readBufferSize );
     } else if ( mProperties.inputType == InputItemType::Buffer ) {
         // NOLINTNEXTLINE(*-pro-type-union-access)
         inStreamLoc = bit7z::make_com< CBufferInStream, ISequentialInStream >( mBufferItem );
@@ -287,15 +314,38 @@ auto BitInputItem::hasNewData() const noexcept -> bool {
     return mProperties.inputType != InputItemType::RenamedItem;
 }
 
+auto BitInputItem::readFileProperties( const native_string& itemPath, SymlinkPolicy symlinkPolicy )
+    -> InputItemProperties {
+    return fileProperties( itemPath, symlinkPolicy );
+}
+
+void BitInputItem::loadMetadata() const {
+    if ( mProperties.lazyMetadata ) {
+        // NOLINTNEXTLINE(*-pro-type-union-access)
+        mProperties = fileProperties( mPath, mFilesystemItem.symlinkPolicy );
+    }
+}
+
+void BitInputItem::tryLoadMetadata() const noexcept {
+    try {
+        loadMetadata();
+    } catch ( const BitException& ) { // NOLINT(*-empty-catch)
+        // The item keeps its lazy metadata, so the error will be reported when compressing it.
+    }
+}
+
 void BitInputItem::setCreationTime( time_type creationTime ) noexcept {
+    tryLoadMetadata();
     mProperties.creationTime = toFILETIME( creationTime );
 }
 
 void BitInputItem::setLastWriteTime( time_type lastWriteTime ) noexcept {
+    tryLoadMetadata();
     mProperties.lastWriteTime = toFILETIME( lastWriteTime );
 }
 
 void BitInputItem::setLastAccessTime( time_type lastAccessTime ) noexcept {
+    tryLoadMetadata();
     mProperties.lastAccessTime = toFILETIME( lastAccessTime );
 }
 
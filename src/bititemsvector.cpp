@@ -121,7 +121,7 @@ void indexFile( BitItemsVector& outVector, const tstring& inFile, const tstring&
     outVector.emplace_back( filePath, tstringToPath( name ), symlinkPolicy );
 }
 
-void indexBuffer( BitItemsVector& outVector, const buffer_t& inBuffer, const tstring& name ) {
+void indexBuffer( BitItemsVector& outVector, BitBufferView inBuffer, const tstring& name ) {
     outVector.emplace_back( inBuffer, name );
 }
 
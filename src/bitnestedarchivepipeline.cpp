@@ -0,0 +1,132 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "bitnestedarchivepipeline.hpp"
+
+#include "biterror.hpp"
+#include "bitexception.hpp"
+#include "internal/memoryutil.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+namespace bit7z {
+
+namespace {
+constexpr auto kNestingSeparator = BIT7Z_STRING( "!/" );
+constexpr std::size_t kNestingSeparatorLength = 2;
+
+auto splitNestedPath( const tstring& nestedPath, std::size_t formatsCount ) -> std::vector< tstring > {
+    std::vector< tstring > components;
+    tstring::size_type start = 0;
+    while ( true ) {
+        const auto separator = nestedPath.find( kNestingSeparator, start );
+        components.emplace_back( nestedPath.substr( start, separator - start ) );
+        if ( separator == tstring::npos ) {
+            break;
+        }
+        start = separator + kNestingSeparatorLength;
+    }
+
+    const auto hasEmptyComponent = std::any_of( components.cbegin(), components.cend(),
+                                                []( const tstring& component ) -> bool {
+                                                    return component.empty();
+                                                } );
+    if ( components.size() < 2 || hasEmptyComponent ) {
+        throw BitException( "Invalid nested archive path", make_error_code( BitError::InvalidArchivePath ), nestedPath );
+    }
+    if ( components.size() != formatsCount ) {
+        throw BitException( "Wrong number of formats for the nested archive path",
+                            std::make_error_code( std::errc::invalid_argument ),
+                            nestedPath );
+    }
+    return components;
+}
+
+auto findNestedItem( const BitInputArchive& archive, const tstring& itemPath ) -> std::uint32_t {
+    const auto item = archive.find( itemPath );
+    if ( item == archive.end() ) {
+        throw BitException( "Could not find the nested archive",
+                            make_error_code( BitError::NoMatchingItems ),
+                            itemPath );
+    }
+    return item->index();
+}
+} // namespace
+
+BitNestedArchivePipeline::BitNestedArchivePipeline(
+    const Bit7zLibrary& lib,
+    const tstring& nestedPath,
+    const std::vector< std::reference_wrapper< const BitInFormat > >& formats,
+    const tstring& password
+) : mPathComponents{ splitNestedPath( nestedPath, formats.size() ) },
+    mOuterArchive{ lib, mPathComponents.front(), formats.front(), password },
+    mMaxMemoryUsage{ defaultMaxMemoryUsage() } {
+    mStages.reserve( mPathComponents.size() - 1 );
+    mStages.emplace_back( new BitNestedArchiveReader{
+        lib, mOuterArchive, findNestedItem( mOuterArchive, mPathComponents[ 1 ] ), formats[ 1 ], password
+    } );
+    // The deeper archives cannot be listed without streaming their parents, so they are looked up by path.
+    for ( std::size_t level = 2; level < mPathComponents.size(); ++level ) {
+        mStages.emplace_back( new BitNestedArchiveReader{
+            lib, *mStages.back(), mPathComponents[ level ], formats[ level ], password
+        } );
+    }
+    setMaxMemoryUsage( mMaxMemoryUsage );
+}
+
+BitNestedArchivePipeline::~BitNestedArchivePipeline() {
+    // Each stage reads from the previous one, so we destroy the stages from the innermost to the outermost.
+    while ( !mStages.empty() ) {
+        mStages.pop_back();
+    }
+}
+
+auto BitNestedArchivePipeline::archive() noexcept -> BitNestedArchiveReader& {
+    return *mStages.back();
+}
+
+auto BitNestedArchivePipeline::archive() const noexcept -> const BitNestedArchiveReader& {
+    return *mStages.back();
+}
+
+auto BitNestedArchivePipeline::stagesCount() const noexcept -> std::size_t {
+    return mStages.size();
+}
+
+auto BitNestedArchivePipeline::maxMemoryUsage() const noexcept -> std::uint64_t {
+    return mMaxMemoryUsage;
+}
+
+void BitNestedArchivePipeline::setMaxMemoryUsage( std::uint64_t value ) noexcept {
+    mMaxMemoryUsage = value;
+    const auto stageMemoryUsage = std::max( value / static_cast< std::uint64_t >( mStages.size() ), kMinMaxMemoryUsage );
+    for ( auto& stage : mStages ) {
+        stage->setMaxMemoryUsage( stageMemoryUsage );
+    }
+}
+
+void BitNestedArchivePipeline::setAdaptiveMemoryUsage( std::uint64_t minValue, std::uint64_t maxValue ) noexcept {
+    mMaxMemoryUsage = maxValue;
+    const auto stagesCount = static_cast< std::uint64_t >( mStages.size() );
+    for ( auto& stage : mStages ) {
+        stage->setAdaptiveMemoryUsage( minValue / stagesCount, maxValue / stagesCount );
+    }
+}
+
+void BitNestedArchivePipeline::cancel() noexcept {
+    for ( const auto& stage : mStages ) {
+        stage->cancelExtraction();
+    }
+}
+
+} // namespace bit7z
@@ -14,80 +14,34 @@
 
 #include "biterror.hpp"
 #include "bitexception.hpp"
+#include "internal/cbufferinstream.hpp"
 #include "internal/csynchronizedinstream.hpp"
+#include "internal/formatdetect.hpp"
+#include "internal/memoryutil.hpp"
 #include <internal/util.hpp>
 
 #include <7zip/Archive/IArchive.h>
 
-#ifdef _WIN32
-#include <windows.h>
-#elif defined( __APPLE__ ) || defined( BSD ) || \
-      defined( __FreeBSD__ ) || defined( __NetBSD__ ) || defined( __OpenBSD__ ) || defined( __DragonFly__ )
-#include <sys/types.h>
-#include <sys/sysctl.h>
-#else
-#include <unistd.h>
-#if !defined( _SC_AVPHYS_PAGES ) || !defined( _SC_PAGE_SIZE )
-# include <sys/sysinfo.h>
-#endif
-#endif
-
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <mutex>
 #include <utility>
 
 namespace bit7z {
 
-// Minimum value for the maximum memory usage allowed for the BufferQueue.
-constexpr std::uint64_t kMinMaxMemoryUsage = 4ULL * 1024 * 1024; // 4 MiB //-V112
-
-namespace {
-auto getFreeRam() -> std::uint64_t {
-#if defined( _WIN64 ) || defined( _WIN32 )
-    MEMORYSTATUSEX memStatus{};
-    memStatus.dwLength = sizeof( memStatus );
-    GlobalMemoryStatusEx( &memStatus );
-    return memStatus.ullAvailPhys;
-#elif defined( __APPLE__ ) || defined( BSD ) || \
-      defined( __FreeBSD__ ) || defined( __NetBSD__ ) || defined( __OpenBSD__ ) || defined( __DragonFly__ )
-    static int mib[] = { CTL_HW, HW_USERMEM };
-    std::uint64_t value = 0;
-    std::size_t length = sizeof( value );
-
-    if ( sysctl( mib, 2, &value, &length, nullptr, 0 ) == 0 ) {
-        return value;
-    }
-    return 0;
-#elif defined( _SC_AVPHYS_PAGES ) && defined( _SC_PAGE_SIZE )
-    const long pages = sysconf( _SC_AVPHYS_PAGES );
-    const long page_size = sysconf( _SC_PAGE_SIZE );
-    if ( pages < 0 || page_size < 0 ) {
-        return 0;
-    }
-    return static_cast< std::uint64_t >( pages ) * static_cast< std::uint64_t >( page_size );
-#else
-    struct sysinfo info{};
-    sysinfo (&info);
-    return ( info.freeram + info.bufferram ) * info.mem_unit;
-#endif
-}
-
 #ifdef BIT7Z_AUTO_FORMAT
-auto validateFormat( BitInFormat&& format ) -> const BitInFormat&  = delete;
+namespace {
+// Enough data for all the signatures checked by detectFormatFromSignature (the farthest being the ISO/UDF ones).
+constexpr std::size_t kSignaturePeekSize = 64 * 1024; // 64 KiB
 
-auto validateFormat( const BitInFormat& format ) -> const BitInFormat& {
-    if ( format == BitFormat::Auto ) {
-        throw BitException{
-            "Automatic format detection not supported in nested archives",
-            BitError::UnsupportedOperation
-        };
-    }
-    return format;
+auto detectNestedFormat( CSynchronizedInStream& stream ) -> const BitInFormat& {
+    // Note: the peeked data is then read again by the nested archive, so the parent archive is extracted only once.
+    const auto signatureStream = bit7z::make_com< CBufferInStream, IInStream >( stream.peek( kSignaturePeekSize ) );
+    return detectFormatFromSignature( signatureStream );
 }
-
-#define VALIDATE_FORMAT(x) validateFormat(x)
-#else
-#define VALIDATE_FORMAT(x) x
-#endif
 } // namespace
+#endif
 
 BitNestedArchiveReader::BitNestedArchiveReader(
     const Bit7zLibrary& lib,
@@ -102,14 +56,48 @@ BitNestedArchiveReader::BitNestedArchiveReader(
     std::uint32_t index,
     const BitInFormat& format,
     const tstring& password
-) : BitAbstractArchiveOpener{ lib, VALIDATE_FORMAT( format ), password },
-    mNestedArchive{ *this, parentArchive.itemAt( index ) },
+) : BitAbstractArchiveOpener{ lib, format, password },
+    mNestedArchive{ *this, parentArchive.itemAt( index ).path(), format },
     mParentArchive{ parentArchive },
+    mParentReader{ nullptr },
     mIndexInParent{ index },
-    mMaxMemoryUsage{ std::max( getFreeRam() / 4, kMinMaxMemoryUsage ) },
+    mMaxMemoryUsage{ defaultMaxMemoryUsage() },
+    mMinAdaptiveMemoryUsage{ 0 },
+    mMaxAdaptiveMemoryUsage{ 0 },
     mCachedItemsCount{ 0 },
     mLastReadItem{ std::numeric_limits< decltype( mLastReadItem ) >::max() },
-    mOpenCount{ 0 } {}
+    mOpenCount{ 0 },
+    mInStream{ nullptr },
+    mCancelled{ false } {}
+
+BitNestedArchiveReader::BitNestedArchiveReader(
+    const Bit7zLibrary& lib,
+    const BitNestedArchiveReader& parentReader,
+    const tstring& pathInParent,
+    const BitInFormat& format,
+    const tstring& password
+) : BitAbstractArchiveOpener{ lib, format, password },
+    mNestedArchive{ *this, pathInParent, format },
+    mParentArchive{ parentReader.mNestedArchive },
+    mParentReader{ &parentReader },
+    mIndexInParent{ 0 },
+    mPathInParent{ pathInParent },
+    mMaxMemoryUsage{ defaultMaxMemoryUsage() },
+    mMinAdaptiveMemoryUsage{ 0 },
+    mMaxAdaptiveMemoryUsage{ 0 },
+    mCachedItemsCount{ 0 },
+    mLastReadItem{ std::numeric_limits< decltype( mLastReadItem ) >::max() },
+    mOpenCount{ 0 },
+    mInStream{ nullptr },
+    mCancelled{ false } {}
+
+BitNestedArchiveReader::~BitNestedArchiveReader() {
+    if ( mInStream != nullptr ) {
+        mInStream->cancel();
+        mInStream->waitExtraction();
+        mInStream->Release();
+    }
+}
 
 auto BitNestedArchiveReader::maxMemoryUsage() const noexcept -> std::uint64_t {
     return mMaxMemoryUsage;
@@ -119,11 +107,19 @@ auto BitNestedArchiveReader::detectedFormat() const noexcept -> const BitInForma
     return mNestedArchive.detectedFormat();
 }
 
-auto BitNestedArchiveReader::archiveProperty( BitProperty property ) const -> BitPropVariant {
+auto BitNestedArchiveReader::archiveProperty( BitProperty property ) const -> BitPropVariant try {
+#ifdef BIT7Z_AUTO_FORMAT
+    if ( mNestedArchive.detectedFormat() == BitFormat::Auto ) {
+        openSequentially(); // The archive object doesn't exist until the format is detected.
+    }
+#endif
     return mNestedArchive.archiveProperty( property );
+} catch ( const BitException& ) {
+    rethrowExtractionError();
+    throw;
 }
 
-auto BitNestedArchiveReader::itemProperty( std::uint32_t index, BitProperty property ) const -> BitPropVariant {
+auto BitNestedArchiveReader::itemProperty( std::uint32_t index, BitProperty property ) const -> BitPropVariant try {
     if ( needReopen( index ) ) {
         openSequentially();
     }
@@ -131,6 +127,9 @@ auto BitNestedArchiveReader::itemProperty( std::uint32_t index, BitProperty prop
     const auto result = mNestedArchive.itemProperty( index, property );
     mLastReadItem = index;
     return result;
+} catch ( const BitException& ) {
+    rethrowExtractionError();
+    throw;
 }
 
 auto BitNestedArchiveReader::calculateItemsCount() const -> std::uint32_t {
@@ -150,19 +149,31 @@ auto BitNestedArchiveReader::calculateItemsCount() const -> std::uint32_t {
     return 0;
 }
 
-auto BitNestedArchiveReader::itemsCount() const -> std::uint32_t {
+auto BitNestedArchiveReader::itemsCount() const -> std::uint32_t try {
     if ( mCachedItemsCount > 0 ) {
         return mCachedItemsCount;
     }
 
+    bool needOpen = needReopen();
+#ifdef BIT7Z_AUTO_FORMAT
+    // The archive object doesn't exist until the format is detected.
+    needOpen = needOpen || mNestedArchive.detectedFormat() == BitFormat::Auto;
+#endif
+    if ( needOpen ) {
+        openSequentially();
+    }
+
     mCachedItemsCount = mNestedArchive.itemsCount();
     if ( mCachedItemsCount == std::numeric_limits< std::uint32_t >::max() ) {
         mCachedItemsCount = calculateItemsCount();
     }
     return mCachedItemsCount;
+} catch ( const BitException& ) {
+    rethrowExtractionError();
+    throw;
 }
 
-auto BitNestedArchiveReader::items() const -> std::vector< BitArchiveItemInfo > {
+auto BitNestedArchiveReader::items() const -> std::vector< BitArchiveItemInfo > try {
     if ( needReopen() ) {
         openSequentially();
     }
@@ -192,45 +203,127 @@ auto BitNestedArchiveReader::items() const -> std::vector< BitArchiveItemInfo >
     }
     mLastReadItem = std::numeric_limits< decltype( mLastReadItem ) >::max();
     return result;
+} catch ( const BitException& ) {
+    rethrowExtractionError();
+    throw;
 }
 
-void BitNestedArchiveReader::extractTo( const tstring& outDir ) const {
+void BitNestedArchiveReader::extractTo( const tstring& outDir ) const try {
     if ( needReopen() ) {
         openSequentially();
     }
     mNestedArchive.extractTo( outDir );
     mLastReadItem = std::numeric_limits< decltype( mLastReadItem ) >::max();
+} catch ( const BitException& ) {
+    rethrowExtractionError();
+    throw;
 }
 
-void BitNestedArchiveReader::extractTo( std::map< tstring, buffer_t >& outMap ) const {
+void BitNestedArchiveReader::extractTo( std::map< tstring, buffer_t >& outMap ) const try {
     if ( needReopen() ) {
         openSequentially();
     }
     mNestedArchive.extractTo( outMap );
     mLastReadItem = std::numeric_limits< decltype( mLastReadItem ) >::max();
+} catch ( const BitException& ) {
+    rethrowExtractionError();
+    throw;
 }
 
-void BitNestedArchiveReader::test() const {
+void BitNestedArchiveReader::test() const try {
     if ( needReopen() ) {
         openSequentially();
     }
     mNestedArchive.test();
     mLastReadItem = std::numeric_limits< decltype( mLastReadItem ) >::max();
+} catch ( const BitException& ) {
+    rethrowExtractionError();
+    throw;
 }
 
 void BitNestedArchiveReader::openSequentially() const {
-    const auto stream = bit7z::make_com< CSynchronizedInStream, ISequentialInStream >(
-        mMaxMemoryUsage,
-        mParentArchive,
-        mIndexInParent
-    );
-    mNestedArchive.openArchiveSeqStream( stream );
+    // Any running extraction of the parent archives must end before we can reopen them.
+    stopExtraction();
+    if ( mParentReader != nullptr ) {
+        mParentReader->openSequentially();
+    }
+
+    if ( mInStream != nullptr && mMinAdaptiveMemoryUsage > 0 ) {
+        // The new extraction starts from the memory limit the previous one adapted to.
+        mMaxMemoryUsage = mInStream->bufferingMetrics().memoryLimit;
+    }
+
+    auto stream = mPathInParent.empty()
+        ? bit7z::make_com< CSynchronizedInStream >( mMaxMemoryUsage, mParentArchive, mIndexInParent )
+        : bit7z::make_com< CSynchronizedInStream >( mMaxMemoryUsage, mParentArchive, mPathInParent );
+    if ( mMinAdaptiveMemoryUsage > 0 ) {
+        stream->setAdaptiveMemoryUsage( mMinAdaptiveMemoryUsage, mMaxAdaptiveMemoryUsage );
+    }
+    {
+        const std::lock_guard< std::mutex > lock( mStreamMutex );
+        if ( mInStream != nullptr ) {
+            mInStream->Release();
+        }
+        // Note: we keep a reference to the stream so that we can stop it and check its errors, if any.
+        mInStream = stream.Detach();
+        mCancelled = false;
+    }
+#ifdef BIT7Z_AUTO_FORMAT
+    if ( mNestedArchive.detectedFormat() == BitFormat::Auto ) {
+        mNestedArchive.setNestedArchiveFormat( detectNestedFormat( *mInStream ) );
+    }
+#endif
+    mNestedArchive.openArchiveSeqStream( mInStream );
     mLastReadItem = 0;
     ++mOpenCount;
 }
 
+void BitNestedArchiveReader::stopExtraction() const noexcept {
+    /* First, we cancel all the streams of the pipeline, so that no extraction keeps waiting for another one
+     * (e.g., for a full queue to be emptied); then, we wait for all the extractions to actually end. */
+    for ( const auto* reader = this; reader != nullptr; reader = reader->mParentReader ) {
+        if ( reader->mInStream != nullptr ) {
+            reader->mInStream->cancel();
+        }
+    }
+    for ( const auto* reader = this; reader != nullptr; reader = reader->mParentReader ) {
+        if ( reader->mInStream != nullptr ) {
+            reader->mInStream->waitExtraction();
+        }
+    }
+}
+
+void BitNestedArchiveReader::cancelExtraction() const noexcept {
+    const std::lock_guard< std::mutex > lock( mStreamMutex );
+    mCancelled = true;
+    if ( mInStream != nullptr ) {
+        mInStream->cancel();
+    }
+}
+
+auto BitNestedArchiveReader::extractionError() const noexcept -> std::exception_ptr {
+    // A failure of an outer stage makes all the inner stages fail too, so the outermost error is the root cause.
+    if ( mParentReader != nullptr ) {
+        auto parentError = mParentReader->extractionError();
+        if ( parentError ) {
+            return parentError;
+        }
+    }
+    return mInStream != nullptr ? mInStream->extractionError() : nullptr;
+}
+
+void BitNestedArchiveReader::rethrowExtractionError() const {
+    stopExtraction();
+    mLastReadItem = std::numeric_limits< decltype( mLastReadItem ) >::max(); // The archive must be reopened.
+
+    const auto error = extractionError();
+    if ( error ) {
+        std::rethrow_exception( error );
+    }
+}
+
 auto BitNestedArchiveReader::needReopen( std::uint32_t index ) const -> bool {
-    return index < mLastReadItem;
+    return mCancelled || index < mLastReadItem;
 }
 
 auto BitNestedArchiveReader::openCount() const -> std::size_t {
@@ -240,6 +333,23 @@ auto BitNestedArchiveReader::openCount() const -> std::size_t {
 void BitNestedArchiveReader::setMaxMemoryUsage( std::uint64_t value ) noexcept {
     // TODO: Throw an exception if the value is below the minimum?
     mMaxMemoryUsage = std::max( value, kMinMaxMemoryUsage );
+    mMinAdaptiveMemoryUsage = 0;
+    mMaxAdaptiveMemoryUsage = 0;
+}
+
+void BitNestedArchiveReader::setAdaptiveMemoryUsage( std::uint64_t minValue, std::uint64_t maxValue ) noexcept {
+    mMinAdaptiveMemoryUsage = std::max( minValue, kMinMaxMemoryUsage );
+    mMaxAdaptiveMemoryUsage = std::max( maxValue, mMinAdaptiveMemoryUsage );
+    mMaxMemoryUsage = std::min( std::max( mMaxMemoryUsage, mMinAdaptiveMemoryUsage ), mMaxAdaptiveMemoryUsage );
+}
+
+auto BitNestedArchiveReader::bufferingMetrics() const -> BufferingMetrics {
+    if ( mInStream != nullptr ) {
+        return mInStream->bufferingMetrics();
+    }
+    BufferingMetrics result{};
+    result.memoryLimit = mMaxMemoryUsage;
+    return result;
 }
 
 } // namespace bit7z
@@ -24,26 +24,146 @@
 #include "bitwindows.hpp"
 #include "internal/archiveproperties.hpp"
 #include "internal/atomicfilereplacer.hpp"
+#include "internal/cboundedbufferoutstream.hpp"
+#include "internal/cbufferinstream.hpp"
 #include "internal/cbufferoutstream.hpp"
 #include "internal/cfileoutstream.hpp"
 #include "internal/cmultivolumeoutstream.hpp"
+#include "internal/compressibility.hpp"
+#include "internal/contenthash.hpp"
+#include "internal/csegmentedoutstream.hpp"
 #include "internal/cstdoutstream.hpp"
+#include "internal/cstdsequentialoutstream.hpp"
 #include "internal/fsutil.hpp"
+#include "internal/inplaceappender.hpp"
+#include "internal/inputitemsstore.hpp"
 #include "internal/updatecallback.hpp"
 #include "internal/util.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <istream>
 #include <map>
 #include <memory>
 #include <ostream>
+#include <string>
 #include <utility>
 #include <system_error>
+#include <unordered_map>
 #include <vector>
 
 namespace bit7z {
 
+namespace {
+/* Like BitInputArchive::find, on Windows we match item paths element-wise to support both path separators;
+ * hence, the path elements are joined using the native separator to get a key for the hash table.
+ * On other systems, item paths can be matched by just comparing their strings. */
+auto itemPathKey( const fs::path& itemPath ) -> tstring {
+#ifdef _WIN32
+    tstring key;
+    for ( const auto& element : itemPath ) {
+        key += pathToTstring( element );
+        key += BIT7Z_STRING( '\\' );
+    }
+    return key;
+#else
+    return pathToTstring( itemPath );
+#endif
+}
+
+// Maps the path of each item in the input archive to its index (the first one, if multiple items have the same path).
+auto indexItemPaths( const BitInputArchive& inputArchive ) -> std::unordered_map< tstring, std::uint32_t > {
+    std::unordered_map< tstring, std::uint32_t > result;
+    result.reserve( inputArchive.itemsCount() );
+    for ( const auto& item : inputArchive ) {
+#ifdef _WIN32
+        result.emplace( itemPathKey( item.nativePath() ), item.index() );
+#else
+        result.emplace( item.path(), item.index() );
+#endif
+    }
+    return result;
+}
+
+constexpr auto kFileTimeTicksPerSecond = 10000000ULL; // FILETIME values are in 100-nanosecond intervals.
+
+// The precision of the modification times stored by the output format, in FILETIME ticks.
+auto fileTimePrecision( IOutArchive* outArc ) -> std::uint64_t {
+    UInt32 timeType = NFileTimeType::kWindows;
+    if ( outArc->GetFileTimeType( &timeType ) != S_OK ) {
+        return 1;
+    }
+    switch ( timeType ) {
+        case NFileTimeType::kUnix:
+            return kFileTimeTicksPerSecond;
+        case NFileTimeType::kDOS:
+            return 2 * kFileTimeTicksPerSecond;
+        default:
+            return 1;
+    }
+}
+
+auto fileTimeTicks( const FILETIME& fileTime ) noexcept -> std::uint64_t {
+    return ( static_cast< std::uint64_t >( fileTime.dwHighDateTime ) << 32u ) | fileTime.dwLowDateTime;
+}
+
+auto isSameFileTime( const BitPropVariant& first, const BitPropVariant& second, std::uint64_t precision ) -> bool {
+    if ( !first.isFileTime() || !second.isFileTime() ) {
+        return false;
+    }
+    const auto firstTicks = fileTimeTicks( first.getFileTime() );
+    const auto secondTicks = fileTimeTicks( second.getFileTime() );
+    return ( firstTicks > secondTicks ? firstTicks - secondTicks : secondTicks - firstTicks ) < precision;
+}
+
+struct ItemSortKey final {
+    InputIndex index;
+    bool isDir;
+    tstring extension;
+    tstring name;
+    std::uint64_t size;
+};
+
+auto toLowerAscii( tstring str ) -> tstring {
+    std::transform( str.begin(), str.end(), str.begin(), []( tchar character ) -> tchar {
+        return character >= 'A' && character <= 'Z' ? static_cast< tchar >( character - 'A' + 'a' ) : character;
+    } );
+    return str;
+}
+
+auto makeSortKey( InputIndex index, bool isDir, const tstring& path, std::uint64_t size ) -> ItemSortKey {
+    const auto separator = path.find_last_of( BIT7Z_STRING( "/\\" ) );
+    const auto nameStart = separator == tstring::npos ? 0 : separator + 1;
+    const auto dot = path.rfind( BIT7Z_STRING( '.' ) );
+    const auto extensionStart = dot == tstring::npos || dot < nameStart ? path.size() : dot + 1;
+    return ItemSortKey{
+        index,
+        isDir,
+        toLowerAscii( path.substr( extensionStart ) ),
+        toLowerAscii( path.substr( nameStart ) ),
+        size
+    };
+}
+
+// Like 7-Zip's sorting by type: files are ordered by extension, name, and size, while directories come first.
+auto compareByType( const ItemSortKey& first, const ItemSortKey& second ) -> bool {
+    if ( first.isDir || second.isDir ) {
+        return first.isDir && !second.isDir;
+    }
+    if ( first.extension != second.extension ) {
+        return first.extension < second.extension;
+    }
+    if ( first.name != second.name ) {
+        return first.name < second.name;
+    }
+    return first.size < second.size;
+}
+
+// The content of the duplicate files stored as hard links.
+const buffer_t kHardLinkContent{}; // NOLINT(*-err58-cpp)
+} // namespace
+
 BitOutputArchive::BitOutputArchive( const BitAbstractArchiveCreator& creator )
     : mArchiveCreator{ creator }, mInputArchiveItemsCount{ 0 } {}
 
@@ -119,34 +239,52 @@ void BitOutputArchive::addItems( const std::vector< tstring >& inPaths ) {
     IndexingOptions options{};
     options.retainFolderStructure = mArchiveCreator.retainDirectories();
     options.symlinkPolicy = !mArchiveCreator.storeSymbolicLinks() ? SymlinkPolicy::Follow : SymlinkPolicy::DoNotFollow;
+    options.lazyMetadata = mArchiveCreator.lazyFileMetadata();
     indexPaths( mNewItems, inPaths, options );
+    storeNewItems();
 }
 
 void BitOutputArchive::addItems( const std::vector< std::pair< tstring, tstring > >& inPaths ) {
     IndexingOptions options{};
     options.retainFolderStructure = mArchiveCreator.retainDirectories();
     options.symlinkPolicy = !mArchiveCreator.storeSymbolicLinks() ? SymlinkPolicy::Follow : SymlinkPolicy::DoNotFollow;
+    options.lazyMetadata = mArchiveCreator.lazyFileMetadata();
     indexPaths( mNewItems, inPaths, options );
+    storeNewItems();
 }
 
 void BitOutputArchive::addItems( const std::map< tstring, tstring >& inPaths ) {
     IndexingOptions options{};
     options.symlinkPolicy = !mArchiveCreator.storeSymbolicLinks() ? SymlinkPolicy::Follow : SymlinkPolicy::DoNotFollow;
+    options.lazyMetadata = mArchiveCreator.lazyFileMetadata();
     indexPathsMap( mNewItems, inPaths, options );
+    storeNewItems();
+}
+
+void BitOutputArchive::addItems( const BitInputSource& inputSource ) {
+    resetSourceItem();
+    mInputSources.emplace_back( inputSource );
 }
 
 auto BitOutputArchive::addFile( const tstring& inFile, const tstring& name ) -> BitInputItem& {
     const auto policy = !mArchiveCreator.storeSymbolicLinks() ? SymlinkPolicy::Follow : SymlinkPolicy::DoNotFollow;
+    storeNewItems();
     indexFile( mNewItems, inFile, mArchiveCreator.retainDirectories() ? inFile : name, policy );
     return mNewItems.back();
 }
 
 auto BitOutputArchive::addFile( const buffer_t& inBuffer, const tstring& name ) -> BitInputItem& {
+    return addFile( BitBufferView{ inBuffer }, name );
+}
+
+auto BitOutputArchive::addFile( BitBufferView inBuffer, const tstring& name ) -> BitInputItem& {
+    storeNewItems();
     indexBuffer( mNewItems, inBuffer, name );
     return mNewItems.back();
 }
 
 auto BitOutputArchive::addFile( std::istream& inStream, const tstring& name ) -> BitInputItem& {
+    storeNewItems();
     indexStream( mNewItems, inStream, name );
     return mNewItems.back();
 }
@@ -157,7 +295,9 @@ void BitOutputArchive::addFiles( const std::vector< tstring >& inFiles ) {
     options.retainFolderStructure = mArchiveCreator.retainDirectories();
     options.onlyFiles = true;
     options.symlinkPolicy = !mArchiveCreator.storeSymbolicLinks() ? SymlinkPolicy::Follow : SymlinkPolicy::DoNotFollow;
+    options.lazyMetadata = mArchiveCreator.lazyFileMetadata();
     indexPaths( mNewItems, inFiles, options );
+    storeNewItems();
 }
 
 void BitOutputArchive::addFiles( const tstring& inDir, const tstring& filter, bool recursive ) {
@@ -171,14 +311,18 @@ void BitOutputArchive::addFiles( const tstring& inDir, const tstring& filter, Fi
     options.retainFolderStructure = mArchiveCreator.retainDirectories();
     options.onlyFiles = true;
     options.symlinkPolicy = !mArchiveCreator.storeSymbolicLinks() ? SymlinkPolicy::Follow : SymlinkPolicy::DoNotFollow;
+    options.lazyMetadata = mArchiveCreator.lazyFileMetadata();
     indexDirectory( mNewItems, inDir, filter, options );
+    storeNewItems();
 }
 
 void BitOutputArchive::addDirectory( const tstring& inDir ) {
     IndexingOptions options{};
     options.retainFolderStructure = mArchiveCreator.retainDirectories();
     options.symlinkPolicy = !mArchiveCreator.storeSymbolicLinks() ? SymlinkPolicy::Follow : SymlinkPolicy::DoNotFollow;
+    options.lazyMetadata = mArchiveCreator.lazyFileMetadata();
     indexDirectory( mNewItems, inDir, {}, options );
+    storeNewItems();
 }
 
 void BitOutputArchive::addDirectoryContents( const tstring& inDir, const tstring& filter, bool recursive ) {
@@ -197,47 +341,82 @@ void BitOutputArchive::addDirectoryContents(
     options.onlyFiles = !recursive;
     options.retainFolderStructure = mArchiveCreator.retainDirectories();
     options.symlinkPolicy = !mArchiveCreator.storeSymbolicLinks() ? SymlinkPolicy::Follow : SymlinkPolicy::DoNotFollow;
+    options.lazyMetadata = mArchiveCreator.lazyFileMetadata();
     indexDirectoryContent( mNewItems, inDir, filter, options );
+    storeNewItems();
 }
 
-auto BitOutputArchive::initOutArchive() const -> CMyComPtr< IOutArchive > {
+auto BitOutputArchive::initOutArchive() -> CMyComPtr< IOutArchive > {
     CMyComPtr< IOutArchive > newArc;
-    if ( mInputArchive == nullptr ) {
+    auto* const inputArchive = this->inputArchive();
+    if ( inputArchive == nullptr ) {
         newArc = mArchiveCreator.library().initOutArchive( mArchiveCreator.compressionFormat() );
     } else {
-        const auto res = mInputArchive->initUpdatableArchive( &newArc );
+        const auto res = inputArchive->initUpdatableArchive( &newArc );
         if ( res != S_OK ) {
             throw BitException{ "Could not make the input archive object updatable", make_hresult_code( res ) };
         }
     }
+    probeCompressibility();
     setArchiveProperties( newArc );
     return newArc;
 }
 
-auto BitOutputArchive::initOutFileStream( const fs::path& outArchive ) const -> CMyComPtr< IOutStream > {
-    if ( mArchiveCreator.volumeSize() > 0 ) {
-        return bit7z::make_com< CMultiVolumeOutStream, IOutStream >( mArchiveCreator.volumeSize(), outArchive );
-    }
-
-    return bit7z::make_com< CFileOutStream, IOutStream >( outArchive );
-}
-
 void BitOutputArchive::compressOut(
     IOutArchive* outArc,
-    IOutStream* outStream,
+    ISequentialOutStream* outStream,
     UpdateCallback* updateCallback
 ) {
-    if ( mInputArchive != nullptr && mArchiveCreator.updateMode() == UpdateMode::Update ) {
-        for ( const auto& newItem : mNewItems ) {
-            auto newItemPath = pathToTstring( newItem.inArchivePath() );
-            auto updatedItem = mInputArchive->find( newItemPath );
-            if ( updatedItem != mInputArchive->cend() ) {
-                setDeletedIndex( updatedItem->index() );
+    markUpdatedItems( outArc );
+    updateItems( outArc, outStream, updateCallback );
+}
+
+void BitOutputArchive::markUpdatedItems( IOutArchive* outArc ) {
+    const auto updateMode = mArchiveCreator.updateMode();
+    if ( hasInputArchive() && ( updateMode == UpdateMode::Update || updateMode == UpdateMode::Sync ) &&
+         hasNewItems() ) {
+        // Note: indexing the paths once avoids scanning the whole input archive for each new item.
+        const auto inputItemsIndex = indexItemPaths( *inputArchive() );
+        const auto timePrecision = updateMode == UpdateMode::Sync ? fileTimePrecision( outArc ) : 1;
+        const auto newItemsCount = this->newItemsCount();
+        for ( std::size_t newItemIndex = 0; newItemIndex < newItemsCount; ++newItemIndex ) {
+            const auto itemPath = newItemIndex < storedItemsCount() ?
+                                  mItemsStore->inArchivePath( newItemIndex ) :
+                                  newItem( newItemIndex ).inArchivePath();
+            const auto updatedItem = inputItemsIndex.find( itemPathKey( itemPath ) );
+            if ( updatedItem == inputItemsIndex.cend() ) {
+                continue;
+            }
+
+            const auto newItemInputIndex = mInputArchiveItemsCount + static_cast< std::uint32_t >( newItemIndex );
+            if ( updateMode == UpdateMode::Sync &&
+                 isUnchangedItem( updatedItem->second, newItemInputIndex, timePrecision ) ) {
+                // The old item is kept as it is, so we skip the new one, as if it were deleted.
+                setDeletedIndex( newItemInputIndex );
+            } else {
+                setDeletedIndex( updatedItem->second );
             }
         }
     }
+}
+
+void BitOutputArchive::updateItems(
+    IOutArchive* outArc,
+    ISequentialOutStream* outStream,
+    UpdateCallback* updateCallback
+) {
+    // Note: the input sources might produce different items in each compression.
+    resetSourceItem();
     updateInputIndices();
 
+    mDuplicateItems.clear();
+    if ( mArchiveCreator.deduplicateFiles() ) {
+        findDuplicateItems();
+        if ( !mDuplicateItems.empty() && !linksDuplicateItems() ) {
+            groupDuplicateItems();
+        }
+    }
+
     const HRESULT result = outArc->UpdateItems( outStream, itemsCount(), updateCallback );
 
     if ( result == E_NOTIMPL ) {
@@ -249,12 +428,157 @@ void BitOutputArchive::compressOut(
     }
 }
 
-void BitOutputArchive::compressToFile( const fs::path& outFile, UpdateCallback* updateCallback ) {
-    // Note: if mInputArchive is not nullptr, newArc will actually point to the same IInArchive object
-    // used by the old_arc (see initUpdatableArchive function of BitInputArchive).
-    const bool updatingArchive = mInputArchive != nullptr && tstringToPath( mInputArchive->archivePath() ) == outFile;
-    const CMyComPtr< IOutArchive > newArc = initOutArchive();
+auto BitOutputArchive::isUnchangedItem(
+    std::uint32_t oldItemIndex,
+    std::uint32_t newItemIndex,
+    std::uint64_t timePrecision
+) const -> bool {
+    const auto newItemInputIndex = static_cast< InputIndex >( newItemIndex );
+    const auto* const inputArchive = this->inputArchive();
+    const auto oldIsDir = inputArchive->itemProperty( oldItemIndex, BitProperty::IsDir );
+    const bool isDir = itemProperty( newItemInputIndex, BitProperty::IsDir ).getBool();
+    if ( !oldIsDir.isBool() || oldIsDir.getBool() != isDir ) {
+        return false;
+    }
+
+    // Note: some formats do not store the size of directories, so we compare only their modification time.
+    if ( !isDir ) {
+        const auto oldSize = inputArchive->itemProperty( oldItemIndex, BitProperty::Size );
+        if ( oldSize.isEmpty() ||
+             oldSize.getUInt64() != itemProperty( newItemInputIndex, BitProperty::Size ).getUInt64() ) {
+            return false;
+        }
+    }
+
+    return isSameFileTime( inputArchive->itemProperty( oldItemIndex, BitProperty::MTime ),
+                           itemProperty( newItemInputIndex, BitProperty::MTime ),
+                           timePrecision );
+}
 
+auto BitOutputArchive::fitsInZipArchive( std::uint64_t appendOffset ) const -> bool {
+    // The zip format without the Zip64 extensions supports up to 65535 items, and offsets up to 4 GiB.
+    constexpr std::uint64_t kMaxZipItems = 0xFFFE;
+    constexpr std::uint64_t kMaxZipOffset = 0xFFFFFFFE;
+
+    // A generous upper bound to the size of the headers of an item (including its path and extra fields).
+    constexpr std::uint64_t kZipItemOverhead = 4096;
+
+    // Note: the sizes of the items of the input sources are not known in advance.
+    if ( sourcesItemsCount() > 0 || std::uint64_t{ mInputArchiveItemsCount } + newItemsCount() > kMaxZipItems ) {
+        return false;
+    }
+
+    std::uint64_t appendedSize = appendOffset;
+    const auto newItemsCount = this->newItemsCount();
+    for ( std::size_t newItemIndex = 0; newItemIndex < newItemsCount; ++newItemIndex ) {
+        const auto inputIndex = static_cast< InputIndex >( mInputArchiveItemsCount + newItemIndex );
+        appendedSize += kZipItemOverhead;
+        try {
+            const auto isDir = itemProperty( inputIndex, BitProperty::IsDir );
+            if ( !isDir.isBool() || !isDir.getBool() ) {
+                const auto itemSize = itemProperty( inputIndex, BitProperty::Size );
+                if ( !itemSize.isUInt64() || itemSize.getUInt64() >= kMaxZipOffset ) {
+                    return false;
+                }
+                // Note: incompressible data might slightly grow when compressed.
+                appendedSize += itemSize.getUInt64() + ( itemSize.getUInt64() / 64 );
+            }
+        } catch ( const BitException& ) {
+            return false; // The full update of the archive will report the error as usual.
+        }
+        if ( appendedSize >= kMaxZipOffset ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* When only adding items to a tar or zip archive, the new items can be written right after the existing ones,
+ * which are kept in place instead of being copied into a new archive file: the new items are compressed as a
+ * separate archive starting at the end of the existing items, and then the trailers of the two archives are merged
+ * (for zip archives, the new central directory also lists the old items).
+ * Returns false if the archive cannot be updated in this way, without modifying the archive file. */
+auto BitOutputArchive::appendInPlace( const fs::path& outFile, UpdateCallback* updateCallback ) -> bool {
+    const auto& format = mArchiveCreator.compressionFormat();
+    // Note: a deferred input archive has been written by this object, so its format is the output one.
+    const bool sameFormat = mInputArchive == nullptr || mInputArchive->detectedFormat() == format;
+    AppendableFormat appendableFormat{};
+    if ( format == BitFormat::Tar && sameFormat ) {
+        appendableFormat = AppendableFormat::Tar;
+    } else if ( format == BitFormat::Zip && sameFormat ) {
+        appendableFormat = AppendableFormat::Zip;
+    } else {
+        return false;
+    }
+
+    const auto isDeletedInputItem = [this]() -> bool {
+        return !mDeletedItems.empty() && *mDeletedItems.cbegin() < mInputArchiveItemsCount;
+    };
+    if ( !hasNewItems() || hasEditedItems() || isDeletedInputItem() ) {
+        return false;
+    }
+
+    // Note: the items of the input archive are never copied, so we can use a new archive object for the new items.
+    const CMyComPtr< IOutArchive > newArc = mArchiveCreator.library().initOutArchive( format );
+    markUpdatedItems( newArc );
+    if ( isDeletedInputItem() ) {
+        return false; // Some new items replace old ones.
+    }
+
+    // The lock is held until the append is committed (or rolled back), so no other append or recovery can interfere.
+    const ArchiveFileLock archiveLock{ outFile };
+    if ( !archiveLock.isLocked() ) {
+        return false; // E.g., the file system doesn't support locking, so we fall back to rewriting the archive.
+    }
+    InPlaceAppender::recover( archiveLock );
+
+    Optional< AppendPoint > appendPoint;
+    try {
+        appendPoint = findAppendPoint( outFile, appendableFormat );
+    } catch ( const BitException& ) {
+        return false; // The archive file cannot be probed, so we fall back to rewriting it.
+    }
+    if ( !appendPoint ||
+         ( appendableFormat == AppendableFormat::Zip && !fitsInZipArchive( appendPoint->offset ) ) ) {
+        return false;
+    }
+
+    probeCompressibility();
+    setArchiveProperties( newArc );
+
+    if ( mInputArchive != nullptr ) {
+        const auto closeResult = mInputArchive->close();
+        if ( closeResult != S_OK ) {
+            throw BitException(
+                "Failed to close the archive",
+                make_hresult_code( closeResult ),
+                mInputArchive->archivePath()
+            );
+        }
+    }
+
+    InPlaceAppender appender{ archiveLock, std::move( *appendPoint ), mArchiveCreator.writeBufferSize() };
+
+    // The items of the input archive are kept as they are in the archive file, so they are excluded from the output.
+    const auto deletedItems = mDeletedItems;
+    const auto firstNewItem = mDeletedItems.lower_bound( mInputArchiveItemsCount );
+    for ( std::uint32_t index = 0; index < mInputArchiveItemsCount; ++index ) {
+        mDeletedItems.insert( firstNewItem, index );
+    }
+    try {
+        updateItems( newArc, appender.stream(), updateCallback );
+    } catch ( ... ) {
+        mDeletedItems = deletedItems;
+        throw;
+    }
+    mDeletedItems = deletedItems;
+
+    appender.commit();
+    return true;
+}
+
+void BitOutputArchive::compressToFile( const fs::path& outFile, UpdateCallback* updateCallback ) {
+    const bool updatingArchive = hasInputArchive() && tstringToPath( inputArchivePath() ) == outFile;
     if ( updatingArchive ) {
         if ( mArchiveCreator.volumeSize() > 0 ) {
             throw BitException(
@@ -262,7 +586,17 @@ void BitOutputArchive::compressToFile( const fs::path& outFile, UpdateCallback*
                 make_error_code( BitError::UnsupportedOperation )
             );
         }
-        AtomicFileReplacer replacer{ outFile };
+        if ( appendInPlace( outFile, updateCallback ) ) {
+            return;
+        }
+    }
+
+    // Note: if mInputArchive is not nullptr, newArc will actually point to the same IInArchive object
+    // used by the old_arc (see initUpdatableArchive function of BitInputArchive).
+    const CMyComPtr< IOutArchive > newArc = initOutArchive();
+
+    if ( updatingArchive ) {
+        AtomicFileReplacer replacer{ outFile, mArchiveCreator.writeBufferSize() };
         compressOut( newArc, replacer.stream(), updateCallback );
 
         const auto closeResult = mInputArchive->close();
@@ -274,9 +608,34 @@ void BitOutputArchive::compressToFile( const fs::path& outFile, UpdateCallback*
             );
         }
         replacer.commit();
+    } else if ( mArchiveCreator.volumeSize() > 0 ) {
+        const auto volumeSize = mArchiveCreator.volumeSize();
+        const auto outStream = bit7z::make_com< CMultiVolumeOutStream >( volumeSize, outFile );
+        compressOut( newArc, outStream, updateCallback );
+
+        // Note: as for single-file archives, any error would be lost when destroying the stream.
+        const auto flushResult = outStream->flush();
+        if ( flushResult != S_OK ) {
+            throw BitException(
+                "Failed to write the archive volumes",
+                make_hresult_code( flushResult ),
+                pathToTstring( outFile )
+            );
+        }
     } else {
-        const CMyComPtr< IOutStream > outStream = initOutFileStream( outFile );
+        const auto writeBufferSize = mArchiveCreator.writeBufferSize();
+        const auto outStream = bit7z::make_com< CFileOutStream >( outFile, FileFlag::CreateNew, writeBufferSize );
         compressOut( newArc, outStream, updateCallback );
+
+        // Note: we need to write the buffered data here, as any error would be lost when destroying the stream.
+        const auto flushResult = outStream->flush();
+        if ( flushResult != S_OK ) {
+            throw BitException(
+                "Failed to write the archive file",
+                make_hresult_code( flushResult ),
+                pathToTstring( outFile )
+            );
+        }
     }
 }
 
@@ -300,7 +659,7 @@ void BitOutputArchive::compressTo( const tstring& outFile ) {
             throw BitException( "Failed to delete the old archive file", error, outFile );
         }
         // Note: if overwriteMode is OverwriteMode::None, an exception will be thrown by the CFileOutStream constructor
-        // called by the initOutFileStream function.
+        // called by the compressToFile function.
     }
 
     const auto updateCallback = bit7z::make_com< UpdateCallback >( *this );
@@ -326,15 +685,81 @@ void BitOutputArchive::compressTo( buffer_t& outBuffer ) {
     compressOut( newArc, outMemStream, updateCallback );
 }
 
+void BitOutputArchive::compressTo( BitSegmentedBuffer& outBuffer ) {
+    if ( !outBuffer.empty() ) {
+        const OverwriteMode overwriteMode = mArchiveCreator.overwriteMode();
+        if ( overwriteMode == OverwriteMode::Skip ) {
+            return;
+        }
+        if ( overwriteMode == OverwriteMode::Overwrite ) {
+            outBuffer.clear();
+        } else {
+            throw BitException( "Cannot compress to buffer", make_error_code( BitError::NonEmptyOutputBuffer ) );
+        }
+    }
+
+    const auto newArc = initOutArchive();
+    const auto outSegmentedStream = bit7z::make_com< CSegmentedOutStream, IOutStream >( outBuffer );
+    const auto updateCallback = bit7z::make_com< UpdateCallback >( *this );
+    compressOut( newArc, outSegmentedStream, updateCallback );
+}
+
+auto BitOutputArchive::compressTo( byte_t* outBuffer, std::size_t size ) -> std::size_t {
+    if ( outBuffer == nullptr ) {
+        throw BitException( "Cannot compress to buffer", make_error_code( BitError::NullOutputBuffer ) );
+    }
+    if ( size == 0 ) {
+        throw BitException( "Cannot compress to buffer", make_error_code( BitError::InvalidOutputBufferSize ) );
+    }
+
+    const auto newArc = initOutArchive();
+    const auto outBufferStream = bit7z::make_com< CBoundedBufferOutStream >( outBuffer, size );
+    const auto updateCallback = bit7z::make_com< UpdateCallback >( *this );
+    compressOut( newArc, outBufferStream, updateCallback );
+
+    const auto archiveSize = outBufferStream->size();
+    if ( archiveSize > size ) {
+        throw BitException( "Cannot compress to buffer (the archive needs " + std::to_string( archiveSize ) +
+                            " bytes, but the buffer has " + std::to_string( size ) + " bytes)",
+                            make_error_code( BitError::InsufficientOutputBufferSize ) );
+    }
+    return static_cast< std::size_t >( archiveSize );
+}
+
 void BitOutputArchive::compressTo( std::ostream& outStream ) {
+    // Note: non-seekable streams (e.g., pipes) report an invalid position.
+    const bool sequentialOutput = mArchiveCreator.sequentialOutput() ||
+                                  outStream.tellp() == std::ostream::pos_type{ -1 };
+    if ( !sequentialOutput ) {
+        const auto newArc = initOutArchive();
+        const auto outStdStream = bit7z::make_com< CStdOutStream, IOutStream >( outStream );
+        const auto updateCallback = bit7z::make_com< UpdateCallback >( *this );
+        compressOut( newArc, outStdStream, updateCallback );
+        return;
+    }
+
+    if ( !mArchiveCreator.compressionFormat().hasFeature( FormatFeatures::SequentialOutput ) ) {
+        throw BitException( "Cannot compress to a sequential output stream",
+                            make_error_code( BitError::FormatFeatureNotSupported ) );
+    }
+
     const auto newArc = initOutArchive();
-    const auto outStdStream = bit7z::make_com< CStdOutStream, IOutStream >( outStream );
+    const auto outSequentialStream = bit7z::make_com< CStdSequentialOutStream, ISequentialOutStream >( outStream );
     const auto updateCallback = bit7z::make_com< UpdateCallback >( *this );
-    compressOut( newArc, outStdStream, updateCallback );
+    compressOut( newArc, outSequentialStream, updateCallback );
 }
 
 void BitOutputArchive::setArchiveProperties( IOutArchive* outArchive ) const {
-    const ArchiveProperties properties = mArchiveCreator.archiveProperties();
+    ArchiveProperties properties = mArchiveCreator.archiveProperties();
+    if ( mStoreNewItems ) {
+        // Note: the last value of a property overrides the previous ones, including the ones set by the user.
+        // When no method is specified, 7-Zip uses the Copy method (7z) or stores the files (zip) at level 0.
+        properties.setProperty( L"x", 0u );
+        const auto& format = mArchiveCreator.compressionFormat();
+        if ( mArchiveCreator.compressionMethod() != format.defaultMethod() ) {
+            properties.setProperty( format == BitFormat::SevenZip ? L"0" : L"m", L"Copy" );
+        }
+    }
     if ( properties.empty() ) {
         return;
     }
@@ -356,46 +781,373 @@ void BitOutputArchive::setArchiveProperties( IOutArchive* outArchive ) const {
 }
 
 void BitOutputArchive::updateInputIndices() {
-    if ( mDeletedItems.empty() ) {
+    const bool sortItems = mArchiveCreator.sortStrategy() == SortStrategy::ByType && newItemsCount() > 1;
+    if ( mDeletedItems.empty() && !sortItems ) {
+        mInputIndices.clear();
         return;
     }
 
-    std::uint32_t offset = 0;
-    for ( std::uint32_t newIndex = 0; newIndex < itemsCount(); ++newIndex ) {
-        for ( auto it = mDeletedItems.find( newIndex + offset );
-              it != mDeletedItems.end() && *it == newIndex + offset;
-              ++it ) {
-            ++offset;
+    // Since the deleted indices are sorted, we can skip them while walking the input indices, in a single pass.
+    const auto newItemsCount = itemsCount();
+    mInputIndices.clear();
+    mInputIndices.reserve( newItemsCount );
+
+    auto deletedIndex = mDeletedItems.cbegin();
+    std::uint32_t inputIndex = 0;
+    for ( std::uint32_t newIndex = 0; newIndex < newItemsCount; ++newIndex, ++inputIndex ) {
+        while ( deletedIndex != mDeletedItems.cend() && *deletedIndex == inputIndex ) {
+            ++deletedIndex;
+            ++inputIndex;
+        }
+        mInputIndices.push_back( static_cast< InputIndex >( inputIndex ) );
+    }
+
+    if ( sortItems ) {
+        sortNewItems();
+    }
+}
+
+void BitOutputArchive::sortNewItems() {
+    // Note: the items kept from the input archive precede the new ones, and they are not sorted.
+    const auto firstNewItem = std::find_if(
+        mInputIndices.begin(),
+        mInputIndices.end(),
+        [this]( InputIndex index ) -> bool {
+            return static_cast< std::uint32_t >( index ) >= mInputArchiveItemsCount;
+        }
+    );
+
+    std::vector< ItemSortKey > sortKeys;
+    sortKeys.reserve( static_cast< std::size_t >( mInputIndices.end() - firstNewItem ) );
+    for ( auto index = firstNewItem; index != mInputIndices.end(); ++index ) {
+        const bool isDir = itemProperty( *index, BitProperty::IsDir ).getBool();
+        const auto path = itemProperty( *index, BitProperty::Path ).getString();
+        const auto size = isDir ? BitPropVariant{} : itemProperty( *index, BitProperty::Size );
+        sortKeys.push_back( makeSortKey( *index, isDir, path, size.isUInt64() ? size.getUInt64() : 0 ) );
+    }
+
+    std::stable_sort( sortKeys.begin(), sortKeys.end(), compareByType );
+    std::transform( sortKeys.cbegin(), sortKeys.cend(), firstNewItem, []( const ItemSortKey& key ) -> InputIndex {
+        return key.index;
+    } );
+}
+
+void BitOutputArchive::probeCompressibility() {
+    mIncompressibleItems.clear();
+    mStoreNewItems = false;
+    if ( !mArchiveCreator.storeIncompressibleFiles() ) {
+        return;
+    }
+
+    /* The new items can be stored without compression only if all of them are incompressible files:
+     * 7-Zip uses the same methods for all the new items, so we cannot choose a method for each item.
+     * Note: the items of the input sources are produced only during the compression, so they are not probed. */
+    bool allIncompressible = sourcesItemsCount() == 0;
+    const auto probedItemsCount = storedItemsCount() + mNewItems.size();
+    for ( std::size_t newItemIndex = 0; newItemIndex < probedItemsCount; ++newItemIndex ) {
+        const auto inputIndex = static_cast< InputIndex >( mInputArchiveItemsCount + newItemIndex );
+        try {
+            const auto filePath = newItemFilePath( newItemIndex );
+            if ( filePath.empty() ) {
+                // Directories have no content to compress; any other kind of item is considered compressible.
+                allIncompressible = allIncompressible && itemProperty( inputIndex, BitProperty::IsDir ).getBool();
+                continue;
+            }
+
+            if ( hasIncompressibleExtension( filePath ) ) {
+                mIncompressibleItems.push_back( { to_tstring( filePath ), IncompressibleReason::Extension, false } );
+            } else if ( hasIncompressibleContent( filePath ) ) {
+                mIncompressibleItems.push_back( { to_tstring( filePath ), IncompressibleReason::HighEntropy, false } );
+            } else {
+                allIncompressible = false;
+            }
+        } catch ( const BitException& ) {
+            // The compression will report the error as usual.
+            allIncompressible = false;
+        }
+    }
+
+    const auto& format = mArchiveCreator.compressionFormat();
+    // Note: the dictionary and word sizes are method-specific, so they cannot be used with the Copy method.
+    mStoreNewItems = allIncompressible && !mIncompressibleItems.empty() &&
+                     format.hasFeature( FormatFeatures::MultipleMethods ) &&
+                     format.hasFeature( FormatFeatures::CompressionLevel ) &&
+                     mArchiveCreator.dictionarySize() == 0 && mArchiveCreator.wordSize() == 0;
+    for ( auto& item : mIncompressibleItems ) {
+        item.stored = mStoreNewItems;
+    }
+}
+
+void BitOutputArchive::findDuplicateItems() {
+    // Only the files having the same size as some other file might be duplicates, so we hash only those.
+    // Note: the items of the input sources are not considered, as they are produced only during the compression.
+    // The items are visited in output order, so that the first copy of some content precedes its duplicates.
+    std::unordered_map< std::uint64_t, std::vector< std::uint32_t > > sameSizeFiles;
+    const auto candidatesEnd = mInputArchiveItemsCount + storedItemsCount() + mNewItems.size();
+    const auto outputItemsCount = itemsCount();
+    for ( std::uint32_t index = 0; index < outputItemsCount; ++index ) {
+        const auto inputIndex = static_cast< std::uint32_t >( itemInputIndex( index ) );
+        if ( inputIndex < mInputArchiveItemsCount || inputIndex >= candidatesEnd ) {
+            continue;
+        }
+        try {
+            if ( newItemFilePath( inputIndex - mInputArchiveItemsCount ).empty() ) {
+                continue;
+            }
+            const auto fileSize = itemProperty( static_cast< InputIndex >( inputIndex ), BitProperty::Size );
+            if ( fileSize.isUInt64() && fileSize.getUInt64() > 0 ) {
+                sameSizeFiles[ fileSize.getUInt64() ].push_back( inputIndex );
+            }
+        } catch ( const BitException& ) {
+            // The file is not deduplicated, and the compression will report the error as usual.
+        }
+    }
+
+    for ( const auto& sizeGroup : sameSizeFiles ) {
+        const auto& files = sizeGroup.second;
+        if ( files.size() < 2 ) {
+            continue;
+        }
+
+        // The first copies of each distinct content, grouped by their hash.
+        std::unordered_map< ContentHash, std::vector< std::uint32_t >, ContentHashHasher > firstCopies;
+        for ( const auto inputIndex : files ) {
+            try {
+                const auto filePath = newItemFilePath( inputIndex - mInputArchiveItemsCount );
+                auto& sameHashFiles = firstCopies[ hashFileContent( filePath ) ];
+
+                // Note: the hash is not collision-resistant, so files with the same hash are also compared bytewise.
+                const auto firstCopy = std::find_if(
+                    sameHashFiles.cbegin(),
+                    sameHashFiles.cend(),
+                    [ this, &filePath ]( std::uint32_t candidate ) -> bool {
+                        return isSameFileContent( newItemFilePath( candidate - mInputArchiveItemsCount ), filePath );
+                    }
+                );
+                if ( firstCopy != sameHashFiles.cend() ) {
+                    mDuplicateItems.emplace( inputIndex, *firstCopy );
+                } else {
+                    sameHashFiles.push_back( inputIndex );
+                }
+            } catch ( const BitException& ) {
+                // As above, the compression will report the error.
+            }
+        }
+    }
+}
+
+void BitOutputArchive::groupDuplicateItems() {
+    if ( mInputIndices.empty() ) {
+        const auto outputItemsCount = itemsCount();
+        mInputIndices.reserve( outputItemsCount );
+        for ( std::uint32_t index = 0; index < outputItemsCount; ++index ) {
+            mInputIndices.push_back( static_cast< InputIndex >( index ) );
+        }
+    }
+
+    // Each duplicate is moved right after the first copy of its content; the order of the other items is kept.
+    std::unordered_map< std::uint32_t, std::vector< InputIndex > > duplicatesOf;
+    for ( const auto inputIndex : mInputIndices ) {
+        const auto* firstCopy = duplicatedItem( inputIndex );
+        if ( firstCopy != nullptr ) {
+            duplicatesOf[ *firstCopy ].push_back( inputIndex );
+        }
+    }
+
+    std::vector< InputIndex > groupedIndices;
+    groupedIndices.reserve( mInputIndices.size() );
+    for ( const auto inputIndex : mInputIndices ) {
+        if ( duplicatedItem( inputIndex ) != nullptr ) {
+            continue;
+        }
+        groupedIndices.push_back( inputIndex );
+
+        const auto duplicates = duplicatesOf.find( static_cast< std::uint32_t >( inputIndex ) );
+        if ( duplicates != duplicatesOf.cend() ) {
+            groupedIndices.insert( groupedIndices.end(), duplicates->second.cbegin(), duplicates->second.cend() );
         }
-        mInputIndices.push_back( static_cast< InputIndex >( newIndex + offset ) );
     }
+    mInputIndices = std::move( groupedIndices );
+}
+
+auto BitOutputArchive::linksDuplicateItems() const -> bool {
+#ifdef BIT7Z_BUILD_FOR_P7ZIP
+    return false; // p7zip's tar handler does not support storing hard links.
+#else
+    return mArchiveCreator.compressionFormat() == BitFormat::Tar;
+#endif
+}
+
+auto BitOutputArchive::duplicatedItem( InputIndex index ) const -> const std::uint32_t* {
+    const auto duplicate = mDuplicateItems.find( static_cast< std::uint32_t >( index ) );
+    return duplicate != mDuplicateItems.cend() ? &duplicate->second : nullptr;
+}
+
+auto BitOutputArchive::newItemFilePath( std::size_t newItemIndex ) const -> native_string {
+    if ( newItemIndex < storedItemsCount() ) {
+        return mItemsStore->regularFilePath( newItemIndex );
+    }
+
+    const auto& item = newItem( newItemIndex );
+    if ( item.mProperties.inputType != detail::InputItemType::Filesystem ) {
+        return {};
+    }
+    item.loadMetadata();
+    if ( item.isDir() || ( item.mFilesystemItem.symlinkPolicy == SymlinkPolicy::DoNotFollow && item.isSymLink() ) ) {
+        return {};
+    }
+    return item.path();
 }
 
 auto BitOutputArchive::itemsCount() const -> std::uint32_t {
-    auto result = static_cast< std::uint32_t >( mNewItems.size() );
-    if ( mInputArchive != nullptr ) {
-        result += mInputArchive->itemsCount() - static_cast< std::uint32_t >( mDeletedItems.size() );
+    auto result = static_cast< std::uint32_t >( newItemsCount() );
+    if ( hasInputArchive() ) {
+        result += mInputArchiveItemsCount - static_cast< std::uint32_t >( mDeletedItems.size() );
     }
     return result;
 }
 
 auto BitOutputArchive::itemProperty( InputIndex index, BitProperty property ) const -> BitPropVariant {
     const auto newItemIndex = static_cast< std::size_t >( index ) - static_cast< std::size_t >( mInputArchiveItemsCount );
-    const auto& newItem = mNewItems[ newItemIndex ];
-    return newItem.itemProperty( property );
+    if ( newItemIndex < storedItemsCount() ) {
+        return mItemsStore->itemProperty( newItemIndex, property );
+    }
+    return newItem( newItemIndex ).itemProperty( property );
 }
 
 auto BitOutputArchive::itemStream( InputIndex index, ISequentialInStream** inStream ) const -> HRESULT {
     const auto newItemIndex = static_cast< std::size_t >( index ) - static_cast< std::size_t >( mInputArchiveItemsCount );
-    const auto& newItem = mNewItems[ newItemIndex ];
+    const auto storeOpenFiles = mArchiveCreator.storeOpenFiles();
+    const auto readBufferSize = mArchiveCreator.readBufferSize();
+    if ( newItemIndex < storedItemsCount() ) {
+        const HRESULT res = mItemsStore->itemStream( newItemIndex, inStream, storeOpenFiles, readBufferSize );
+        if ( FAILED( res ) ) {
+            mFailedFiles.emplace_back( to_tstring( mItemsStore->itemPath( newItemIndex ) ), make_hresult_code( res ) );
+        }
+        return res;
+    }
+
+    const auto& item = newItem( newItemIndex );
 
-    const HRESULT res = newItem.getStream( inStream, mArchiveCreator.storeOpenFiles() );
+    const HRESULT res = item.getStream( inStream, storeOpenFiles, readBufferSize );
     if ( FAILED( res ) ) {
-        mFailedFiles.emplace_back( to_tstring( newItem.path() ), make_hresult_code( res ) );
+        mFailedFiles.emplace_back( to_tstring( item.path() ), make_hresult_code( res ) );
     }
     return res;
 }
 
+void BitOutputArchive::storeNewItems() {
+    // Note: this is called whenever new items are added, which shifts the indices of the sources' items.
+    resetSourceItem();
+    if ( mNewItems.empty() ) {
+        return;
+    }
+    if ( mItemsStore == nullptr ) {
+        mItemsStore = std::make_unique< InputItemsStore >();
+    }
+    mItemsStore->append( mNewItems );
+}
+
+auto BitOutputArchive::storedItemsCount() const noexcept -> std::size_t {
+    return mItemsStore != nullptr ? mItemsStore->size() : 0;
+}
+
+auto BitOutputArchive::newItemsCount() const -> std::size_t {
+    return storedItemsCount() + mNewItems.size() + sourcesItemsCount();
+}
+
+auto BitOutputArchive::hasNewItems() const -> bool {
+    return newItemsCount() > 0;
+}
+
+auto BitOutputArchive::hasEditedItems() const noexcept -> bool {
+    return false;
+}
+
+auto BitOutputArchive::inputArchive() const -> BitInputArchive* {
+    if ( mInputArchive == nullptr && !mDeferredInputArchivePath.empty() ) {
+        mInputArchive = std::make_unique< BitInputArchive >(
+            mArchiveCreator,
+            mDeferredInputArchivePath,
+            ArchiveStartOffset::FileStart
+        );
+        mDeferredInputArchivePath.clear();
+    }
+    return mInputArchive.get();
+}
+
+auto BitOutputArchive::inputArchivePath() const -> tstring {
+    return mInputArchive != nullptr ? mInputArchive->archivePath() : mDeferredInputArchivePath;
+}
+
+void BitOutputArchive::setInputArchive( std::unique_ptr< BitInputArchive >&& inputArchive ) {
+    discardChanges();
+    mInputArchive = std::move( inputArchive );
+    mDeferredInputArchivePath.clear();
+    mInputArchiveItemsCount = mInputArchive != nullptr ? mInputArchive->itemsCount() : 0;
+}
+
+void BitOutputArchive::setDeferredInputArchive( const tstring& archivePath ) {
+    const auto writtenItemsCount = itemsCount();
+    discardChanges();
+    mInputArchive.reset();
+    mDeferredInputArchivePath = archivePath;
+    mInputArchiveItemsCount = writtenItemsCount;
+}
+
+auto BitOutputArchive::hasInputArchive() const noexcept -> bool {
+    return mInputArchive != nullptr || !mDeferredInputArchivePath.empty();
+}
+
+void BitOutputArchive::discardChanges() {
+    mItemsStore.reset();
+    mNewItems.clear();
+    mInputSources.clear();
+    mDeletedItems.clear();
+    mDuplicateItems.clear();
+    resetSourceItem();
+    mFailedFiles.clear();
+    mInputIndices.clear();
+}
+
+auto BitOutputArchive::sourcesItemsCount() const -> std::uint32_t {
+    std::uint32_t result = 0;
+    for ( const auto& inputSource : mInputSources ) {
+        result += inputSource.get().itemsCount();
+    }
+    return result;
+}
+
+auto BitOutputArchive::newItem( std::size_t newItemIndex ) const -> const BitInputItem& {
+    const auto pendingItemIndex = newItemIndex - storedItemsCount();
+    if ( pendingItemIndex < mNewItems.size() ) {
+        return mNewItems[ pendingItemIndex ];
+    }
+
+    if ( mSourceItem != nullptr && mSourceItemIndex == newItemIndex ) {
+        return *mSourceItem;
+    }
+
+    auto sourceItemIndex = pendingItemIndex - mNewItems.size();
+    for ( const auto& inputSource : mInputSources ) {
+        const auto sourceItemsCount = inputSource.get().itemsCount();
+        if ( sourceItemIndex < sourceItemsCount ) {
+            mSourceItem = std::make_unique< BitInputItem >(
+                inputSource.get().item( static_cast< std::uint32_t >( sourceItemIndex ) )
+            );
+            mSourceItemIndex = newItemIndex;
+            return *mSourceItem;
+        }
+        sourceItemIndex -= sourceItemsCount;
+    }
+    throw BitException( "Invalid item index", std::make_error_code( std::errc::invalid_argument ) );
+}
+
+void BitOutputArchive::resetSourceItem() noexcept {
+    mSourceItem.reset();
+    mSourceItemIndex = 0;
+}
+
 auto BitOutputArchive::hasNewData( std::uint32_t index ) const noexcept -> bool {
     const auto originalIndex = static_cast< std::uint32_t >( itemInputIndex( index ) );
     return originalIndex >= mInputArchiveItemsCount;
@@ -418,11 +1170,26 @@ auto BitOutputArchive::itemInputIndex( std::uint32_t newIndex ) const noexcept -
 
 auto BitOutputArchive::outputItemProperty( std::uint32_t index, BitProperty property ) const -> BitPropVariant {
     const auto mappedIndex = itemInputIndex( index );
+    if ( !mDuplicateItems.empty() && ( property == BitProperty::HardLink || property == BitProperty::Size ) &&
+         linksDuplicateItems() ) {
+        const auto* firstCopy = duplicatedItem( mappedIndex );
+        if ( firstCopy != nullptr ) { // The duplicate is stored as a hard link (with no data) to the first copy.
+            if ( property == BitProperty::HardLink ) {
+                return itemProperty( static_cast< InputIndex >( *firstCopy ), BitProperty::Path );
+            }
+            return BitPropVariant{ static_cast< std::uint64_t >( 0 ) };
+        }
+    }
     return itemProperty( mappedIndex, property );
 }
 
 auto BitOutputArchive::outputItemStream( std::uint32_t index, ISequentialInStream** inStream ) const -> HRESULT {
     const auto mappedIndex = itemInputIndex( index );
+    if ( !mDuplicateItems.empty() && linksDuplicateItems() && duplicatedItem( mappedIndex ) != nullptr ) {
+        auto linkStream = bit7z::make_com< CBufferInStream, ISequentialInStream >( kHardLinkContent );
+        *inStream = linkStream.Detach();
+        return S_OK;
+    }
     return itemStream( mappedIndex, inStream );
 }
 
@@ -431,6 +1198,10 @@ auto BitOutputArchive::indexInArchive( std::uint32_t index ) const noexcept -> s
     return originalIndex < mInputArchiveItemsCount ? originalIndex : static_cast< std::uint32_t >( -1 );
 }
 
+auto BitOutputArchive::incompressibleItems() const noexcept -> const std::vector< IncompressibleItem >& {
+    return mIncompressibleItems;
+}
+
 auto BitOutputArchive::handler() const noexcept -> const BitAbstractArchiveHandler& {
     return mArchiveCreator;
 }
@@ -0,0 +1,137 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "bitsegmentedbuffer.hpp"
+
+#include "biterror.hpp"
+#include "bitexception.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+
+namespace bit7z {
+
+BitSegmentedBuffer::BitSegmentedBuffer( std::size_t segmentSize ) : mSegmentSize{ segmentSize }, mSize{ 0 } {
+    if ( segmentSize == 0 ) {
+        throw BitException( "Could not create the segmented buffer",
+                            make_error_code( BitError::InvalidOutputBufferSize ) );
+    }
+}
+
+auto BitSegmentedBuffer::segmentSize() const noexcept -> std::size_t {
+    return mSegmentSize;
+}
+
+auto BitSegmentedBuffer::size() const noexcept -> std::uint64_t {
+    return mSize;
+}
+
+auto BitSegmentedBuffer::empty() const noexcept -> bool {
+    return mSize == 0;
+}
+
+void BitSegmentedBuffer::clear() noexcept {
+    mSegments.clear();
+    mSize = 0;
+}
+
+void BitSegmentedBuffer::resize( std::uint64_t newSize ) {
+    const std::uint64_t segmentsCount = ( newSize / mSegmentSize ) + ( newSize % mSegmentSize != 0 ? 1 : 0 );
+    if ( segmentsCount > std::numeric_limits< std::size_t >::max() ) {
+        throw std::bad_alloc();
+    }
+
+    if ( newSize > mSize && !mSegments.empty() ) {
+        // The last segment might contain stale bytes past the old size (e.g., after a previous shrinking).
+        const auto lastSegmentUsed = static_cast< std::size_t >( mSize - ( mSegments.size() - 1 ) * mSegmentSize );
+        const auto lastSegmentEnd = std::min< std::uint64_t >( newSize - mSize + lastSegmentUsed, mSegmentSize );
+        auto& lastSegment = mSegments.back();
+        std::fill( lastSegment.begin() + static_cast< index_t >( lastSegmentUsed ),
+                   lastSegment.begin() + static_cast< index_t >( lastSegmentEnd ),
+                   byte_t{ 0 } );
+    }
+
+    // Note: new segments are allocated one by one, so that the already allocated ones are never copied.
+    mSegments.reserve( static_cast< std::size_t >( segmentsCount ) );
+    while ( mSegments.size() < segmentsCount ) {
+        mSegments.emplace_back( mSegmentSize );
+    }
+    mSegments.resize( static_cast< std::size_t >( segmentsCount ) );
+    mSize = newSize;
+}
+
+void BitSegmentedBuffer::write( std::uint64_t offset, const byte_t* data, std::size_t size ) {
+    if ( size == 0 ) {
+        return;
+    }
+
+    const std::uint64_t endOffset = offset + size;
+    if ( endOffset < offset ) {
+        throw std::bad_alloc();
+    }
+    if ( endOffset > mSize ) {
+        resize( endOffset );
+    }
+
+    while ( size > 0 ) {
+        auto& segment = mSegments[ static_cast< std::size_t >( offset / mSegmentSize ) ];
+        const auto segmentOffset = static_cast< std::size_t >( offset % mSegmentSize );
+        const auto bytesToCopy = std::min( size, mSegmentSize - segmentOffset );
+        std::memcpy( &segment[ segmentOffset ], data, bytesToCopy );
+        data += bytesToCopy; // NOLINT(*-pointer-arithmetic)
+        size -= bytesToCopy;
+        offset += bytesToCopy;
+    }
+}
+
+auto BitSegmentedBuffer::read( std::uint64_t offset, byte_t* data, std::size_t size ) const -> std::size_t {
+    if ( offset >= mSize ) {
+        return 0;
+    }
+
+    const auto bytesToRead = static_cast< std::size_t >( std::min< std::uint64_t >( size, mSize - offset ) );
+    std::size_t bytesRead = 0;
+    while ( bytesRead < bytesToRead ) {
+        const auto& segment = mSegments[ static_cast< std::size_t >( offset / mSegmentSize ) ];
+        const auto segmentOffset = static_cast< std::size_t >( offset % mSegmentSize );
+        const auto bytesToCopy = std::min( bytesToRead - bytesRead, mSegmentSize - segmentOffset );
+        std::memcpy( data + bytesRead, &segment[ segmentOffset ], bytesToCopy ); // NOLINT(*-pointer-arithmetic)
+        bytesRead += bytesToCopy;
+        offset += bytesToCopy;
+    }
+    return bytesRead;
+}
+
+auto BitSegmentedBuffer::segments() const -> std::vector< BitBufferSegment > {
+    std::vector< BitBufferSegment > result;
+    result.reserve( mSegments.size() );
+    std::uint64_t remainingSize = mSize;
+    for ( const auto& segment : mSegments ) {
+        const auto segmentSize = static_cast< std::size_t >( std::min< std::uint64_t >( remainingSize, mSegmentSize ) );
+        result.push_back( { segment.data(), segmentSize } );
+        remainingSize -= segmentSize;
+    }
+    return result;
+}
+
+auto BitSegmentedBuffer::toBuffer() const -> buffer_t {
+    buffer_t result;
+    result.reserve( static_cast< std::size_t >( mSize ) );
+    for ( const auto& segment : segments() ) {
+        result.insert( result.end(), segment.data, segment.data + segment.size ); // NOLINT(*-pointer-arithmetic)
+    }
+    return result;
+}
+
+} // namespace bit7z
@@ -0,0 +1,35 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "bitvolumehandles.hpp"
+
+#include "internal/volumehandlesbudget.hpp"
+
+namespace bit7z {
+
+auto volumeHandlesStats() -> VolumeHandlesStats {
+#ifdef _WIN32
+    return { 0, 0, 0, 0 };
+#else
+    return VolumeHandlesBudget::instance().statistics();
+#endif
+}
+
+void setMaxVolumeHandles( std::size_t maxHandles ) {
+#ifdef _WIN32
+    ( void )maxHandles;
+#else
+    VolumeHandlesBudget::instance().setMaxOpenHandles( maxHandles );
+#endif
+}
+
+} // namespace bit7z
@@ -68,6 +68,7 @@ class ArchiveProperties final {
         }
 
         friend class BitAbstractArchiveCreator;
+        friend class BitOutputArchive;
 };
 
 } // namespace bit7z
@@ -26,14 +26,14 @@ namespace {
 /* Opens a CFileOutStream at "<target>.tmp", retrying with numeric postfixes
  * "<target>.tmp1", ".tmp2", ... on collision.
  * Mirrors 7-Zip's retry-on-collision behavior (1 + 65535 retries). */
-auto openUniqueTempStream( const fs::path& targetPath ) -> CMyComPtr< CFileOutStream > {
+auto openUniqueTempStream( const fs::path& targetPath, std::uint32_t writeBufferSize ) -> CMyComPtr< CFileOutStream > {
     constexpr auto kMaxTempPathRetries = std::numeric_limits< std::uint16_t >::max();
     fs::path tmpCandidatePath = targetPath;
     tmpCandidatePath += BIT7Z_NATIVE_STRING( ".tmp" );
     std::uint32_t tempIndex = 0u; // Note: wider than kMaxTempPathRetries so that we can detect when we pass the limit.
     do {
         try {
-            return make_com< CFileOutStream >( tmpCandidatePath );
+            return make_com< CFileOutStream >( tmpCandidatePath, FileFlag::CreateNew, writeBufferSize );
         } catch ( const BitException& exception ) {
             if ( exception.code() != std::errc::file_exists ) {
                 throw;
@@ -52,15 +52,24 @@ auto openUniqueTempStream( const fs::path& targetPath ) -> CMyComPtr< CFileOutSt
 }
 } // namespace
 
-AtomicFileReplacer::AtomicFileReplacer( const fs::path& targetPath )
+AtomicFileReplacer::AtomicFileReplacer( const fs::path& targetPath, std::uint32_t writeBufferSize )
     : mTargetPath{ targetPath },
-      mStream{ openUniqueTempStream( targetPath ) } {}
+      mStream{ openUniqueTempStream( targetPath, writeBufferSize ) } {}
 
 auto AtomicFileReplacer::stream() const noexcept -> IOutStream* {
     return mStream;
 }
 
 void AtomicFileReplacer::commit() {
+    const auto flushResult = mStream->flush();
+    if ( flushResult != S_OK ) {
+        throw BitException(
+            "Failed to write the temporary archive file",
+            make_hresult_code( flushResult ),
+            pathToTstring( mStream->path() )
+        );
+    }
+
     // We need to save the temp file path before releasing the stream object.
     const fs::path tempPath = std::move( *mStream ).path();
 
@@ -21,7 +21,7 @@ namespace bit7z {
  */
 class AtomicFileReplacer final {
     public:
-        explicit AtomicFileReplacer( const fs::path& targetPath );
+        explicit AtomicFileReplacer( const fs::path& targetPath, std::uint32_t writeBufferSize = 0 );
 
         AtomicFileReplacer( const AtomicFileReplacer& ) = delete;
 
@@ -40,7 +40,7 @@ class AtomicFileReplacer final {
         BIT7Z_NODISCARD auto stream() const noexcept -> IOutStream*;
 
         /**
-         * @brief Releases the underlying stream (closing the temporary file)
+         * @brief Writes any buffered data, releases the underlying stream (closing the temporary file),
          *        and renames it onto the target path, overwriting any existing destination.
          * @throws BitException on failure.
          */
@@ -16,17 +16,35 @@
 
 namespace bit7z {
 
-BufferQueue::BufferQueue( std::uint64_t maxMemoryUsage ) : mMemoryUsage{ 0 }, mMaxMemoryUsage{ maxMemoryUsage } {}
+namespace {
+// A side of the queue is considered stalling if it waited for at least 1/kStallRatio of the sizing window.
+constexpr auto kStallRatio = 10;
+} // namespace
+
+BufferQueue::BufferQueue( std::uint64_t maxMemoryUsage )
+    : mMemoryUsage{ 0 },
+      mMaxMemoryUsage{ maxMemoryUsage },
+      mMinAdaptiveLimit{ maxMemoryUsage },
+      mMaxAdaptiveLimit{ maxMemoryUsage },
+      mWindowPushedBytes{ 0 },
+      mWindowPeakUsage{ 0 },
+      mMetrics{} {
+    resetWindow();
+}
 
 auto BufferQueue::pop() -> buffer_t {
     std::unique_lock< std::mutex > lock( mMutex );
-    mEmptyCondition.wait(
-        lock,
-        [ this ]() -> bool {
-            return !mQueue.empty() || mFinished;
-        }
-    );
-    if ( mQueue.empty() && mFinished ) {
+    const auto hasData = [ this ]() -> bool {
+        return !mQueue.empty() || mFinished || mCancelled;
+    };
+    if ( !hasData() ) {
+        const auto stallStart = std::chrono::steady_clock::now();
+        mEmptyCondition.wait( lock, hasData );
+        const auto stallTime = std::chrono::steady_clock::now() - stallStart;
+        mWindowConsumerStall += stallTime;
+        mMetrics.consumerStallTime += stallTime;
+    }
+    if ( mCancelled || ( mQueue.empty() && mFinished ) ) {
         return {};
     }
     buffer_t value{ std::move( mQueue.front() ) };
@@ -36,17 +54,32 @@ auto BufferQueue::pop() -> buffer_t {
     return value;
 }
 
-void BufferQueue::push( buffer_t&& item ) {
+auto BufferQueue::push( buffer_t&& item ) -> bool {
     std::unique_lock< std::mutex > lock( mMutex );
-    mFullCondition.wait(
-        lock,
-        [ this, &item ]() -> bool {
-            return mMemoryUsage + item.size() < mMaxMemoryUsage;
-        }
-    );
+    const auto hasRoom = [ this, &item ]() -> bool {
+        // Note: an empty queue always accepts a buffer, even if it is larger than the memory limit.
+        return mCancelled || mQueue.empty() || mMemoryUsage + item.size() < mMaxMemoryUsage;
+    };
+    if ( !hasRoom() ) {
+        const auto stallStart = std::chrono::steady_clock::now();
+        mFullCondition.wait( lock, hasRoom );
+        const auto stallTime = std::chrono::steady_clock::now() - stallStart;
+        mWindowProducerStall += stallTime;
+        mMetrics.producerStallTime += stallTime;
+    }
+    if ( mCancelled ) {
+        return false;
+    }
     mMemoryUsage += item.size();
+    mWindowPushedBytes += item.size();
+    mWindowPeakUsage = std::max< std::uint64_t >( mWindowPeakUsage, mMemoryUsage );
+    mMetrics.peakMemoryUsage = std::max< std::uint64_t >( mMetrics.peakMemoryUsage, mMemoryUsage );
     mQueue.push( std::move( item ) );
+    if ( isAdaptive() && mWindowPushedBytes >= mMaxMemoryUsage ) {
+        adaptMemoryLimit();
+    }
     mEmptyCondition.notify_one();
+    return true;
 }
 
 void BufferQueue::notifyFinished() {
@@ -55,6 +88,13 @@ void BufferQueue::notifyFinished() {
     mEmptyCondition.notify_one();
 }
 
+void BufferQueue::cancel() {
+    const std::lock_guard< std::mutex > lock( mMutex );
+    mCancelled = true;
+    mEmptyCondition.notify_all();
+    mFullCondition.notify_all();
+}
+
 void BufferQueue::reset() {
     mFinished = false;
 }
@@ -64,4 +104,61 @@ auto BufferQueue::empty() const -> bool {
     return mQueue.empty();
 }
 
+auto BufferQueue::cancelled() const -> bool {
+    return mCancelled;
+}
+
+void BufferQueue::setAdaptiveLimits( std::uint64_t minMemoryUsage, std::uint64_t maxMemoryUsage ) {
+    const std::lock_guard< std::mutex > lock( mMutex );
+    mMinAdaptiveLimit = minMemoryUsage;
+    mMaxAdaptiveLimit = std::max( minMemoryUsage, maxMemoryUsage );
+    mMaxMemoryUsage = std::min( std::max( mMaxMemoryUsage, mMinAdaptiveLimit ), mMaxAdaptiveLimit );
+    resetWindow();
+    mFullCondition.notify_all();
+}
+
+auto BufferQueue::metrics() const -> BufferingMetrics {
+    const std::lock_guard< std::mutex > lock( mMutex );
+    BufferingMetrics result = mMetrics;
+    result.memoryLimit = mMaxMemoryUsage;
+    return result;
+}
+
+auto BufferQueue::isAdaptive() const -> bool {
+    return mMinAdaptiveLimit < mMaxAdaptiveLimit;
+}
+
+void BufferQueue::resetWindow() {
+    mWindowStart = std::chrono::steady_clock::now();
+    mWindowPushedBytes = 0;
+    mWindowPeakUsage = mMemoryUsage;
+    mWindowProducerStall = std::chrono::nanoseconds::zero();
+    mWindowConsumerStall = std::chrono::nanoseconds::zero();
+}
+
+void BufferQueue::adaptMemoryLimit() {
+    const auto windowTime = std::chrono::steady_clock::now() - mWindowStart;
+    const bool producerStalled = mWindowProducerStall * kStallRatio >= windowTime;
+    const bool consumerStalled = mWindowConsumerStall * kStallRatio >= windowTime;
+
+    if ( producerStalled && consumerStalled ) {
+        // Both sides waited for each other: the data comes in bursts that the queue cannot absorb.
+        const auto newLimit = std::min( mMaxMemoryUsage * 2, mMaxAdaptiveLimit );
+        if ( newLimit != mMaxMemoryUsage ) {
+            mMaxMemoryUsage = newLimit;
+            ++mMetrics.growCount;
+            mFullCondition.notify_all();
+        }
+    } else if ( producerStalled || mWindowPeakUsage < mMaxMemoryUsage / 4 ) {
+        // Either the consumer is the bottleneck (a larger queue would just stay full),
+        // or most of the queue is unused: in both cases, we can save some memory.
+        const auto newLimit = std::max( mMaxMemoryUsage / 2, mMinAdaptiveLimit );
+        if ( newLimit != mMaxMemoryUsage ) {
+            mMaxMemoryUsage = newLimit;
+            ++mMetrics.shrinkCount;
+        }
+    }
+    resetWindow();
+}
+
 } // namespace bit7z
@@ -10,9 +10,11 @@
 #ifndef BUFFERQUEUE_HPP
 #define BUFFERQUEUE_HPP
 
+#include "bitbufferingmetrics.hpp"
 #include "bittypes.hpp"
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <queue>
 #include <mutex>
@@ -35,22 +37,68 @@ class BufferQueue final {
 
         auto pop() -> buffer_t;
 
-        void push( buffer_t&& item );
+        /**
+         * @brief Pushes the given buffer into the queue, waiting until there is enough room for it.
+         *
+         * @return false if the queue was cancelled (i.e., the buffer will never be consumed), true otherwise.
+         */
+        auto push( buffer_t&& item ) -> bool;
 
         void notifyFinished();
 
+        /**
+         * @brief Cancels the queue, waking up both the producer and the consumer.
+         *
+         * After the cancellation, push() discards any buffer (returning false),
+         * while pop() returns an empty buffer.
+         */
+        void cancel();
+
         void reset();
 
         auto empty() const -> bool;
 
+        auto cancelled() const -> bool;
+
+        /**
+         * @brief Enables the adaptive sizing of the queue's memory limit, within the given bounds.
+         *
+         * Every time an amount of data equal to the current limit passes through the queue, the limit is:
+         *  - doubled, if both the producer and the consumer stalled, i.e., the data comes in bursts
+         *    that the queue cannot absorb;
+         *  - halved, if only the producer stalled (a larger queue would just stay full),
+         *    or if less than a quarter of the queue was used.
+         */
+        void setAdaptiveLimits( std::uint64_t minMemoryUsage, std::uint64_t maxMemoryUsage );
+
+        auto metrics() const -> BufferingMetrics;
+
     private:
         std::queue< buffer_t > mQueue;
         mutable std::mutex mMutex;
         std::condition_variable mEmptyCondition;
         std::condition_variable mFullCondition;
         std::atomic_bool mFinished{ false };
+        std::atomic_bool mCancelled{ false };
         std::atomic< std::uint64_t > mMemoryUsage;
         std::uint64_t mMaxMemoryUsage;
+
+        // Adaptive sizing (enabled only if the minimum limit is less than the maximum one).
+        std::uint64_t mMinAdaptiveLimit;
+        std::uint64_t mMaxAdaptiveLimit;
+        std::chrono::steady_clock::time_point mWindowStart;
+        std::uint64_t mWindowPushedBytes;
+        std::uint64_t mWindowPeakUsage;
+        std::chrono::nanoseconds mWindowProducerStall;
+        std::chrono::nanoseconds mWindowConsumerStall;
+
+        BufferingMetrics mMetrics;
+
+        auto isAdaptive() const -> bool;
+
+        void resetWindow();
+
+        void adaptMemoryLimit();
 };
 
 } // namespace bit7z
@@ -12,7 +12,6 @@
 
 #include "internal/bufferutil.hpp"
 
-#include "bittypes.hpp"
 #include "bitwindows.hpp"
 #include "internal/util.hpp"
 #include "internal/windows.hpp"
@@ -20,35 +19,31 @@
 #include <cstdint>
 
 auto bit7z::seek(
-    const buffer_t& buffer,
-    const buffer_t::const_iterator& currentPosition,
+    std::uint64_t size,
+    std::uint64_t currentPosition,
     std::int64_t offset,
     std::uint32_t seekOrigin,
     std::uint64_t& newPosition
 ) -> HRESULT {
-    std::uint64_t currentIndex{};
+    std::uint64_t seekPosition{};
     switch ( seekOrigin ) {
         case STREAM_SEEK_SET: {
             break;
         }
         case STREAM_SEEK_CUR: {
-            currentIndex = static_cast< std::uint64_t >( currentPosition - buffer.cbegin() );
+            seekPosition = currentPosition;
             break;
         }
         case STREAM_SEEK_END: {
-            currentIndex = static_cast< std::uint64_t >( buffer.cend() - buffer.cbegin() );
+            seekPosition = size;
             break;
         }
         default:
             return STG_E_INVALIDFUNCTION;
     }
 
-    RINOK( seekToOffset( currentIndex, offset ) ) //-V3504
+    RINOK( seekToOffset( seekPosition, offset ) ) //-V3504
 
-    if ( currentIndex > buffer.size() ) {
-        return E_INVALIDARG;
-    }
-
-    newPosition = currentIndex;
+    newPosition = seekPosition;
     return S_OK;
 }
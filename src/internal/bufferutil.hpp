@@ -10,16 +10,28 @@
 #ifndef BUFFERUTIL_HPP
 #define BUFFERUTIL_HPP
 
-#include "bittypes.hpp"
 #include "bitwindows.hpp"
 
 #include <cstdint>
 
 namespace bit7z {
 
+/**
+ * @brief Computes the position resulting from seeking a stream, as done by the Seek method of the 7-Zip streams.
+ *
+ * @note The new position might be past the end of the stream: the streams not supporting it must check it.
+ *
+ * @param size            the size of the stream (i.e., the base position of STREAM_SEEK_END seeks).
+ * @param currentPosition the current position in the stream (i.e., the base position of STREAM_SEEK_CUR seeks).
+ * @param offset          the offset to be added to the base position specified by the seek origin.
+ * @param seekOrigin      the seek origin (STREAM_SEEK_SET, STREAM_SEEK_CUR, or STREAM_SEEK_END).
+ * @param newPosition     the resulting position (set only on success).
+ *
+ * @return S_OK on success, or the error code of the failure (e.g., seeking before the beginning of the stream).
+ */
 auto seek(
-    const buffer_t& buffer,
-    const buffer_t::const_iterator& currentPosition,
+    std::uint64_t size,
+    std::uint64_t currentPosition,
     std::int64_t offset,
     std::uint32_t seekOrigin,
     std::uint64_t& newPosition
@@ -0,0 +1,91 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/cboundedbufferoutstream.hpp"
+
+#include "internal/bufferutil.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bit7z {
+
+CBoundedBufferOutStream::CBoundedBufferOutStream( byte_t* buffer, std::size_t capacity )
+    : mBuffer{ buffer }, mCapacity{ capacity }, mSize{ 0 }, mCurrentPosition{ 0 } {}
+
+auto CBoundedBufferOutStream::size() const noexcept -> std::uint64_t {
+    return mSize;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CBoundedBufferOutStream::SetSize( UInt64 newSize ) noexcept {
+    // Like for files, growing the stream fills the new range with zeros (as far as it fits the buffer).
+    if ( newSize > mSize && mSize < mCapacity ) {
+        const auto growthEnd = static_cast< std::size_t >( std::min< std::uint64_t >( newSize, mCapacity ) );
+        // NOLINTNEXTLINE(*-pointer-arithmetic)
+        std::fill( mBuffer + static_cast< std::size_t >( mSize ), mBuffer + growthEnd, byte_t{ 0 } );
+    }
+    mSize = newSize;
+    return S_OK;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CBoundedBufferOutStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
+    std::uint64_t seekIndex{};
+    RINOK( seek( mSize, mCurrentPosition, offset, seekOrigin, seekIndex ) ) //-V3504
+
+    mCurrentPosition = seekIndex;
+
+    if ( newPosition != nullptr ) {
+        *newPosition = seekIndex;
+    }
+
+    return S_OK;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CBoundedBufferOutStream::Write( const void* data, UInt32 size, UInt32* processedSize ) noexcept {
+    if ( processedSize != nullptr ) {
+        *processedSize = 0;
+    }
+
+    if ( data == nullptr || size == 0 ) {
+        return E_FAIL;
+    }
+
+    // Like for files, the gap left by seeking past the end is filled with zeros.
+    if ( mCurrentPosition > mSize && mSize < mCapacity ) {
+        const auto gapEnd = static_cast< std::size_t >( std::min< std::uint64_t >( mCurrentPosition, mCapacity ) );
+        // NOLINTNEXTLINE(*-pointer-arithmetic)
+        std::fill( mBuffer + static_cast< std::size_t >( mSize ), mBuffer + gapEnd, byte_t{ 0 } );
+    }
+
+    // Copying only the part of the data fitting the buffer; the rest is just accounted in the stream size.
+    if ( mCurrentPosition < mCapacity ) {
+        const auto bytesToCopy = static_cast< std::size_t >(
+            std::min< std::uint64_t >( size, mCapacity - mCurrentPosition )
+        );
+        // NOLINTNEXTLINE(*-pointer-arithmetic)
+        std::memcpy( mBuffer + static_cast< std::size_t >( mCurrentPosition ), data, bytesToCopy );
+    }
+
+    mCurrentPosition += size;
+    mSize = std::max( mSize, mCurrentPosition );
+
+    if ( processedSize != nullptr ) {
+        *processedSize = size;
+    }
+
+    return S_OK;
+}
+
+} // namespace bit7z
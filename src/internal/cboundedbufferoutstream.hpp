@@ -0,0 +1,69 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CBOUNDEDBUFFEROUTSTREAM_HPP
+#define CBOUNDEDBUFFEROUTSTREAM_HPP
+
+#include "bittypes.hpp"
+#include "internal/com.hpp"
+#include "internal/guids.hpp"
+#include "internal/macros.hpp"
+
+#include <7zip/IStream.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bit7z {
+
+/**
+ * An output stream writing to a caller-provided memory region of fixed capacity.
+ *
+ * Unlike CFixedBufferOutStream, writing past the capacity is not an error: the exceeding data is discarded,
+ * but the stream keeps track of the size it would have had, so that the caller can report the capacity needed.
+ */
+class CBoundedBufferOutStream final : public IOutStream, public CMyUnknownImp {
+    public:
+        CBoundedBufferOutStream( byte_t* buffer, std::size_t capacity );
+
+        CBoundedBufferOutStream( const CBoundedBufferOutStream& ) = delete;
+
+        CBoundedBufferOutStream( CBoundedBufferOutStream&& ) = delete;
+
+        auto operator=( const CBoundedBufferOutStream& ) -> CBoundedBufferOutStream& = delete;
+
+        auto operator=( CBoundedBufferOutStream&& ) -> CBoundedBufferOutStream& = delete;
+
+        MY_UNKNOWN_DESTRUCTOR( ~CBoundedBufferOutStream() ) = default;
+
+        /**
+         * @return the size of the data written to the stream, including the part exceeding the capacity.
+         */
+        BIT7Z_NODISCARD auto size() const noexcept -> std::uint64_t;
+
+        // IOutStream
+        BIT7Z_STDMETHOD( Write, const void* data, UInt32 size, UInt32* processedSize );
+
+        BIT7Z_STDMETHOD( Seek, Int64 offset, UInt32 seekOrigin, UInt64* newPosition );
+
+        BIT7Z_STDMETHOD( SetSize, UInt64 newSize );
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( IOutStream ) //-V2507 //-V2511 //-V835 //-V3504
+
+    private:
+        byte_t* mBuffer;
+        std::size_t mCapacity;
+        std::uint64_t mSize;
+        std::uint64_t mCurrentPosition;
+};
+
+} // namespace bit7z
+
+#endif // CBOUNDEDBUFFEROUTSTREAM_HPP
@@ -10,6 +10,7 @@
 #ifndef CBUFFERINSTREAM_HPP
 #define CBUFFERINSTREAM_HPP
 
+#include "bitbufferview.hpp"
 #include "bittypes.hpp"
 #include "internal/com.hpp"
 #include "internal/guids.hpp"
@@ -17,11 +18,13 @@
 
 #include <7zip/IStream.h>
 
+#include <cstddef>
+
 namespace bit7z {
 
 class CBufferInStream final : public IInStream, public CMyUnknownImp {
     public:
-        explicit CBufferInStream( const buffer_t& inBuffer );
+        explicit CBufferInStream( BitBufferView inBuffer );
 
         CBufferInStream( const CBufferInStream& ) = delete;
 
@@ -42,8 +45,8 @@ class CBufferInStream final : public IInStream, public CMyUnknownImp {
         MY_UNKNOWN_IMP1( IInStream ) //-V2507 //-V2511 //-V835 //-V3504
 
     private:
-        const buffer_t& mBuffer;
-        buffer_t::const_iterator mCurrentPosition;
+        BitBufferView mBuffer;
+        std::size_t mCurrentPosition;
 };
 
 } // namespace bit7z
@@ -38,11 +38,12 @@ STDMETHODIMP CBufferOutStream::SetSize( UInt64 newSize ) noexcept {
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CBufferOutStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
     std::uint64_t newIndex{};
-    const HRESULT res = seek( mBuffer, mCurrentPosition, offset, seekOrigin, newIndex );
+    const auto currentIndex = static_cast< std::uint64_t >( mCurrentPosition - mBuffer.begin() );
+    RINOK( seek( mBuffer.size(), currentIndex, offset, seekOrigin, newIndex ) ) //-V3504
 
-    if ( res != S_OK ) {
-        // We failed to seek (e.g., the new index would not be in the range [0, mBuffer.size]).
-        return res;
+    // Note: the new index must be in the range [0, mBuffer.size()].
+    if ( newIndex > mBuffer.size() ) {
+        return E_INVALIDARG;
     }
 
     // Note: newIndex can be equal to mBuffer.size(); in this case, mCurrentPosition == mBuffer.cend()
@@ -12,10 +12,26 @@
 
 #include "internal/cfileinstream.hpp"
 
+#include "internal/bufferutil.hpp"
+#include "internal/windows.hpp"
+
+#include <algorithm>
+#include <cstring>
+
 namespace bit7z {
 
-CFileInStream::CFileInStream( const native_string& filePath, bool storeOpenFiles )
-    : mFile{ filePath, storeOpenFiles } {}
+CFileInStream::CFileInStream( const native_string& filePath, bool storeOpenFiles, std::uint32_t bufferSize )
+    : mFile{ filePath, storeOpenFiles },
+      mBlockSize{ bufferSize },
+      mBufferOffset{ 0 },
+      mBufferedSize{ 0 },
+      mPosition{ 0 },
+      mFilePosition{ 0 } {
+    if ( mBlockSize > 0 ) {
+        mBuffer.resize( 2 * static_cast< std::size_t >( mBlockSize ) );
+        mFile.adviseSequentialAccess();
+    }
+}
 
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CFileInStream::Read( void* data, UInt32 size, UInt32* processedSize ) noexcept {
@@ -28,7 +44,9 @@ STDMETHODIMP CFileInStream::Read( void* data, UInt32 size, UInt32* processedSize
     }
 
     std::uint32_t totalBytesRead = 0;
-    const auto result = mFile.read( data, size, totalBytesRead );
+    const auto result = mBlockSize > 0
+        ? readBuffered( data, size, totalBytesRead )
+        : mFile.read( data, size, totalBytesRead );
     if ( processedSize != nullptr ) {
         *processedSize = totalBytesRead;
     }
@@ -38,11 +56,103 @@ STDMETHODIMP CFileInStream::Read( void* data, UInt32 size, UInt32* processedSize
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CFileInStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
     std::uint64_t finalPosition = 0;
-    const auto result = mFile.seek( static_cast< SeekOrigin >( seekOrigin ), offset, finalPosition );
+    const auto result = mBlockSize > 0
+        ? seekBuffered( offset, seekOrigin, finalPosition )
+        : mFile.seek( static_cast< SeekOrigin >( seekOrigin ), offset, finalPosition );
     if ( newPosition != nullptr ) {
         *newPosition = finalPosition;
     }
     return result;
 }
 
+auto CFileInStream::readBuffered( void* data, std::uint32_t size, std::uint32_t& processedSize ) noexcept -> HRESULT {
+    auto* output = static_cast< byte_t* >( data );
+    while ( size > 0 ) {
+        if ( mPosition >= mBufferOffset && mPosition - mBufferOffset < mBufferedSize ) {
+            const auto bufferIndex = static_cast< std::uint32_t >( mPosition - mBufferOffset );
+            const auto bytesToCopy = std::min( size, mBufferedSize - bufferIndex );
+            std::memcpy( output, &mBuffer[ bufferIndex ], bytesToCopy );
+            output += bytesToCopy; // NOLINT(*-pointer-arithmetic)
+            size -= bytesToCopy;
+            processedSize += bytesToCopy;
+            mPosition += bytesToCopy;
+            continue;
+        }
+
+        if ( size >= mBlockSize ) {
+            // Buffering a large read would only add a copy, so we read it directly.
+            std::uint32_t bytesRead = 0;
+            const auto result = readAt( mPosition, output, size, bytesRead );
+            processedSize += bytesRead;
+            mPosition += bytesRead;
+            return result;
+        }
+
+        const auto result = fillBuffer();
+        if ( result != S_OK ) {
+            return result;
+        }
+        if ( mPosition - mBufferOffset >= mBufferedSize ) { // End of file.
+            break;
+        }
+    }
+    return S_OK;
+}
+
+auto CFileInStream::fillBuffer() noexcept -> HRESULT {
+    if ( mBufferedSize > 0 && mPosition == mBufferOffset + mBufferedSize ) {
+        // Sequential read: we keep the last buffered block as look-behind, and read the next one after it.
+        const auto keptSize = std::min( mBufferedSize, mBlockSize );
+        std::memmove( mBuffer.data(), &mBuffer[ mBufferedSize - keptSize ], keptSize );
+        mBufferOffset += mBufferedSize - keptSize;
+        mBufferedSize = keptSize;
+    } else {
+        mBufferOffset = mPosition;
+        mBufferedSize = 0;
+    }
+
+    std::uint32_t bytesRead = 0;
+    const auto result = readAt( mPosition, &mBuffer[ mBufferedSize ], mBlockSize, bytesRead );
+    mBufferedSize += bytesRead;
+    if ( result == S_OK && bytesRead == mBlockSize ) {
+        mFile.adviseWillNeed( mFilePosition, mBlockSize );
+    }
+    return result;
+}
+
+auto CFileInStream::readAt(
+    std::uint64_t offset,
+    void* data,
+    std::uint32_t size,
+    std::uint32_t& processedSize
+) noexcept -> HRESULT {
+    // Seeks are lazy: the file pointer is moved only when we actually need to read from a different position.
+    if ( mFilePosition != offset ) {
+        const auto result = mFile.seek( SeekOrigin::Begin, static_cast< std::int64_t >( offset ), mFilePosition );
+        if ( result != S_OK ) {
+            return result;
+        }
+    }
+    const auto result = mFile.read( data, size, processedSize );
+    mFilePosition += processedSize;
+    return result;
+}
+
+auto CFileInStream::seekBuffered(
+    std::int64_t offset,
+    std::uint32_t seekOrigin,
+    std::uint64_t& newPosition
+) noexcept -> HRESULT {
+    // Note: the size of the file is needed (and queried) only when seeking from its end.
+    std::uint64_t fileSize = 0;
+    if ( seekOrigin == STREAM_SEEK_END ) {
+        RINOK( mFile.seek( SeekOrigin::End, 0, mFilePosition ) ) //-V3504
+        fileSize = mFilePosition;
+    }
+
+    RINOK( seek( fileSize, mPosition, offset, seekOrigin, newPosition ) ) //-V3504
+    mPosition = newPosition;
+    return S_OK;
+}
+
 } // namespace bit7z
@@ -19,11 +19,25 @@
 
 #include <7zip/IStream.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace bit7z {
 
+/**
+ * An input stream reading from a file.
+ *
+ * If a non-zero buffer size is given, the stream reads the file in blocks of that size, and serves small reads
+ * from memory. The previous block is kept in the buffer too, so that short backward seeks (e.g., when parsing
+ * archive headers) do not hit the file again. Reads larger than the block size bypass the buffer.
+ */
 class CFileInStream : public IInStream, public CMyUnknownImp {
     public:
-        explicit CFileInStream( const native_string& filePath, bool storeOpenFiles = false );
+        explicit CFileInStream(
+            const native_string& filePath,
+            bool storeOpenFiles = false,
+            std::uint32_t bufferSize = 0
+        );
 
         CFileInStream( const CFileInStream& ) = delete;
 
@@ -45,6 +59,28 @@ class CFileInStream : public IInStream, public CMyUnknownImp {
 
     private:
         InputFile mFile;
+
+        // The following members are used only in buffered mode, i.e., when mBlockSize is not zero.
+        std::uint32_t mBlockSize;
+
+        // Holds up to two blocks: the previously read one (look-behind), and the current one.
+        std::vector< byte_t > mBuffer;
+        std::uint64_t mBufferOffset;
+        std::uint32_t mBufferedSize;
+
+        // The stream's logical position, and the actual position of the file pointer.
+        std::uint64_t mPosition;
+        std::uint64_t mFilePosition;
+
+        auto readBuffered( void* data, std::uint32_t size, std::uint32_t& processedSize ) noexcept -> HRESULT;
+
+        auto seekBuffered( std::int64_t offset, std::uint32_t seekOrigin, std::uint64_t& newPosition ) noexcept
+            -> HRESULT;
+
+        auto fillBuffer() noexcept -> HRESULT;
+
+        auto readAt( std::uint64_t offset, void* data, std::uint32_t size, std::uint32_t& processedSize ) noexcept
+            -> HRESULT;
 };
 
 } // namespace bit7z
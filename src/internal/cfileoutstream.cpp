@@ -12,13 +12,32 @@
 
 #include "internal/cfileoutstream.hpp"
 
+#include "internal/util.hpp"
+#include "internal/windows.hpp"
+
+#include <algorithm>
+#include <cstring>
+
 namespace bit7z {
 
-CFileOutStream::CFileOutStream( const fs::path& filePath, FileFlag fileFlag )
-    : mFile( filePath.native(), fileFlag ), mFilePath{ filePath } {}
+CFileOutStream::CFileOutStream( const fs::path& filePath, FileFlag fileFlag, std::uint32_t bufferSize )
+    : mFile( filePath.native(), fileFlag ),
+      mFilePath{ filePath },
+      mBuffer( bufferSize ),
+      mBufferOffset{ 0 },
+      mBufferedSize{ 0 },
+      mPosition{ 0 },
+      mFilePosition{ 0 } {}
+
+CFileOutStream::~CFileOutStream() {
+    // Note: any error is ignored here, users needing to check it must call flush() before.
+    static_cast< void >( flush() );
+}
 
 #ifdef _WIN32
-void CFileOutStream::setFileTime( FILETIME creation, FILETIME access, FILETIME modified ) const noexcept {
+void CFileOutStream::setFileTime( FILETIME creation, FILETIME access, FILETIME modified ) noexcept {
+    // Writing the buffered data after setting the times would update the last write time.
+    static_cast< void >( flush() );
     ( void )mFile.setFileTime( creation, access, modified );
 }
 #endif
@@ -42,7 +61,9 @@ STDMETHODIMP CFileOutStream::Write( const void* data, UInt32 size, UInt32* proce
     }
 
     std::uint32_t totalBytesWritten = 0;
-    const auto result = mFile.write( data, size, totalBytesWritten );
+    const auto result = mBuffer.empty()
+        ? mFile.write( data, size, totalBytesWritten )
+        : writeBuffered( data, size, totalBytesWritten );
     if ( processedSize != nullptr ) {
         *processedSize = totalBytesWritten;
     }
@@ -52,16 +73,125 @@ STDMETHODIMP CFileOutStream::Write( const void* data, UInt32 size, UInt32* proce
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CFileOutStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
     std::uint64_t finalPosition = 0;
-    const auto result = mFile.seek( static_cast< SeekOrigin >( seekOrigin ), offset, finalPosition );
+    if ( mBuffer.empty() ) {
+        const auto result = mFile.seek( static_cast< SeekOrigin >( seekOrigin ), offset, finalPosition );
+        if ( newPosition != nullptr ) {
+            *newPosition = finalPosition;
+        }
+        return result;
+    }
+
+    if ( seekOrigin == STREAM_SEEK_SET || seekOrigin == STREAM_SEEK_CUR ) {
+        // Like in CFileInStream, only the logical position changes here: writeAt() moves the file pointer.
+        finalPosition = seekOrigin == STREAM_SEEK_SET ? 0 : mPosition;
+        RINOK( seekToOffset( finalPosition, offset ) ) //-V3504
+        mPosition = finalPosition;
+    } else {
+        // The end of the file might be in the buffered data, so we write it before asking the OS.
+        RINOK( flush() ) //-V3504
+        RINOK( mFile.seek( static_cast< SeekOrigin >( seekOrigin ), offset, finalPosition ) ) //-V3504
+        mPosition = finalPosition;
+        mFilePosition = finalPosition;
+    }
     if ( newPosition != nullptr ) {
         *newPosition = finalPosition;
     }
-    return result;
+    return S_OK;
 }
 
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CFileOutStream::SetSize( UInt64 newSize ) noexcept {
-    return mFile.resize( static_cast< std::uint64_t >( newSize ) ) ? S_OK : E_FAIL;
+    RINOK( flush() ) //-V3504
+    if ( !mFile.resize( static_cast< std::uint64_t >( newSize ) ) ) {
+        return E_FAIL;
+    }
+    if ( !mBuffer.empty() ) {
+        // Note: resizing the file might have moved the file pointer (e.g., on Windows).
+        RINOK( mFile.seek( SeekOrigin::CurrentPosition, 0, mFilePosition ) ) //-V3504
+    }
+    return S_OK;
+}
+
+auto CFileOutStream::flush() noexcept -> HRESULT {
+    if ( mBufferedSize == 0 ) {
+        return S_OK;
+    }
+
+    std::uint32_t bytesWritten = 0;
+    const auto result = writeAt( mBufferOffset, mBuffer.data(), mBufferedSize, bytesWritten );
+    if ( result != S_OK ) {
+        return result;
+    }
+    if ( bytesWritten != mBufferedSize ) {
+        return E_FAIL;
+    }
+    mBufferedSize = 0;
+    return S_OK;
+}
+
+void CFileOutStream::preallocate( std::uint64_t size ) const noexcept {
+    mFile.preallocate( size );
+}
+
+auto CFileOutStream::sync() const noexcept -> HRESULT {
+    return mFile.sync();
+}
+
+auto CFileOutStream::writeBuffered(
+    const void* data,
+    std::uint32_t size,
+    std::uint32_t& processedSize
+) noexcept -> HRESULT {
+    const auto blockSize = static_cast< std::uint32_t >( mBuffer.size() );
+    const auto* input = static_cast< const byte_t* >( data );
+    while ( size > 0 ) {
+        if ( mBufferedSize == 0 ) {
+            if ( size >= blockSize ) {
+                // Nothing buffered, and at least a whole block to write: the data goes straight to the file.
+                std::uint32_t bytesWritten = 0;
+                const auto result = writeAt( mPosition, input, size, bytesWritten );
+                processedSize += bytesWritten;
+                mPosition += bytesWritten;
+                return result;
+            }
+            mBufferOffset = mPosition;
+        } else if ( mPosition < mBufferOffset ||
+                    mPosition - mBufferOffset > mBufferedSize ||
+                    mPosition - mBufferOffset >= blockSize ) {
+            // Writing here would leave a gap in the buffered data, so we write the latter first.
+            RINOK( flush() ) //-V3504
+            continue;
+        }
+
+        // Appending to the buffered data, or patching it.
+        const auto bufferIndex = static_cast< std::uint32_t >( mPosition - mBufferOffset );
+        const auto bytesToCopy = std::min( size, blockSize - bufferIndex );
+        std::memcpy( &mBuffer[ bufferIndex ], input, bytesToCopy );
+        mBufferedSize = std::max( mBufferedSize, bufferIndex + bytesToCopy );
+        input += bytesToCopy; // NOLINT(*-pointer-arithmetic)
+        size -= bytesToCopy;
+        processedSize += bytesToCopy;
+        mPosition += bytesToCopy;
+
+        if ( mBufferedSize == blockSize ) {
+            RINOK( flush() ) //-V3504
+        }
+    }
+    return S_OK;
+}
+
+auto CFileOutStream::writeAt(
+    std::uint64_t offset,
+    const void* data,
+    std::uint32_t size,
+    std::uint32_t& processedSize
+) noexcept -> HRESULT {
+    if ( mFilePosition != offset ) {
+        RINOK( mFile.seek( SeekOrigin::Begin, static_cast< std::int64_t >( offset ), mFilePosition ) ) //-V3504
+    }
+    const auto result = mFile.write( data, size, processedSize );
+    mFilePosition += processedSize;
+    return result;
 }
 
 } // namespace bit7z
@@ -18,11 +18,28 @@
 
 #include <7zip/IStream.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace bit7z {
 
+/**
+ * An output stream writing to a file.
+ *
+ * If a non-zero buffer size is given, the stream coalesces small sequential writes into blocks of that size.
+ * Writes landing inside the buffered block (e.g., header patch-ups after a short seek back) just patch it,
+ * while any other seek-and-write flushes the block first. Writes larger than the block size bypass the buffer.
+ *
+ * @note Buffered data is written when the stream is destroyed, but any error would be lost at that point:
+ *       users must call flush() to write the data and check the result.
+ */
 class CFileOutStream : public IOutStream, public CMyUnknownImp {
     public:
-        explicit CFileOutStream( const fs::path& filePath, FileFlag fileFlag = FileFlag::CreateNew );
+        explicit CFileOutStream(
+            const fs::path& filePath,
+            FileFlag fileFlag = FileFlag::CreateNew,
+            std::uint32_t bufferSize = 0
+        );
 
         CFileOutStream( const CFileOutStream& ) = delete;
 
@@ -32,12 +49,37 @@ class CFileOutStream : public IOutStream, public CMyUnknownImp {
 
         auto operator=( CFileOutStream&& ) -> CFileOutStream& = delete;
 
-        MY_UNKNOWN_VIRTUAL_DESTRUCTOR( ~CFileOutStream() ) = default;
+        MY_UNKNOWN_VIRTUAL_DESTRUCTOR( ~CFileOutStream() );
 
 #ifdef _WIN32
-        void setFileTime( FILETIME creation, FILETIME access, FILETIME modified ) const noexcept;
+        void setFileTime( FILETIME creation, FILETIME access, FILETIME modified ) noexcept;
 #endif
 
+        /**
+         * @brief Writes the buffered data (if any) to the file.
+         *
+         * @return S_OK on success, or an error HRESULT otherwise.
+         */
+        auto flush() noexcept -> HRESULT;
+
+        /**
+         * @brief Hints the OS to reserve the storage space for the given number of bytes of the file.
+         *
+         * @note The file size is not changed; the space reserved beyond the end of the file
+         *       is released by SetSize (e.g., with the current size of the file).
+         */
+        void preallocate( std::uint64_t size ) const noexcept;
+
+        /**
+         * @brief Commits the data written to the file to the storage device.
+         *
+         * @note The buffered data (if any) is not written: users must call flush() before.
+         *       Unlike the other methods, this can be called by a thread other than the one writing the stream.
+         *
+         * @return S_OK on success, or an error HRESULT otherwise.
+         */
+        auto sync() const noexcept -> HRESULT;
+
         BIT7Z_NODISCARD
         auto path() const & noexcept -> const fs::path&;
 
@@ -57,6 +99,24 @@ class CFileOutStream : public IOutStream, public CMyUnknownImp {
     private:
         OutputFile mFile;
         fs::path mFilePath;
+
+        // The following members are used only in buffered mode, i.e., when mBuffer is not empty.
+        std::vector< byte_t > mBuffer;
+        std::uint64_t mBufferOffset;
+        std::uint32_t mBufferedSize;
+
+        // The stream's logical position, and the actual position of the file pointer.
+        std::uint64_t mPosition;
+        std::uint64_t mFilePosition;
+
+        auto writeBuffered( const void* data, std::uint32_t size, std::uint32_t& processedSize ) noexcept -> HRESULT;
+
+        auto writeAt(
+            std::uint64_t offset,
+            const void* data,
+            std::uint32_t size,
+            std::uint32_t& processedSize
+        ) noexcept -> HRESULT;
 };
 
 } // namespace bit7z
@@ -0,0 +1,97 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/cmappedfileinstream.hpp"
+
+#include "bitexception.hpp"
+#include "internal/bufferutil.hpp"
+#include "internal/cfileinstream.hpp"
+#include "internal/util.hpp"
+#include "internal/windows.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace bit7z {
+
+namespace {
+constexpr std::uint64_t kReadAheadSize = 1024U * 1024U;
+constexpr std::uint64_t kNoRead = std::numeric_limits< std::uint64_t >::max();
+} // namespace
+
+CMappedFileInStream::CMappedFileInStream( const native_string& filePath )
+    : mMapping{ InputFile{ filePath } },
+      mPosition{ 0 },
+      mLastReadEnd{ kNoRead },
+      mReadAheadEnd{ 0 } {}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CMappedFileInStream::Read( void* data, UInt32 size, UInt32* processedSize ) noexcept {
+    if ( processedSize != nullptr ) {
+        *processedSize = 0;
+    }
+
+    if ( size == 0 || mPosition >= mMapping.size() ) {
+        return S_OK;
+    }
+
+    const auto bytesToRead = static_cast< UInt32 >( std::min< std::uint64_t >( size, mMapping.size() - mPosition ) );
+    const auto readEnd = mPosition + bytesToRead;
+
+    // When reading sequentially, we ask the OS to read ahead before we get to the not-yet-loaded pages.
+    // Note: we do it only every half read-ahead window, so that most reads do not need any system call.
+    if ( mPosition == mLastReadEnd && readEnd + ( kReadAheadSize / 2 ) > mReadAheadEnd ) {
+        const auto readAheadStart = std::max( mReadAheadEnd, readEnd );
+        mMapping.adviseWillNeed( readAheadStart, kReadAheadSize );
+        mReadAheadEnd = readAheadStart + kReadAheadSize;
+    }
+
+    // NOLINTNEXTLINE(*-pointer-arithmetic)
+    std::memcpy( data, mMapping.data() + static_cast< std::size_t >( mPosition ), bytesToRead );
+    mPosition = readEnd;
+    mLastReadEnd = readEnd;
+
+    if ( processedSize != nullptr ) {
+        *processedSize = bytesToRead;
+    }
+    return S_OK;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CMappedFileInStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
+    std::uint64_t seekPosition{};
+    RINOK( seek( mMapping.size(), mPosition, offset, seekOrigin, seekPosition ) ) //-V3504
+    mPosition = seekPosition;
+
+    if ( newPosition != nullptr ) {
+        *newPosition = mPosition;
+    }
+    return S_OK;
+}
+
+auto makeFileInStream( const fs::path& filePath, bool useMemoryMapping, std::uint32_t readBufferSize )
+    -> CMyComPtr< IInStream > {
+    if ( useMemoryMapping ) {
+        std::error_code error;
+        if ( fs::is_regular_file( filePath, error ) ) {
+            try {
+                return bit7z::make_com< CMappedFileInStream, IInStream >( filePath.native() );
+            } catch ( const BitException& ) {
+                // The file could not be mapped (e.g., it is too big for the address space): we read it normally.
+            }
+        }
+    }
+    return bit7z::make_com< CFileInStream, IInStream >( filePath.native(), false, readBufferSize );
+}
+
+} // namespace bit7z
@@ -0,0 +1,82 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CMAPPEDFILEINSTREAM_HPP
+#define CMAPPEDFILEINSTREAM_HPP
+
+#include "internal/com.hpp"
+#include "internal/filehandle.hpp"
+#include "internal/fs.hpp"
+#include "internal/guids.hpp"
+#include "internal/macros.hpp"
+
+#include <7zip/IStream.h>
+
+#include <cstdint>
+
+namespace bit7z {
+
+/**
+ * An input stream reading from a memory-mapped file.
+ *
+ * Reads are served by copying from the mapping, i.e., from the OS page cache, without any system call.
+ * Sequential reads also hint the OS to read ahead the following part of the file.
+ */
+class CMappedFileInStream final : public IInStream, public CMyUnknownImp {
+    public:
+        /**
+         * @throws BitException if the file cannot be opened or mapped.
+         */
+        explicit CMappedFileInStream( const native_string& filePath );
+
+        CMappedFileInStream( const CMappedFileInStream& ) = delete;
+
+        CMappedFileInStream( CMappedFileInStream&& ) = delete;
+
+        auto operator=( const CMappedFileInStream& ) -> CMappedFileInStream& = delete;
+
+        auto operator=( CMappedFileInStream&& ) -> CMappedFileInStream& = delete;
+
+        MY_UNKNOWN_DESTRUCTOR( ~CMappedFileInStream() ) = default;
+
+        // IInStream
+        BIT7Z_STDMETHOD( Read, void* data, UInt32 size, UInt32* processedSize );
+
+        BIT7Z_STDMETHOD( Seek, Int64 offset, UInt32 seekOrigin, UInt64* newPosition );
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( IInStream ) //-V2507 //-V2511 //-V835 //-V3504
+
+    private:
+        FileMapping mMapping;
+        std::uint64_t mPosition;
+
+        // The end of the last read, and the end of the range we asked the OS to read ahead.
+        std::uint64_t mLastReadEnd;
+        std::uint64_t mReadAheadEnd;
+};
+
+/**
+ * @brief Opens an input stream for reading the given file.
+ *
+ * If memory mapping is requested, the file is memory-mapped if it is a regular file; otherwise
+ * (e.g., for pipes or devices), or if the mapping fails, the file is read via a CFileInStream.
+ *
+ * @param filePath          the path of the file to be read.
+ * @param useMemoryMapping  whether to try to memory-map the file.
+ * @param readBufferSize    the size of the read buffer blocks of the CFileInStream (zero for no buffering).
+ *
+ * @return the input stream.
+ */
+auto makeFileInStream( const fs::path& filePath, bool useMemoryMapping, std::uint32_t readBufferSize )
+    -> CMyComPtr< IInStream >;
+
+} // namespace bit7z
+
+#endif //CMAPPEDFILEINSTREAM_HPP
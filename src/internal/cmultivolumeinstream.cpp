@@ -15,17 +15,113 @@
 #include "biterror.hpp"
 #include "bitexception.hpp"
 #include "bittypes.hpp"
+#include "internal/bufferutil.hpp"
+#include "internal/cmappedfileinstream.hpp"
 #include "internal/fs.hpp"
-#include "internal/util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+#include <cwctype>
+#endif
 
 namespace bit7z {
 
-CMultiVolumeInStream::CMultiVolumeInStream( const fs::path& firstVolume ) : mAbsolutePosition{ 0 }, mTotalSize{ 0 } {
+namespace {
+// When a read gets closer than this to the end of a volume, the next volume is opened in the background.
+constexpr std::uint64_t kPrefetchDistance = 4 * 1024 * 1024;
+
+// The number of bytes read in the background from the beginning of a prefetched volume,
+// so that the first read from the volume is likely served by the OS cache.
+constexpr std::uint32_t kReadAheadSize = 64 * 1024;
+
+using VolumeSizes = std::unordered_map< fs::path::string_type, std::uint64_t >;
+
+auto volumeKey( const fs::path& volumePath ) -> fs::path::string_type {
+    auto result = volumePath.filename().native();
+#ifdef _WIN32
+    // Windows' file names are case-insensitive.
+    std::transform( result.begin(), result.end(), result.begin(), []( wchar_t character ) -> wchar_t {
+        return static_cast< wchar_t >( std::towlower( character ) );
+    } );
+#endif
+    return result;
+}
+
+// Lists the sizes of the files in the folder of the first volume, whose name might be the one of a volume;
+// this way, we can discover all the volumes without querying the filesystem for each of them.
+auto listVolumes( const fs::path& firstVolume, std::error_code& error ) -> VolumeSizes {
+    VolumeSizes result;
+    const auto volumesFolder = firstVolume.has_parent_path() ? firstVolume.parent_path() : fs::path{ "." };
+    const auto namePrefix = volumeKey( firstVolume.stem() );
+    for ( fs::directory_iterator iterator{ volumesFolder, error }; !error && iterator != fs::directory_iterator{};
+          iterator.increment( error ) ) {
+        auto key = volumeKey( iterator->path() );
+        if ( key.compare( 0, namePrefix.size(), namePrefix ) != 0 ) {
+            continue;
+        }
+
+        std::error_code entryError;
+        if ( !iterator->is_regular_file( entryError ) ) {
+            continue;
+        }
+        const auto volumeSize = iterator->file_size( entryError );
+        if ( !entryError ) {
+            result.emplace( std::move( key ), volumeSize );
+        }
+    }
+    return result;
+}
+
+auto openVolumeAhead( const fs::path& volumePath, bool useMemoryMapping, std::uint32_t readBufferSize )
+    -> CMyComPtr< IInStream > {
+    auto stream = makeFileInStream( volumePath, useMemoryMapping, readBufferSize );
+    buffer_t readAheadBuffer( kReadAheadSize );
+    UInt32 bytesRead{};
+    if ( stream->Read( readAheadBuffer.data(), kReadAheadSize, &bytesRead ) != S_OK ||
+         stream->Seek( 0, STREAM_SEEK_SET, nullptr ) != S_OK ) {
+        // The volume will be opened again when needed, reporting the error.
+        return {};
+    }
+    return stream;
+}
+} // namespace
+
+CMultiVolumeInStream::CMultiVolumeInStream(
+    const fs::path& firstVolume,
+    bool useMemoryMapping,
+    std::uint32_t readBufferSize
+) : mAbsolutePosition{ 0 },
+    mTotalSize{ 0 },
+    mUseMemoryMapping{ useMemoryMapping },
+    mReadBufferSize{ readBufferSize } {
+    // Note: if the folder cannot be listed (or a volume is not among the listed files),
+    // we fall back to checking the existence of each volume.
+    std::error_code listingError;
+    const auto volumeSizes = listVolumes( firstVolume, listingError );
+
     constexpr std::size_t kVolumeDigits = 3u;
     std::size_t volumeIndex = 1u;
     fs::path volumePath = firstVolume;
-    while ( fs::exists( volumePath ) ) {
-        addVolume( volumePath );
+    while ( true ) {
+        std::uint64_t volumeSize = 0;
+        const auto volume = listingError ? volumeSizes.end() : volumeSizes.find( volumeKey( volumePath ) );
+        if ( volume != volumeSizes.end() ) {
+            volumeSize = volume->second;
+        } else if ( fs::exists( volumePath ) ) {
+            // Note: the listed names might differ from the volume's one, e.g., on case-insensitive filesystems.
+            volumeSize = fs::file_size( volumePath );
+        } else {
+            break;
+        }
+        addVolume( volumePath, volumeSize );
 
         ++volumeIndex;
         tstring volumeExt = to_tstring( volumeIndex );
@@ -37,7 +133,7 @@ CMultiVolumeInStream::CMultiVolumeInStream( const fs::path& firstVolume ) : mAbs
 }
 
 // NOLINTBEGIN(*-pro-bounds-avoid-unchecked-container-access)
-auto CMultiVolumeInStream::currentVolume() -> CachedVolume< CFileInStream >& {
+auto CMultiVolumeInStream::currentVolume() -> CachedVolume< IInStream >& {
     std::size_t left = 0;
     std::size_t right = mVolumes.size();
     std::size_t midpoint = mLastOpenedVolume == kNoVolume ? right / 2 : mLastOpenedVolume;
@@ -56,6 +152,7 @@ auto CMultiVolumeInStream::currentVolume() -> CachedVolume< CFileInStream >& {
             }
 #else
             if ( midpoint == mVolumes.newest() ) {
+                mVolumes.touch( cachedVolume );
                 return cachedVolume; // Already the newest, nothing to do.
             }
 #endif
@@ -70,14 +167,14 @@ auto CMultiVolumeInStream::currentVolume() -> CachedVolume< CFileInStream >& {
 
 // NOLINTEND(*-pro-bounds-avoid-unchecked-container-access)
 
-void CMultiVolumeInStream::ensureVolumeOpen( CachedVolume< CFileInStream >& cachedVolume, std::size_t volumeIndex ) {
+void CMultiVolumeInStream::ensureVolumeOpen( CachedVolume< IInStream >& cachedVolume, std::size_t volumeIndex ) {
 #ifdef _WIN32
     if ( cachedVolume.stream == nullptr ) {
-        cachedVolume.stream = make_com< CFileInStream >( cachedVolume.volumePath.native() );
+        cachedVolume.stream = openVolume( cachedVolume, volumeIndex );
     }
 #else
     if ( cachedVolume.stream == nullptr ) {
-        cachedVolume.stream = make_com< CFileInStream >( cachedVolume.volumePath.native() );
+        cachedVolume.stream = openVolume( cachedVolume, volumeIndex );
         mVolumes.trackReopen( cachedVolume, volumeIndex );
     } else {
         mVolumes.promote( cachedVolume, volumeIndex );
@@ -86,6 +183,56 @@ void CMultiVolumeInStream::ensureVolumeOpen( CachedVolume< CFileInStream >& cach
     mLastOpenedVolume = volumeIndex;
 }
 
+auto CMultiVolumeInStream::openVolume( const CachedVolume< IInStream >& cachedVolume, std::size_t volumeIndex )
+    -> CMyComPtr< IInStream > {
+    if ( mPrefetchedVolume == volumeIndex ) {
+        mPrefetchedVolume = kNoVolume;
+        try {
+            auto prefetchedStream = mPrefetchedStream.get();
+            if ( prefetchedStream != nullptr ) {
+                return prefetchedStream;
+            }
+        } catch ( const std::exception& ) { // NOLINT(*-empty-catch)
+            /* The volume is opened again below, so that the error is reported by the reading thread
+             * (e.g., the prefetch might have failed only because it couldn't allocate its read-ahead buffer). */
+        }
+    }
+    return makeFileInStream( cachedVolume.volumePath, mUseMemoryMapping, mReadBufferSize );
+}
+
+void CMultiVolumeInStream::prefetchNextVolume( std::uint64_t volumeOffset ) {
+    const auto nextVolume = mLastOpenedVolume + 1;
+    if ( nextVolume >= mVolumes.size() || mPrefetchedVolume == nextVolume ) {
+        return;
+    }
+
+    const auto& cachedVolume = mVolumes[ mLastOpenedVolume ];
+    if ( cachedVolume.volumeSize - volumeOffset > kPrefetchDistance || mVolumes[ nextVolume ].stream != nullptr ) {
+        return;
+    }
+
+    if ( mPrefetchedVolume != kNoVolume ) {
+        // We don't wait for a previous prefetch not used by the reads (e.g., after a seek) to complete.
+        if ( mPrefetchedStream.wait_for( std::chrono::seconds{ 0 } ) != std::future_status::ready ) {
+            return;
+        }
+        mPrefetchedVolume = kNoVolume;
+        mPrefetchedStream = {};
+    }
+
+    try {
+        mPrefetchedStream = std::async( std::launch::async,
+                                        openVolumeAhead,
+                                        mVolumes[ nextVolume ].volumePath,
+                                        mUseMemoryMapping,
+                                        mReadBufferSize );
+    } catch ( const std::system_error& ) {
+        // No thread available for prefetching the volume, so it will be opened by the read needing it.
+        return;
+    }
+    mPrefetchedVolume = nextVolume;
+}
+
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CMultiVolumeInStream::Read( void* data, UInt32 size, UInt32* processedSize ) noexcept try {
     if ( processedSize != nullptr ) {
@@ -96,9 +243,14 @@ STDMETHODIMP CMultiVolumeInStream::Read( void* data, UInt32 size, UInt32* proces
         return S_OK;
     }
 
+#ifndef _WIN32
+    // Preventing other streams from closing our volumes while we are using them.
+    const auto volumesLock = mVolumes.lock();
+#endif
     auto& cachedVolume = currentVolume();
 
     const auto volumeOffset = mAbsolutePosition - cachedVolume.globalOffset;
+    prefetchNextVolume( volumeOffset );
     if ( volumeOffset != cachedVolume.seekPosition ) {
         /* The offset we must read from is different from the last offset we read from. */
         UInt64 newPosition{};
@@ -116,7 +268,7 @@ STDMETHODIMP CMultiVolumeInStream::Read( void* data, UInt32 size, UInt32* proces
     UInt32 bytesRead{};
     const auto result = cachedVolume.stream->Read( data, readSize, &bytesRead );
 
-    // Note: size is the number of bytes successfully read by CFileInStream::Read,
+    // Note: size is the number of bytes successfully read by the volume stream,
     // so we don't need to check for result here, and we can update the positions unconditionally.
     /* Updating the positions */
     mAbsolutePosition += bytesRead;
@@ -135,20 +287,7 @@ STDMETHODIMP CMultiVolumeInStream::Read( void* data, UInt32 size, UInt32* proces
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CMultiVolumeInStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
     std::uint64_t seekPosition{};
-    switch ( seekOrigin ) {
-        case STREAM_SEEK_SET:
-            break;
-        case STREAM_SEEK_CUR:
-            seekPosition = mAbsolutePosition;
-            break;
-        case STREAM_SEEK_END:
-            seekPosition = mTotalSize;
-            break;
-        default:
-            return STG_E_INVALIDFUNCTION;
-    }
-
-    RINOK( seekToOffset( seekPosition, offset ) ) //-V3504
+    RINOK( seek( mTotalSize, mAbsolutePosition, offset, seekOrigin, seekPosition ) ) //-V3504
     mAbsolutePosition = seekPosition;
 
     if ( newPosition != nullptr ) {
@@ -157,8 +296,7 @@ STDMETHODIMP CMultiVolumeInStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64
     return S_OK;
 }
 
-void CMultiVolumeInStream::addVolume( const fs::path& volumePath ) {
-    const auto volumeSize = fs::file_size( volumePath );
+void CMultiVolumeInStream::addVolume( const fs::path& volumePath, std::uint64_t volumeSize ) {
     if ( volumeSize == 0 ) {
         throw BitException{ "Invalid volume archive", make_error_code( BitError::Fail ) };
     }
@@ -172,7 +310,7 @@ void CMultiVolumeInStream::addVolume( const fs::path& volumePath ) {
         const auto& lastStream = mVolumes.back();
         return lastStream.globalOffset + lastStream.volumeSize;
     }();
-    CachedVolume< CFileInStream > cachedVolume{ volumePath, volumeSize, globalOffset, 0u, {} };
+    CachedVolume< IInStream > cachedVolume{ volumePath, volumeSize, globalOffset, 0u, {} };
     mVolumes.push_back( std::move( cachedVolume ) );
 }
 
@@ -11,20 +11,27 @@
 #define CMULTIVOLUMEINSTREAM_HPP
 
 #include "internal/com.hpp"
-#include "internal/cfileinstream.hpp"
+#include "internal/fs.hpp"
 #include "internal/guiddef.hpp"
+#include "internal/guids.hpp"
 #include "internal/macros.hpp"
 #include "internal/volumescache.hpp"
 
 #include <7zip/IStream.h>
 
+#include <cstdint>
+#include <future>
 #include <vector>
 
 namespace bit7z {
 
 class CMultiVolumeInStream final : public IInStream, public CMyUnknownImp {
     public:
-        explicit CMultiVolumeInStream( const fs::path& firstVolume );
+        explicit CMultiVolumeInStream(
+            const fs::path& firstVolume,
+            bool useMemoryMapping = false,
+            std::uint32_t readBufferSize = 0
+        );
 
         CMultiVolumeInStream( const CMultiVolumeInStream& ) = delete;
 
@@ -47,14 +54,27 @@ class CMultiVolumeInStream final : public IInStream, public CMyUnknownImp {
     private:
         std::uint64_t mAbsolutePosition;
         std::uint64_t mTotalSize;
-        VolumesCache< CFileInStream, EvictionPolicy::Oldest > mVolumes;
+        VolumesCache< IInStream, EvictionPolicy::Oldest > mVolumes;
         std::size_t mLastOpenedVolume = kNoVolume;
+        bool mUseMemoryMapping;
+        std::uint32_t mReadBufferSize;
 
-        auto currentVolume() -> CachedVolume< CFileInStream >&;
+        // The volume being opened in the background (if any), and its future stream.
+        // Note: destroying the future waits for the background opening to complete.
+        // The prefetched stream is not accounted in the VolumeHandlesBudget until it is used by openVolume.
+        std::size_t mPrefetchedVolume = kNoVolume;
+        std::future< CMyComPtr< IInStream > > mPrefetchedStream;
 
-        void ensureVolumeOpen( CachedVolume< CFileInStream >& cachedVolume, std::size_t volumeIndex );
+        auto currentVolume() -> CachedVolume< IInStream >&;
 
-        void addVolume( const fs::path& volumePath );
+        void ensureVolumeOpen( CachedVolume< IInStream >& cachedVolume, std::size_t volumeIndex );
+
+        auto openVolume( const CachedVolume< IInStream >& cachedVolume, std::size_t volumeIndex )
+            -> CMyComPtr< IInStream >;
+
+        void prefetchNextVolume( std::uint64_t volumeOffset );
+
+        void addVolume( const fs::path& volumePath, std::uint64_t volumeSize );
 };
 
 } // namespace bit7z
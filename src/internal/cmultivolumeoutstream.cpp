@@ -29,11 +29,18 @@ CMultiVolumeOutStream::CMultiVolumeOutStream( std::uint64_t volSize, fs::path ar
     : mMaxVolumeSize( volSize ),
       mVolumePrefix( std::move( archiveName ) ),
       mAbsolutePosition( 0 ),
-      mTotalSize( 0 ) {}
+      mTotalSize( 0 ),
+      mSyncResult( S_OK ) {}
+
+CMultiVolumeOutStream::~CMultiVolumeOutStream() {
+    // Note: any error is ignored here, users needing to check it must call flush() before.
+    static_cast< void >( flush() );
+}
 
 auto CMultiVolumeOutStream::currentVolume() -> CachedVolume< CFileOutStream >& {
     const auto volumeIndex = static_cast< std::size_t >( mAbsolutePosition / mMaxVolumeSize );
 
+    const bool isNewVolume = volumeIndex >= mVolumes.size();
     for ( auto newVolumeIndex = mVolumes.size(); newVolumeIndex <= volumeIndex; ++newVolumeIndex ) {
         /* The current volume stream still doesn't exist, so we need to create it. */
         tstring name = to_tstring( static_cast< std::uint64_t >( newVolumeIndex ) + 1 );
@@ -51,12 +58,20 @@ auto CMultiVolumeOutStream::currentVolume() -> CachedVolume< CFileOutStream >& {
             {}
         };
         mVolumes.emplace_back( std::move( volume ) );
+        mVolumesState.push_back( { false, false, false } );
+    }
+
+    if ( isNewVolume && volumeIndex > 0 ) {
+        // The encoder moved on to a new volume, so the previous one is likely complete.
+        syncInBackground( volumeIndex - 1 );
     }
 
     auto& cachedVolume = mVolumes[ volumeIndex ];
+    mVolumesState[ volumeIndex ].unsynced = true;
 
 #ifndef _WIN32
     if ( volumeIndex == mVolumes.newest() ) {
+        mVolumes.touch( cachedVolume );
         return cachedVolume; // Already the newest open volume, no need to ensure it is opened.
     }
 #endif
@@ -67,19 +82,15 @@ auto CMultiVolumeOutStream::currentVolume() -> CachedVolume< CFileOutStream >& {
 
 void CMultiVolumeOutStream::ensureVolumeOpen( CachedVolume< CFileOutStream >& cachedVolume, std::size_t volumeIndex ) {
 #ifdef _WIN32
-    ( void )volumeIndex;
     if ( cachedVolume.stream == nullptr ) {
-        cachedVolume.stream = make_com< CFileOutStream >( cachedVolume.volumePath.native(), FileFlag::CreateNew );
+        cachedVolume.stream = openVolume( cachedVolume, mVolumesState[ volumeIndex ] );
     }
 #else
     if ( cachedVolume.stream == nullptr ) {
         // The volume was evicted from the LRU list, so we need to reopen it.
         // Opening the volume before evicting the oldest one so that
         // we can handle an open failure without evicting the oldest one.
-        // First-open vs reopen heuristic: the LRU promotes a just-opened volume to MRU,
-        // so it cannot be evicted before the first Write makes volumeSize > 0.
-        const auto fileFlag = cachedVolume.volumeSize > 0 ? FileFlag::Existing : FileFlag::CreateNew;
-        cachedVolume.stream = make_com< CFileOutStream >( cachedVolume.volumePath.native(), fileFlag );
+        cachedVolume.stream = openVolume( cachedVolume, mVolumesState[ volumeIndex ] );
         mVolumes.trackReopen( cachedVolume, volumeIndex );
     } else {
         mVolumes.promote( cachedVolume, volumeIndex );
@@ -87,12 +98,102 @@ void CMultiVolumeOutStream::ensureVolumeOpen( CachedVolume< CFileOutStream >& ca
 #endif
 }
 
+auto CMultiVolumeOutStream::openVolume( const CachedVolume< CFileOutStream >& cachedVolume, VolumeState& state ) const
+    -> CMyComPtr< CFileOutStream > {
+    if ( state.created ) {
+        return make_com< CFileOutStream >( cachedVolume.volumePath.native(), FileFlag::Existing );
+    }
+
+    auto stream = make_com< CFileOutStream >( cachedVolume.volumePath.native(), FileFlag::CreateNew );
+    state.created = true;
+
+    // The size of the volume is known up front (except for the last one), so we reserve its space on the storage
+    // device at once rather than growing the file write by write, reducing the fragmentation of the volumes.
+    stream->preallocate( mMaxVolumeSize );
+    state.reserved = true;
+    return stream;
+}
+
+void CMultiVolumeOutStream::syncInBackground( std::size_t volumeIndex ) {
+    auto& cachedVolume = mVolumes[ volumeIndex ];
+    auto& state = mVolumesState[ volumeIndex ];
+    if ( cachedVolume.stream == nullptr || !state.unsynced || cachedVolume.volumeSize < mMaxVolumeSize ) {
+        return; // Evicted or incomplete volumes are synced by flush().
+    }
+
+    // Only one volume is synced at a time: if the storage device can't keep up with the encoder,
+    // we wait for the previous sync here, rather than accumulating more unsynced data.
+    waitVolumeSync();
+
+    mSyncingVolume = cachedVolume.stream;
+    const CFileOutStream* volumeStream = mSyncingVolume;
+    try {
+        mVolumeSync = std::async( std::launch::async, [ volumeStream ]() noexcept -> HRESULT {
+            return volumeStream->sync();
+        } );
+    } catch ( const std::system_error& ) {
+        // No thread available for syncing the volume in background, so it will be synced by flush().
+        mSyncingVolume.Release();
+        return;
+    }
+    state.unsynced = false;
+}
+
+void CMultiVolumeOutStream::waitVolumeSync() noexcept {
+    if ( mVolumeSync.valid() ) {
+        const auto syncResult = mVolumeSync.get();
+        if ( mSyncResult == S_OK ) {
+            mSyncResult = syncResult;
+        }
+    }
+    mSyncingVolume.Release();
+}
+
+auto CMultiVolumeOutStream::flush() noexcept -> HRESULT try {
+#ifndef _WIN32
+    const auto volumesLock = mVolumes.lock();
+#endif
+    waitVolumeSync();
+    RINOK( mSyncResult ) //-V3504
+
+    for ( std::size_t volumeIndex = 0; volumeIndex < mVolumes.size(); ++volumeIndex ) {
+        auto& cachedVolume = mVolumes[ volumeIndex ];
+        auto& state = mVolumesState[ volumeIndex ];
+        if ( state.reserved && cachedVolume.volumeSize == mMaxVolumeSize ) {
+            state.reserved = false; // The volume used all the reserved space.
+        }
+        if ( !state.created || ( !state.reserved && !state.unsynced ) ) {
+            continue;
+        }
+
+        ensureVolumeOpen( cachedVolume, volumeIndex );
+        if ( state.reserved ) {
+            // Resizing the volume to its current size releases the space reserved beyond its end.
+            RINOK( cachedVolume.stream->SetSize( cachedVolume.volumeSize ) ) //-V3504
+            state.reserved = false;
+        }
+        if ( state.unsynced ) {
+            RINOK( cachedVolume.stream->sync() ) //-V3504
+            state.unsynced = false;
+        }
+    }
+    return S_OK;
+} catch ( const BitException& exception ) {
+    return exception.hresultCode();
+} catch ( ... ) {
+    return E_FAIL;
+}
+
 COM_DECLSPEC_NOTHROW
 STDMETHODIMP CMultiVolumeOutStream::Write( const void* data, UInt32 size, UInt32* processedSize ) noexcept try {
     if ( processedSize != nullptr ) {
         *processedSize = 0;
     }
 
+#ifndef _WIN32
+    // Preventing other streams from closing our volumes while we are using them.
+    const auto volumesLock = mVolumes.lock();
+#endif
     /* Getting the current volume stream. */
     auto& volume = currentVolume();
 
@@ -175,6 +276,12 @@ STDMETHODIMP CMultiVolumeOutStream::SetSize( UInt64 newSize ) noexcept {
         return E_INVALIDARG;
     }
 
+#ifndef _WIN32
+    const auto volumesLock = mVolumes.lock();
+#endif
+    // The volume being synced in the background might be one of the volumes to be deleted.
+    waitVolumeSync();
+
     while ( !mVolumes.empty() ) {
         auto& lastVolume = mVolumes.back();
 
@@ -198,6 +305,7 @@ STDMETHODIMP CMultiVolumeOutStream::SetSize( UInt64 newSize ) noexcept {
             return E_FAIL;
         }
         mVolumes.pop_back();
+        mVolumesState.pop_back();
     }
 
     if ( !mVolumes.empty() ) {
@@ -223,6 +331,7 @@ STDMETHODIMP CMultiVolumeOutStream::SetSize( UInt64 newSize ) noexcept {
             if ( lastVolume.stream != nullptr ) { // ensureVolumeOpen may fail to reopen the stream.
                 RINOK( lastVolume.stream->SetSize( static_cast< UInt64 >( newVolumeSize ) ) );
                 lastVolume.volumeSize = newVolumeSize;
+                mVolumesState.back().reserved = false; // Resizing the volume released its reserved space.
             }
         }
     }
@@ -18,6 +18,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <future>
 #include <vector>
 
 namespace bit7z {
@@ -39,10 +40,34 @@ class CMultiVolumeOutStream final : public IOutStream, public CMyUnknownImp {
     // So we evict the newest opened volume, rather than the oldest one, in this case.
     VolumesCache< CFileOutStream, EvictionPolicy::Newest > mVolumes;
 
+    struct VolumeState {
+        bool created;  // The volume file has been created.
+        bool reserved; // The volume file might have reserved space beyond its end, to be released when done.
+        bool unsynced; // The volume file might contain data not yet committed to the storage device.
+    };
+
+    // The state of each volume in mVolumes.
+    std::vector< VolumeState > mVolumesState;
+
+    // The completed volume being synced in the background (if any), and the result of the sync.
+    // Note: the volume is referenced here, so that it is kept open even if it is evicted during the sync.
+    CMyComPtr< CFileOutStream > mSyncingVolume;
+    std::future< HRESULT > mVolumeSync;
+
+    // The first error returned by the background syncs.
+    HRESULT mSyncResult;
+
     auto currentVolume() -> CachedVolume< CFileOutStream >&;
 
     void ensureVolumeOpen( CachedVolume< CFileOutStream >& cachedVolume, std::size_t volumeIndex );
 
+    auto openVolume( const CachedVolume< CFileOutStream >& cachedVolume, VolumeState& state ) const
+        -> CMyComPtr< CFileOutStream >;
+
+    void syncInBackground( std::size_t volumeIndex );
+
+    void waitVolumeSync() noexcept;
+
     public:
         CMultiVolumeOutStream( std::uint64_t volSize, fs::path archiveName );
 
@@ -54,7 +79,18 @@ class CMultiVolumeOutStream final : public IOutStream, public CMyUnknownImp {
 
         auto operator=( CMultiVolumeOutStream&& ) -> CMultiVolumeOutStream& = delete;
 
-        MY_UNKNOWN_DESTRUCTOR( ~CMultiVolumeOutStream() ) = default;
+        MY_UNKNOWN_DESTRUCTOR( ~CMultiVolumeOutStream() );
+
+        /**
+         * @brief Releases the space reserved beyond the end of the last volume,
+         *        and commits all the written volumes to the storage device.
+         *
+         * @note This is also done when the stream is destroyed, but any error would be lost at that point:
+         *       users must call flush() to check the result.
+         *
+         * @return S_OK on success, or an error HRESULT otherwise.
+         */
+        auto flush() noexcept -> HRESULT;
 
         // IOutStream
         BIT7Z_STDMETHOD( Write, const void* data, UInt32 size, UInt32* processedSize );
@@ -0,0 +1,80 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/coffsetoutstream.hpp"
+
+#include "internal/bufferutil.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace bit7z {
+
+COffsetOutStream::COffsetOutStream( IOutStream* baseStream, std::uint64_t offset )
+    : mBaseStream{ baseStream }, mOffset{ offset }, mPosition{ 0 }, mSize{ 0 }, mSeekPending{ true } {}
+
+auto COffsetOutStream::size() const noexcept -> std::uint64_t {
+    return mSize;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP COffsetOutStream::Write( const void* data, UInt32 size, UInt32* processedSize ) noexcept {
+    if ( processedSize != nullptr ) {
+        *processedSize = 0;
+    }
+
+    if ( mSeekPending ) {
+        RINOK( mBaseStream->Seek( static_cast< Int64 >( mOffset + mPosition ), STREAM_SEEK_SET, nullptr ) ) //-V3504
+        mSeekPending = false;
+    }
+
+    UInt32 writtenSize = 0;
+    const HRESULT result = mBaseStream->Write( data, size, &writtenSize );
+    mPosition += writtenSize;
+    mSize = std::max( mSize, mPosition );
+    if ( processedSize != nullptr ) {
+        *processedSize = writtenSize;
+    }
+    return result;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP COffsetOutStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
+    std::uint64_t seekPosition{};
+    RINOK( seek( mSize, mPosition, offset, seekOrigin, seekPosition ) ) //-V3504
+    if ( seekPosition > static_cast< std::uint64_t >( std::numeric_limits< Int64 >::max() ) - mOffset ) {
+        return E_INVALIDARG;
+    }
+
+    // Note: the base stream is actually moved only when writing, so that seeks without writes cost nothing.
+    mSeekPending = mSeekPending || seekPosition != mPosition;
+    mPosition = seekPosition;
+    if ( newPosition != nullptr ) {
+        *newPosition = mPosition;
+    }
+    return S_OK;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP COffsetOutStream::SetSize( UInt64 newSize ) noexcept {
+    if ( newSize > static_cast< std::uint64_t >( std::numeric_limits< Int64 >::max() ) - mOffset ) {
+        return E_INVALIDARG;
+    }
+    RINOK( mBaseStream->SetSize( mOffset + newSize ) ) //-V3504
+    mSize = newSize;
+
+    // Note: the base stream might have moved its position when resizing.
+    mSeekPending = true;
+    return S_OK;
+}
+
+} // namespace bit7z
@@ -0,0 +1,69 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef COFFSETOUTSTREAM_HPP
+#define COFFSETOUTSTREAM_HPP
+
+#include "internal/com.hpp"
+#include "internal/guids.hpp"
+#include "internal/macros.hpp"
+
+#include <7zip/IStream.h>
+
+#include <cstdint>
+
+namespace bit7z {
+
+/**
+ * An output stream writing to a base stream starting from a fixed offset,
+ * i.e., the position 0 of this stream corresponds to the given offset of the base stream.
+ *
+ * @note The size of the stream is the end of the data written to it (or the size set via SetSize),
+ *       regardless of any data of the base stream beyond the offset.
+ */
+class COffsetOutStream final : public IOutStream, public CMyUnknownImp {
+    public:
+        COffsetOutStream( IOutStream* baseStream, std::uint64_t offset );
+
+        COffsetOutStream( const COffsetOutStream& ) = delete;
+
+        COffsetOutStream( COffsetOutStream&& ) = delete;
+
+        auto operator=( const COffsetOutStream& ) -> COffsetOutStream& = delete;
+
+        auto operator=( COffsetOutStream&& ) -> COffsetOutStream& = delete;
+
+        MY_UNKNOWN_DESTRUCTOR( ~COffsetOutStream() ) = default;
+
+        BIT7Z_NODISCARD
+        auto size() const noexcept -> std::uint64_t;
+
+        // IOutStream
+        BIT7Z_STDMETHOD( Write, void const* data, UInt32 size, UInt32* processedSize );
+
+        BIT7Z_STDMETHOD( Seek, Int64 offset, UInt32 seekOrigin, UInt64* newPosition );
+
+        BIT7Z_STDMETHOD( SetSize, UInt64 newSize );
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( IOutStream ) //-V2507 //-V2511 //-V835 //-V3504
+
+    private:
+        CMyComPtr< IOutStream > mBaseStream;
+        std::uint64_t mOffset;
+        std::uint64_t mPosition;
+        std::uint64_t mSize;
+
+        // Whether the position of the base stream must be moved to mPosition before writing.
+        bool mSeekPending;
+};
+
+} // namespace bit7z
+
+#endif // COFFSETOUTSTREAM_HPP
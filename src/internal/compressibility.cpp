@@ -0,0 +1,119 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/compressibility.hpp"
+
+#include "bitexception.hpp"
+#include "internal/filehandle.hpp"
+#include "internal/fsutil.hpp"
+#include "internal/stringutil.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace bit7z {
+
+namespace {
+// The extensions of file types whose content is already compressed (lowercase, without the dot).
+constexpr std::array< const tchar*, 44 > kIncompressibleExtensions = {
+    // Archives and compressed files
+    BIT7Z_STRING( "7z" ), BIT7Z_STRING( "apk" ), BIT7Z_STRING( "br" ), BIT7Z_STRING( "bz2" ),
+    BIT7Z_STRING( "cab" ), BIT7Z_STRING( "gz" ), BIT7Z_STRING( "jar" ), BIT7Z_STRING( "lz4" ),
+    BIT7Z_STRING( "lzma" ), BIT7Z_STRING( "rar" ), BIT7Z_STRING( "tgz" ), BIT7Z_STRING( "txz" ),
+    BIT7Z_STRING( "xz" ), BIT7Z_STRING( "zip" ), BIT7Z_STRING( "zst" ),
+    // Office documents (zip-based)
+    BIT7Z_STRING( "docx" ), BIT7Z_STRING( "odp" ), BIT7Z_STRING( "ods" ), BIT7Z_STRING( "odt" ),
+    BIT7Z_STRING( "pptx" ), BIT7Z_STRING( "xlsx" ),
+    // Images
+    BIT7Z_STRING( "avif" ), BIT7Z_STRING( "gif" ), BIT7Z_STRING( "heic" ), BIT7Z_STRING( "jpeg" ),
+    BIT7Z_STRING( "jpg" ), BIT7Z_STRING( "jxl" ), BIT7Z_STRING( "png" ), BIT7Z_STRING( "webp" ),
+    // Audio
+    BIT7Z_STRING( "aac" ), BIT7Z_STRING( "flac" ), BIT7Z_STRING( "m4a" ), BIT7Z_STRING( "mp3" ),
+    BIT7Z_STRING( "ogg" ), BIT7Z_STRING( "opus" ), BIT7Z_STRING( "wma" ),
+    // Video
+    BIT7Z_STRING( "avi" ), BIT7Z_STRING( "m4v" ), BIT7Z_STRING( "mkv" ), BIT7Z_STRING( "mov" ),
+    BIT7Z_STRING( "mp4" ), BIT7Z_STRING( "webm" ), BIT7Z_STRING( "wmv" ),
+    // Encrypted files
+    BIT7Z_STRING( "gpg" )
+};
+
+// The size of the first block of a file which is used for estimating its entropy.
+constexpr std::uint32_t kProbeBlockSize = 64U * 1024U;
+
+// Below this size, the entropy estimation is not reliable.
+constexpr std::uint32_t kMinProbeSize = 4U * 1024U;
+
+// Compressed and encrypted data have an entropy very close to 8 bits per byte.
+constexpr double kIncompressibleEntropy = 7.9;
+
+auto toLowerAscii( tchar character ) -> tchar {
+    return character >= 'A' && character <= 'Z' ? static_cast< tchar >( character - 'A' + 'a' ) : character;
+}
+} // namespace
+
+auto hasIncompressibleExtension( const native_string& filePath ) -> bool {
+    auto extension = filesystem::fsutil::extension( fs::path{ filePath } );
+    if ( extension.empty() ) {
+        return false;
+    }
+    std::transform( extension.cbegin(), extension.cend(), extension.begin(), toLowerAscii );
+    return std::find_if( kIncompressibleExtensions.cbegin(), kIncompressibleExtensions.cend(),
+                         [ &extension ]( const tchar* incompressibleExtension ) -> bool {
+                             return extension == incompressibleExtension;
+                         } ) != kIncompressibleExtensions.cend();
+}
+
+auto contentEntropy( const void* data, std::size_t size ) noexcept -> double {
+    if ( size == 0 ) {
+        return 0.0;
+    }
+
+    std::array< std::size_t, 256 > frequencies{};
+    const auto* bytes = static_cast< const unsigned char* >( data );
+    for ( std::size_t index = 0; index < size; ++index ) {
+        ++frequencies[ bytes[ index ] ]; // NOLINT(*-pointer-arithmetic)
+    }
+
+    double entropy = 0.0;
+    const auto totalCount = static_cast< double >( size );
+    for ( const auto frequency : frequencies ) {
+        if ( frequency > 0 ) {
+            const double probability = static_cast< double >( frequency ) / totalCount;
+            entropy -= probability * std::log2( probability );
+        }
+    }
+    return entropy;
+}
+
+auto hasIncompressibleContent( const native_string& filePath ) -> bool {
+    const InputFile inputFile{ filePath };
+
+    std::vector< unsigned char > block( kProbeBlockSize );
+    std::uint32_t blockSize = 0;
+    while ( blockSize < kProbeBlockSize ) {
+        std::uint32_t bytesRead = 0;
+        const auto result = inputFile.read( &block[ blockSize ], kProbeBlockSize - blockSize, bytesRead );
+        if ( result != S_OK ) {
+            throw BitException( "Could not read the file", make_hresult_code( result ), to_tstring( filePath ) );
+        }
+        if ( bytesRead == 0 ) {
+            break;
+        }
+        blockSize += bytesRead;
+    }
+    return blockSize >= kMinProbeSize && contentEntropy( block.data(), blockSize ) >= kIncompressibleEntropy;
+}
+
+} // namespace bit7z
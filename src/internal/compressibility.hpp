@@ -0,0 +1,46 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef COMPRESSIBILITY_HPP
+#define COMPRESSIBILITY_HPP
+
+#include "bitdefines.hpp"
+#include "bittypes.hpp"
+
+#include <cstddef>
+
+namespace bit7z {
+
+/**
+ * @return true if the given file path has the extension of an already compressed file type
+ *         (e.g., archives, images, audio, and video files).
+ */
+BIT7Z_NODISCARD
+auto hasIncompressibleExtension( const native_string& filePath ) -> bool;
+
+/**
+ * @return the Shannon entropy of the given data, in bits per byte (i.e., a value in the range [0, 8]).
+ */
+BIT7Z_NODISCARD
+auto contentEntropy( const void* data, std::size_t size ) noexcept -> double;
+
+/**
+ * Checks whether the first block of the given file looks like random data (e.g., compressed or encrypted data).
+ *
+ * @note Files smaller than a few kilobytes are always considered compressible, as their entropy
+ *       cannot be estimated reliably (and compressing them is cheap anyway).
+ *
+ * @return true if the file's content is likely incompressible.
+ */
+BIT7Z_NODISCARD
+auto hasIncompressibleContent( const native_string& filePath ) -> bool;
+
+} // namespace bit7z
+
+#endif //COMPRESSIBILITY_HPP
@@ -0,0 +1,190 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/contenthash.hpp"
+
+#include "bitexception.hpp"
+#include "internal/filehandle.hpp"
+#include "internal/stringutil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace bit7z {
+
+namespace {
+constexpr std::uint64_t kMultiplier1 = 0x87C37B91114253D5ULL;
+constexpr std::uint64_t kMultiplier2 = 0x4CF5AD432745937FULL;
+
+constexpr std::uint32_t kReadChunkSize = 64U * 1024U;
+
+// Reads the next chunk of the given file, filling the whole buffer unless the end of the file is reached.
+auto readChunk( const InputFile& inputFile, const native_string& filePath, std::vector< unsigned char >& buffer )
+    -> std::uint32_t {
+    std::uint32_t totalRead = 0;
+    while ( totalRead < buffer.size() ) {
+        std::uint32_t bytesRead = 0;
+        const auto result = inputFile.read( buffer.data() + totalRead,
+                                            static_cast< std::uint32_t >( buffer.size() ) - totalRead,
+                                            bytesRead );
+        if ( result != S_OK ) {
+            throw BitException( "Could not read the file", make_hresult_code( result ), to_tstring( filePath ) );
+        }
+        if ( bytesRead == 0 ) {
+            break;
+        }
+        totalRead += bytesRead;
+    }
+    return totalRead;
+}
+
+constexpr auto rotateLeft( std::uint64_t value, unsigned shift ) noexcept -> std::uint64_t {
+    return ( value << shift ) | ( value >> ( 64U - shift ) );
+}
+
+constexpr auto finalMix( std::uint64_t value ) noexcept -> std::uint64_t {
+    value ^= value >> 33U;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33U;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33U;
+    return value;
+}
+
+// Note: reading the bytes one by one makes the hash independent of the machine's endianness.
+auto loadLittleEndian( const unsigned char* data, std::size_t size ) noexcept -> std::uint64_t {
+    std::uint64_t result = 0;
+    for ( std::size_t index = size; index > 0; --index ) {
+        result = ( result << 8U ) | data[ index - 1 ];
+    }
+    return result;
+}
+
+constexpr auto mixFirstKey( std::uint64_t key ) noexcept -> std::uint64_t {
+    return rotateLeft( key * kMultiplier1, 31U ) * kMultiplier2;
+}
+
+constexpr auto mixSecondKey( std::uint64_t key ) noexcept -> std::uint64_t {
+    return rotateLeft( key * kMultiplier2, 33U ) * kMultiplier1;
+}
+} // namespace
+
+auto operator==( const ContentHash& first, const ContentHash& second ) noexcept -> bool {
+    return first.low == second.low && first.high == second.high;
+}
+
+auto operator!=( const ContentHash& first, const ContentHash& second ) noexcept -> bool {
+    return !( first == second );
+}
+
+auto ContentHashHasher::operator()( const ContentHash& hash ) const noexcept -> std::size_t {
+    // The hash bits are already well distributed, so we can just use them.
+    return static_cast< std::size_t >( hash.low ^ hash.high );
+}
+
+void ContentHasher::processBlock( const unsigned char* block ) noexcept {
+    mHash1 ^= mixFirstKey( loadLittleEndian( block, 8 ) );
+    mHash1 = rotateLeft( mHash1, 27U ) + mHash2;
+    mHash1 = ( mHash1 * 5U ) + 0x52DCE729U;
+
+    mHash2 ^= mixSecondKey( loadLittleEndian( block + 8, 8 ) ); // NOLINT(*-pointer-arithmetic)
+    mHash2 = rotateLeft( mHash2, 31U ) + mHash1;
+    mHash2 = ( mHash2 * 5U ) + 0x38495AB5U;
+}
+
+void ContentHasher::update( const void* data, std::size_t size ) noexcept {
+    const auto* bytes = static_cast< const unsigned char* >( data );
+    mTotalSize += size;
+
+    if ( mPendingSize > 0 ) {
+        const auto count = std::min( size, kBlockSize - mPendingSize );
+        std::copy_n( bytes, count, mPending.begin() + static_cast< std::ptrdiff_t >( mPendingSize ) );
+        mPendingSize += count;
+        bytes += count; // NOLINT(*-pointer-arithmetic)
+        size -= count;
+        if ( mPendingSize < kBlockSize ) {
+            return;
+        }
+        processBlock( mPending.data() );
+        mPendingSize = 0;
+    }
+
+    for ( ; size >= kBlockSize; size -= kBlockSize ) {
+        processBlock( bytes );
+        bytes += kBlockSize; // NOLINT(*-pointer-arithmetic)
+    }
+
+    std::copy_n( bytes, size, mPending.begin() );
+    mPendingSize = size;
+}
+
+auto ContentHasher::finalize() const noexcept -> ContentHash {
+    auto hash1 = mHash1;
+    auto hash2 = mHash2;
+
+    if ( mPendingSize > 8 ) {
+        hash2 ^= mixSecondKey( loadLittleEndian( mPending.data() + 8, mPendingSize - 8 ) );
+    }
+    if ( mPendingSize > 0 ) {
+        hash1 ^= mixFirstKey( loadLittleEndian( mPending.data(), std::min< std::size_t >( mPendingSize, 8 ) ) );
+    }
+
+    hash1 ^= mTotalSize;
+    hash2 ^= mTotalSize;
+    hash1 += hash2;
+    hash2 += hash1;
+    hash1 = finalMix( hash1 );
+    hash2 = finalMix( hash2 );
+    hash1 += hash2;
+    hash2 += hash1;
+    return ContentHash{ hash1, hash2 };
+}
+
+auto hashFileContent( const native_string& filePath ) -> ContentHash {
+    const InputFile inputFile{ filePath };
+
+    ContentHasher hasher;
+    std::vector< unsigned char > buffer( kReadChunkSize );
+    while ( true ) {
+        std::uint32_t bytesRead = 0;
+        const auto result = inputFile.read( buffer.data(), kReadChunkSize, bytesRead );
+        if ( result != S_OK ) {
+            throw BitException( "Could not read the file", make_hresult_code( result ), to_tstring( filePath ) );
+        }
+        if ( bytesRead == 0 ) {
+            break;
+        }
+        hasher.update( buffer.data(), bytesRead );
+    }
+    return hasher.finalize();
+}
+
+auto isSameFileContent( const native_string& firstPath, const native_string& secondPath ) -> bool {
+    const InputFile firstFile{ firstPath };
+    const InputFile secondFile{ secondPath };
+
+    std::vector< unsigned char > firstBuffer( kReadChunkSize );
+    std::vector< unsigned char > secondBuffer( kReadChunkSize );
+    while ( true ) {
+        const auto firstRead = readChunk( firstFile, firstPath, firstBuffer );
+        const auto secondRead = readChunk( secondFile, secondPath, secondBuffer );
+        if ( firstRead != secondRead ||
+             !std::equal( firstBuffer.cbegin(), firstBuffer.cbegin() + firstRead, secondBuffer.cbegin() ) ) {
+            return false;
+        }
+        if ( firstRead < kReadChunkSize ) {
+            return true;
+        }
+    }
+}
+
+} // namespace bit7z
@@ -0,0 +1,83 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CONTENTHASH_HPP
+#define CONTENTHASH_HPP
+
+#include "bitdefines.hpp"
+#include "bittypes.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace bit7z {
+
+/**
+ * A 128-bit hash of some content, used for detecting identical input files.
+ */
+struct ContentHash final {
+    std::uint64_t low;
+    std::uint64_t high;
+};
+
+BIT7Z_NODISCARD
+auto operator==( const ContentHash& first, const ContentHash& second ) noexcept -> bool;
+
+BIT7Z_NODISCARD
+auto operator!=( const ContentHash& first, const ContentHash& second ) noexcept -> bool;
+
+struct ContentHashHasher final {
+    auto operator()( const ContentHash& hash ) const noexcept -> std::size_t;
+};
+
+/**
+ * Incrementally computes the MurmurHash3 (x64, 128-bit) hash of some content.
+ *
+ * @note This is a fast non-cryptographic hash: it must not be used where the content might be crafted
+ *       to produce collisions on purpose.
+ */
+class ContentHasher final {
+    public:
+        ContentHasher() = default;
+
+        void update( const void* data, std::size_t size ) noexcept;
+
+        BIT7Z_NODISCARD
+        auto finalize() const noexcept -> ContentHash;
+
+    private:
+        static constexpr std::size_t kBlockSize = 16;
+
+        std::uint64_t mHash1{ 0 };
+        std::uint64_t mHash2{ 0 };
+        std::uint64_t mTotalSize{ 0 };
+
+        // The bytes of the last incomplete block.
+        std::array< unsigned char, kBlockSize > mPending{};
+        std::size_t mPendingSize{ 0 };
+
+        void processBlock( const unsigned char* block ) noexcept;
+};
+
+/**
+ * @return the hash of the content of the file at the given path.
+ */
+BIT7Z_NODISCARD
+auto hashFileContent( const native_string& filePath ) -> ContentHash;
+
+/**
+ * @return whether the files at the given paths have exactly the same content, compared byte by byte.
+ */
+BIT7Z_NODISCARD
+auto isSameFileContent( const native_string& firstPath, const native_string& secondPath ) -> bool;
+
+} // namespace bit7z
+
+#endif //CONTENTHASH_HPP
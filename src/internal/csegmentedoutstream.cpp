@@ -0,0 +1,73 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/csegmentedoutstream.hpp"
+
+#include "bittypes.hpp"
+#include "internal/bufferutil.hpp"
+
+namespace bit7z {
+
+CSegmentedOutStream::CSegmentedOutStream( BitSegmentedBuffer& outBuffer )
+    : mBuffer( outBuffer ), mCurrentPosition{ 0 } {}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CSegmentedOutStream::SetSize( UInt64 newSize ) noexcept {
+    try {
+        mBuffer.resize( newSize );
+        return S_OK;
+    } catch ( ... ) {
+        return E_OUTOFMEMORY;
+    }
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CSegmentedOutStream::Seek( Int64 offset, UInt32 seekOrigin, UInt64* newPosition ) noexcept {
+    std::uint64_t seekIndex{};
+    RINOK( seek( mBuffer.size(), mCurrentPosition, offset, seekOrigin, seekIndex ) ) //-V3504
+
+    // Note: like for files, seeking past the end is allowed; the gap is zero-filled by the next write.
+    mCurrentPosition = seekIndex;
+
+    if ( newPosition != nullptr ) {
+        *newPosition = seekIndex;
+    }
+
+    return S_OK;
+}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CSegmentedOutStream::Write( const void* data, UInt32 size, UInt32* processedSize ) noexcept {
+    if ( processedSize != nullptr ) {
+        *processedSize = 0;
+    }
+
+    if ( data == nullptr || size == 0 ) {
+        return E_FAIL;
+    }
+
+    try {
+        mBuffer.write( mCurrentPosition, static_cast< const byte_t* >( data ), size ); //-V2571
+    } catch ( ... ) {
+        return E_OUTOFMEMORY;
+    }
+
+    mCurrentPosition += size;
+
+    if ( processedSize != nullptr ) {
+        *processedSize = size;
+    }
+
+    return S_OK;
+}
+
+} // namespace bit7z
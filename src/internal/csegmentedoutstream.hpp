@@ -0,0 +1,55 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CSEGMENTEDOUTSTREAM_HPP
+#define CSEGMENTEDOUTSTREAM_HPP
+
+#include "bitsegmentedbuffer.hpp"
+#include "internal/com.hpp"
+#include "internal/guids.hpp"
+#include "internal/macros.hpp"
+
+#include <7zip/IStream.h>
+
+#include <cstdint>
+
+namespace bit7z {
+
+class CSegmentedOutStream final : public IOutStream, public CMyUnknownImp {
+    public:
+        explicit CSegmentedOutStream( BitSegmentedBuffer& outBuffer );
+
+        CSegmentedOutStream( const CSegmentedOutStream& ) = delete;
+
+        CSegmentedOutStream( CSegmentedOutStream&& ) = delete;
+
+        auto operator=( const CSegmentedOutStream& ) -> CSegmentedOutStream& = delete;
+
+        auto operator=( CSegmentedOutStream&& ) -> CSegmentedOutStream& = delete;
+
+        MY_UNKNOWN_DESTRUCTOR( ~CSegmentedOutStream() ) = default;
+
+        // IOutStream
+        BIT7Z_STDMETHOD( Write, const void* data, UInt32 size, UInt32* processedSize );
+
+        BIT7Z_STDMETHOD( Seek, Int64 offset, UInt32 seekOrigin, UInt64* newPosition );
+
+        BIT7Z_STDMETHOD( SetSize, UInt64 newSize );
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( IOutStream ) //-V2507 //-V2511 //-V835 //-V3504
+
+    private:
+        BitSegmentedBuffer& mBuffer;
+        std::uint64_t mCurrentPosition;
+};
+
+} // namespace bit7z
+
+#endif // CSEGMENTEDOUTSTREAM_HPP
@@ -0,0 +1,46 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/cstdsequentialoutstream.hpp"
+
+#include "internal/cpp26.hpp"
+
+#include <ostream>
+
+namespace bit7z {
+
+CStdSequentialOutStream::CStdSequentialOutStream( std::ostream& outputStream ) : mOutputStream( outputStream ) {}
+
+COM_DECLSPEC_NOTHROW
+STDMETHODIMP CStdSequentialOutStream::Write( const void* data, UInt32 size, UInt32* processedSize ) noexcept {
+    if ( processedSize != nullptr ) {
+        *processedSize = 0;
+    }
+
+    if ( size == 0 ) {
+        return S_OK;
+    }
+
+    // Note: non-seekable streams have no position, so we can't use tellp() for computing the written size.
+    mOutputStream.write( static_cast< const char* >( data ), cpp26::saturating_cast< std::streamsize >( size ) ); //-V2571
+    if ( !mOutputStream ) {
+        return HRESULT_FROM_WIN32( ERROR_WRITE_FAULT );
+    }
+
+    if ( processedSize != nullptr ) {
+        *processedSize = size;
+    }
+
+    return S_OK;
+}
+
+} // namespace bit7z
@@ -0,0 +1,55 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+
+#ifndef CSTDSEQUENTIALOUTSTREAM_HPP
+#define CSTDSEQUENTIALOUTSTREAM_HPP
+
+#include "internal/com.hpp"
+#include "internal/guids.hpp"
+#include "internal/macros.hpp"
+
+#include <7zip/IStream.h>
+
+#include <ostream>
+
+namespace bit7z {
+
+/**
+ * A write-only stream over a std::ostream which, unlike CStdOutStream, does not expose the IOutStream interface:
+ * 7-Zip's handlers of the formats supporting it will write the archive sequentially, without ever seeking back.
+ * Hence, it can be used for writing to non-seekable streams (e.g., pipes and sockets).
+ */
+class CStdSequentialOutStream final : public ISequentialOutStream, public CMyUnknownImp {
+    public:
+        explicit CStdSequentialOutStream( std::ostream& outputStream );
+
+        CStdSequentialOutStream( const CStdSequentialOutStream& ) = delete;
+
+        CStdSequentialOutStream( CStdSequentialOutStream&& ) = delete;
+
+        auto operator=( const CStdSequentialOutStream& ) -> CStdSequentialOutStream& = delete;
+
+        auto operator=( CStdSequentialOutStream&& ) -> CStdSequentialOutStream& = delete;
+
+        MY_UNKNOWN_DESTRUCTOR( ~CStdSequentialOutStream() ) = default;
+
+        // ISequentialOutStream
+        BIT7Z_STDMETHOD( Write, void const* data, UInt32 size, UInt32* processedSize );
+
+        // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
+        MY_UNKNOWN_IMP1( ISequentialOutStream ) //-V2507 //-V2511 //-V835 //-V3504
+
+    private:
+        std::ostream& mOutputStream;
+};
+
+} // namespace bit7z
+
+#endif // CSTDSEQUENTIALOUTSTREAM_HPP
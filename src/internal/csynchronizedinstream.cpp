@@ -10,11 +10,14 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
+#include "biterror.hpp"
 #include "bitexception.hpp"
 #include "internal/csynchronizedinstream.hpp"
 #include "internal/extractcallback.hpp"
+#include "internal/fsutil.hpp"
 
 #include <algorithm> // For std::copy_n
+#include <utility>
 
 #if defined( _MSC_VER ) && _MSC_VER <= 1900 && !defined( _SCL_SECURE_NO_WARNINGS )
 #   define _SCL_SECURE_NO_WARNINGS
@@ -22,6 +25,20 @@
 
 namespace bit7z {
 
+namespace {
+auto isNestedItem( const BitArchiveItem& item, const tstring& itemPath ) -> bool {
+    if ( item.isDir() ) {
+        return false;
+    }
+    // Like BitInputArchive::find, on Windows we compare the paths element-wise to support both path separators.
+#ifdef _WIN32
+    return fs::path{ item.nativePath() } == tstringToPath( itemPath );
+#else
+    return item.path() == itemPath;
+#endif
+}
+} // namespace
+
 CSynchronizedInStream::CSynchronizedInStream(
     std::uint64_t maxMemoryUsage,
     const BitInputArchive& parentArchive,
@@ -29,6 +46,21 @@ CSynchronizedInStream::CSynchronizedInStream(
 ) : mBufferQueue{ maxMemoryUsage },
     mParentArchive{ parentArchive },
     mIndex{ index },
+    mItemFound{ false },
+    mExtractionStarted{ false },
+    mExtractionFinished{ false } {
+    mCurrentReadPosition = mReadBuffer.begin();
+}
+
+CSynchronizedInStream::CSynchronizedInStream(
+    std::uint64_t maxMemoryUsage,
+    const BitInputArchive& parentArchive,
+    tstring itemPath
+) : mBufferQueue{ maxMemoryUsage },
+    mParentArchive{ parentArchive },
+    mIndex{ 0 },
+    mItemPath{ std::move( itemPath ) },
+    mItemFound{ false },
     mExtractionStarted{ false },
     mExtractionFinished{ false } {
     mCurrentReadPosition = mReadBuffer.begin();
@@ -44,17 +76,18 @@ STDMETHODIMP CSynchronizedInStream::Read( void* data, UInt32 size, UInt32* proce
         return S_OK;
     }
 
-    if ( !mExtractionStarted ) {
-        mExtractionStarted = true;
-        mExtractorThread = std::thread( &CSynchronizedInStream::extractParentArchive, this );
-    }
+    startExtraction();
 
     if ( mCurrentReadPosition == mReadBuffer.end() ) {
         mReadBuffer = mBufferQueue.pop();
         mCurrentReadPosition = mReadBuffer.begin();
 
         if ( mReadBuffer.empty() ) {
-            return S_OK;
+            if ( mBufferQueue.cancelled() ) {
+                return E_ABORT;
+            }
+            // The extraction of the parent archive ended: it is the end of the stream only if it succeeded.
+            return mExtractionError ? E_FAIL : S_OK;
         }
     }
 
@@ -70,18 +103,102 @@ STDMETHODIMP CSynchronizedInStream::Read( void* data, UInt32 size, UInt32* proce
     return S_OK;
 }
 
+auto CSynchronizedInStream::peek( std::size_t size ) -> const buffer_t& {
+    startExtraction();
+
+    while ( mReadBuffer.size() < size ) {
+        const auto buffer = mBufferQueue.pop();
+        if ( buffer.empty() ) {
+            break;
+        }
+        mReadBuffer.insert( mReadBuffer.end(), buffer.cbegin(), buffer.cend() );
+    }
+    // The peeked data will be read again from the beginning.
+    mCurrentReadPosition = mReadBuffer.begin();
+    return mReadBuffer;
+}
+
 CSynchronizedInStream::~CSynchronizedInStream() {
+    // Note: the stream might be released before the extraction of the parent archive ends
+    // (e.g., the nested archive was reopened); without cancelling it, the extractor thread
+    // would wait forever for the queue to have room for new data.
+    cancel();
+    waitExtraction();
+}
+
+void CSynchronizedInStream::cancel() noexcept {
+    mBufferQueue.cancel();
+}
+
+void CSynchronizedInStream::waitExtraction() noexcept {
     if ( mExtractorThread.joinable() ) {
         mExtractorThread.join();
     }
 }
 
+auto CSynchronizedInStream::extractionError() const noexcept -> std::exception_ptr {
+    return mExtractionError;
+}
+
+void CSynchronizedInStream::setAdaptiveMemoryUsage( std::uint64_t minMemoryUsage, std::uint64_t maxMemoryUsage ) {
+    mBufferQueue.setAdaptiveLimits( minMemoryUsage, maxMemoryUsage );
+}
+
+auto CSynchronizedInStream::bufferingMetrics() const -> BufferingMetrics {
+    return mBufferQueue.metrics();
+}
+
+void CSynchronizedInStream::startExtraction() {
+    if ( !mExtractionStarted ) {
+        mExtractionStarted = true;
+        mExtractorThread = std::thread( &CSynchronizedInStream::extractParentArchive, this );
+    }
+}
+
 void CSynchronizedInStream::extractParentArchive() try {
-    mParentArchive.extractSequentially( mBufferQueue, mIndex );
+    if ( mItemPath.empty() ) {
+        mParentArchive.extractSequentially( mBufferQueue, mIndex );
+    } else {
+        extractParentItem();
+    }
     mBufferQueue.notifyFinished();
-} catch ( const BitException& /*ex*/ ) {
-    // TODO: Error handling
+} catch ( ... ) {
+    // If the stream was cancelled, the error is just a consequence of the cancellation.
+    if ( !mBufferQueue.cancelled() ) {
+        mExtractionError = std::current_exception();
+    }
     mBufferQueue.notifyFinished();
 }
 
+void CSynchronizedInStream::extractParentItem() {
+    try {
+        mParentArchive.extractSequentially(
+            mBufferQueue,
+            [ this ]( const BitArchiveItem& item ) -> FilterResult {
+                if ( mItemFound ) {
+                    // The nested item was already streamed: no need to decode the rest of the parent archive.
+                    return FilterResult::AbortOperation;
+                }
+                if ( !isNestedItem( item, mItemPath ) ) {
+                    return FilterResult::SkipItem;
+                }
+                mItemFound = true;
+                return FilterResult::ProcessItem;
+            }
+        );
+    } catch ( const BitException& ex ) {
+        if ( !mItemFound || ex.hresultCode() != E_ABORT ) {
+            throw;
+        }
+    }
+
+    if ( !mItemFound ) {
+        throw BitException(
+            "Could not find the nested archive",
+            make_error_code( BitError::NoMatchingItems ),
+            mItemPath
+        );
+    }
+}
+
 } // namespace bit7z
@@ -18,6 +18,8 @@
 
 #include <7zip/IStream.h>
 
+#include <atomic>
+#include <exception>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -32,6 +34,14 @@ class CSynchronizedInStream final : public ISequentialInStream, public CMyUnknow
             std::uint32_t index
         );
 
+        /* Streams the first item of the (sequentially opened) parent archive having the given path:
+         * the parent archive is read only once, since its items don't need to be listed beforehand. */
+        explicit CSynchronizedInStream(
+            std::uint64_t maxMemoryUsage,
+            const BitInputArchive& parentArchive,
+            tstring itemPath
+        );
+
         explicit CSynchronizedInStream( const CSynchronizedInStream& ) = delete;
 
         CSynchronizedInStream( CSynchronizedInStream&& ) = delete;
@@ -45,19 +55,68 @@ class CSynchronizedInStream final : public ISequentialInStream, public CMyUnknow
         // ISequentialInStream
         BIT7Z_STDMETHOD( Read, void* data, UInt32 size, UInt32* processedSize );
 
+        /**
+         * @brief Reads the first bytes of the stream (at most the given size) without consuming them,
+         *        i.e., they will be returned again by the next calls to Read.
+         *
+         * @note It must be called before reading from the stream.
+         *
+         * @param size the number of bytes to be peeked.
+         *
+         * @return the peeked bytes (fewer than requested if the stream ended before).
+         */
+        auto peek( std::size_t size ) -> const buffer_t&;
+
+        /**
+         * @brief Stops the extraction of the parent archive (if running), without waiting for it to end.
+         *
+         * Any pending or future read from the stream fails with E_ABORT.
+         */
+        void cancel() noexcept;
+
+        /**
+         * @brief Waits for the extraction of the parent archive to end.
+         */
+        void waitExtraction() noexcept;
+
+        /**
+         * @return the error that made the extraction of the parent archive fail, if any.
+         *
+         * @note Errors caused by the cancellation of the stream are not reported.
+         */
+        BIT7Z_NODISCARD
+        auto extractionError() const noexcept -> std::exception_ptr;
+
+        /**
+         * @brief Enables the adaptive sizing of the buffers, within the given memory bounds.
+         *
+         * @note It must be called before starting to read from the stream.
+         */
+        void setAdaptiveMemoryUsage( std::uint64_t minMemoryUsage, std::uint64_t maxMemoryUsage );
+
+        BIT7Z_NODISCARD
+        auto bufferingMetrics() const -> BufferingMetrics;
+
         // NOLINTNEXTLINE(modernize-use-noexcept, modernize-use-trailing-return-type, readability-identifier-length)
         MY_UNKNOWN_IMP1( ISequentialInStream ); //-V2507 //-V2511 //-V835 //-V3504
 
     private:
+        void startExtraction();
+
         void extractParentArchive();
 
+        void extractParentItem();
+
         BufferQueue mBufferQueue;
         const BitInputArchive& mParentArchive;
         uint32_t mIndex;
+        tstring mItemPath;
+        bool mItemFound;
 
         std::thread mExtractorThread;
         std::atomic_bool mExtractionStarted;
         std::atomic_bool mExtractionFinished;
+        std::exception_ptr mExtractionError;
 
         buffer_t mReadBuffer;
         buffer_t::iterator mCurrentReadPosition;
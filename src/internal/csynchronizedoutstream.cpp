@@ -41,7 +41,9 @@ STDMETHODIMP CSynchronizedOutStream::Write( const void* data, UInt32 size, UInt3
 
     try {
         buffer_t extractedData( data_start, data_end );
-        mBufferQueue.push( std::move( extractedData ) );
+        if ( !mBufferQueue.push( std::move( extractedData ) ) ) {
+            return E_ABORT; // The reading side of the queue was cancelled.
+        }
     } catch ( ... ) {
         return E_OUTOFMEMORY;
     }
@@ -13,13 +13,19 @@
 #include "filehandle.hpp"
 
 #include "bitexception.hpp"
+#include "internal/cpp20.hpp"
 #include "internal/cpp26.hpp"
 #include "internal/fsutil.hpp"
 #include "internal/util.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #ifdef _WIN32
 #include "bitwindows.hpp" // For FILE_ATTRIBUTE_TAG_INFO and GetFileInformationByHandleEx.
 #else
+#include <sys/file.h> // For flock
+#include <sys/mman.h> // For mmap, munmap, and madvise
 #include <sys/stat.h> // For S_IRUSR and S_IWUSR
 #include <unistd.h>
 
@@ -137,6 +143,31 @@ auto FileHandle::seek(
     return S_OK;
 }
 
+#ifdef _WIN32
+namespace {
+// Note: Windows byte-range locks are mandatory, so we lock a byte that no archive file will ever reach.
+constexpr DWORD kLockOffsetHigh = 0x7FFFFFFF;
+constexpr DWORD kLockOffsetLow = 0xFFFFFFFE;
+} // namespace
+#endif
+
+auto FileHandle::lock( bool wait ) const noexcept -> bool {
+#ifdef _WIN32
+    OVERLAPPED overlapped{};
+    overlapped.Offset = kLockOffsetLow;
+    overlapped.OffsetHigh = kLockOffsetHigh;
+    const DWORD flags = wait ? LOCKFILE_EXCLUSIVE_LOCK : LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY;
+    return ::LockFileEx( mHandle, flags, 0, 1, 0, &overlapped ) != FALSE;
+#else
+    const int operation = wait ? LOCK_EX : LOCK_EX | LOCK_NB;
+    int result = 0;
+    do {
+        result = flock( mHandle, operation );
+    } while ( result != 0 && errno == EINTR );
+    return result == 0;
+#endif
+}
+
 namespace {
 constexpr auto makeOpenFlags( AccessFlag access, FileFlag fileFlag, ExtraFlag extraFlag ) noexcept -> OpenFlags {
 #ifdef _WIN32
@@ -208,6 +239,30 @@ auto OutputFile::resize( std::uint64_t newSize ) const noexcept -> bool {
 #endif
 }
 
+// Note: preallocating is only an optimization, so we ignore any error (e.g., not supported by the file system).
+void OutputFile::preallocate( BIT7Z_MAYBE_UNUSED std::uint64_t size ) const noexcept {
+#ifdef _WIN32
+    FILE_ALLOCATION_INFO allocationInfo{};
+    allocationInfo.AllocationSize.QuadPart = static_cast< LONGLONG >( size );
+    static_cast< void >(
+        ::SetFileInformationByHandle( mHandle, FileAllocationInfo, &allocationInfo, sizeof( allocationInfo ) )
+    );
+#elif defined( FALLOC_FL_KEEP_SIZE )
+    static_cast< void >( fallocate( mHandle, FALLOC_FL_KEEP_SIZE, 0, static_cast< off_t >( size ) ) );
+#endif
+}
+
+auto OutputFile::sync() const noexcept -> HRESULT {
+#ifdef _WIN32
+    const bool synced = ::FlushFileBuffers( mHandle ) != FALSE;
+#elif defined( __APPLE__ )
+    const bool synced = fsync( mHandle ) == 0;
+#else
+    const bool synced = fdatasync( mHandle ) == 0;
+#endif
+    return synced ? S_OK : HRESULT_FROM_WIN32( GetLastError() );
+}
+
 #ifdef _WIN32
 auto OutputFile::setFileTime( FILETIME creation, FILETIME access, FILETIME modified ) const noexcept -> bool {
     return ::SetFileTime( mHandle, &creation, &access, &modified ) != FALSE;
@@ -274,4 +329,97 @@ auto InputFile::read( void* data, std::uint32_t size, std::uint32_t& processedSi
     return S_OK;
 }
 
+// Note: the hints are only advisory, so we ignore any error.
+void InputFile::adviseSequentialAccess() const noexcept {
+#ifdef POSIX_FADV_SEQUENTIAL
+    static_cast< void >( posix_fadvise( mHandle, 0, 0, POSIX_FADV_SEQUENTIAL ) );
+#endif
+}
+
+void InputFile::adviseWillNeed(
+    BIT7Z_MAYBE_UNUSED std::uint64_t offset,
+    BIT7Z_MAYBE_UNUSED std::uint64_t length
+) const noexcept {
+#ifdef POSIX_FADV_WILLNEED
+    const auto advisedOffset = static_cast< off_t >( offset );
+    const auto advisedLength = static_cast< off_t >( length );
+    static_cast< void >( posix_fadvise( mHandle, advisedOffset, advisedLength, POSIX_FADV_WILLNEED ) );
+#endif
+}
+
+namespace {
+auto mappingSize( const InputFile& file ) -> std::uint64_t {
+    std::uint64_t fileSize = 0;
+    const auto result = file.seek( SeekOrigin::End, 0, fileSize );
+    if ( result != S_OK ) {
+        throw BitException( "Could not get the size of the file", make_hresult_code( result ) );
+    }
+    if ( cpp20::cmp_greater( fileSize, std::numeric_limits< std::size_t >::max() ) ) {
+        throw BitException( "Could not map the file", std::make_error_code( std::errc::value_too_large ) );
+    }
+    return fileSize;
+}
+} // namespace
+
+FileMapping::FileMapping( const InputFile& file ) : mData{ nullptr }, mSize{ mappingSize( file ) } {
+    if ( mSize == 0 ) { // Empty files cannot be mapped, but there is nothing to map anyway.
+        return;
+    }
+#ifdef _WIN32
+    const HANDLE mapping = ::CreateFileMappingW( file.mHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if ( mapping == nullptr ) {
+        throw BitException( "Could not map the file", lastErrorCode() );
+    }
+    // Note: the view keeps a reference to the mapping object, so we can close the latter right away.
+    mData = static_cast< byte_t* >( ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+    const std::error_code error = lastErrorCode();
+    CloseHandle( mapping );
+    if ( mData == nullptr ) {
+        throw BitException( "Could not map the file", error );
+    }
+#else
+    void* mapping = mmap( nullptr, static_cast< std::size_t >( mSize ), PROT_READ, MAP_PRIVATE, file.mHandle, 0 );
+    if ( mapping == MAP_FAILED ) { // NOLINT(*-pro-type-cstyle-cast)
+        throw BitException( "Could not map the file", lastErrorCode() );
+    }
+    mData = static_cast< byte_t* >( mapping );
+#endif
+}
+
+FileMapping::~FileMapping() {
+    if ( mData == nullptr ) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile( mData );
+#else
+    munmap( mData, static_cast< std::size_t >( mSize ) );
+#endif
+}
+
+auto FileMapping::data() const noexcept -> const byte_t* {
+    return mData;
+}
+
+auto FileMapping::size() const noexcept -> std::uint64_t {
+    return mSize;
+}
+
+void FileMapping::adviseWillNeed(
+    BIT7Z_MAYBE_UNUSED std::uint64_t offset,
+    BIT7Z_MAYBE_UNUSED std::uint64_t length
+) const noexcept {
+#ifdef MADV_WILLNEED
+    static const auto pageSize = static_cast< std::uint64_t >( sysconf( _SC_PAGESIZE ) );
+    if ( mData == nullptr || offset >= mSize ) {
+        return;
+    }
+    // Note: madvise requires a page-aligned address.
+    const auto alignedOffset = offset - ( offset % pageSize );
+    const auto advisedLength = std::min( length + ( offset - alignedOffset ), mSize - alignedOffset );
+    // NOLINTNEXTLINE(*-pointer-arithmetic)
+    static_cast< void >( madvise( mData + alignedOffset, static_cast< std::size_t >( advisedLength ), MADV_WILLNEED ) );
+#endif
+}
+
 } // namespace bit7z
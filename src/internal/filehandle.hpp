@@ -162,6 +162,21 @@ class FileHandle {
 
         BIT7Z_NODISCARD
         auto seek( SeekOrigin origin, std::int64_t distance, std::uint64_t& newPosition ) const noexcept -> HRESULT;
+
+        /**
+         * @brief Takes an exclusive advisory lock on the file, which is released when the handle is closed.
+         *
+         * @note The lock conflicts with the ones taken through any other handle of the same file,
+         *       even within the same process. On Windows, the locked range lies far beyond the end of the file,
+         *       so the lock doesn't prevent other handles from reading or writing the file content.
+         *
+         * @param wait whether to wait for the lock to be released if it is held through another handle.
+         *
+         * @return true if the lock was taken, false otherwise (e.g., it is held through another handle
+         *         and wait is false, or the file system doesn't support locking).
+         */
+        BIT7Z_NODISCARD
+        auto lock( bool wait ) const noexcept -> bool;
 };
 
 struct OutputFile final : FileHandle {
@@ -176,6 +191,21 @@ struct OutputFile final : FileHandle {
     BIT7Z_NODISCARD
     auto resize( std::uint64_t newSize ) const noexcept -> bool;
 
+    /**
+     * @brief Hints the OS to reserve the storage space for the given number of bytes, without changing the file size.
+     *
+     * @note This is a no-op on platforms not supporting it. The space reserved beyond the end of the file
+     *       is released by resizing the file (e.g., to its current size).
+     */
+    void preallocate( std::uint64_t size ) const noexcept;
+
+    /**
+     * @brief Commits the data written to the file to the storage device.
+     *
+     * @return S_OK on success, or an error HRESULT otherwise.
+     */
+    auto sync() const noexcept -> HRESULT;
+
 #ifdef _WIN32
     BIT7Z_NODISCARD
     auto setFileTime( FILETIME creation, FILETIME access, FILETIME modified ) const noexcept -> bool;
@@ -188,6 +218,69 @@ struct InputFile final : FileHandle {
     explicit InputFile( const native_string& filePath, ExtraFlag extraFlag );
 
     auto read( void* data, std::uint32_t size, std::uint32_t& processedSize ) const noexcept -> HRESULT;
+
+    /**
+     * @brief Hints the OS that the file will be read sequentially, so that it can read ahead more aggressively.
+     *
+     * @note This is a no-op on platforms not supporting posix_fadvise.
+     */
+    void adviseSequentialAccess() const noexcept;
+
+    /**
+     * @brief Hints the OS that the given range of the file will be read soon,
+     *        so that it can start reading it in the background.
+     *
+     * @note This is a no-op on platforms not supporting posix_fadvise.
+     */
+    void adviseWillNeed( std::uint64_t offset, std::uint64_t length ) const noexcept;
+
+    private:
+        friend class FileMapping;
+};
+
+/**
+ * @brief A read-only memory mapping of the whole content of a file.
+ *
+ * @note The mapping stays valid even after the file handle used to create it is closed.
+ *       However, the file must not be truncated while it is mapped, as accessing the pages beyond the new end
+ *       of the file is an error (e.g., SIGBUS on POSIX systems).
+ */
+class FileMapping final {
+    public:
+        /**
+         * @brief Maps the content of the given file in memory.
+         *
+         * @throws BitException if the file cannot be mapped (e.g., it is not a regular file, or it is too big
+         *         for the address space of the process).
+         */
+        explicit FileMapping( const InputFile& file );
+
+        FileMapping( const FileMapping& ) = delete;
+
+        FileMapping( FileMapping&& ) = delete;
+
+        auto operator=( const FileMapping& ) -> FileMapping& = delete;
+
+        auto operator=( FileMapping&& ) -> FileMapping& = delete;
+
+        ~FileMapping();
+
+        BIT7Z_NODISCARD
+        auto data() const noexcept -> const byte_t*;
+
+        BIT7Z_NODISCARD
+        auto size() const noexcept -> std::uint64_t;
+
+        /**
+         * @brief Hints the OS that the given range of the mapping will be accessed soon.
+         *
+         * @note This is a no-op on platforms not supporting madvise.
+         */
+        void adviseWillNeed( std::uint64_t offset, std::uint64_t length ) const noexcept;
+
+    private:
+        byte_t* mData;
+        std::uint64_t mSize;
 };
 
 } // namespace bit7z
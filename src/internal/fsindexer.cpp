@@ -17,6 +17,15 @@
 #include "internal/fsutil.hpp"
 #include "internal/stringutil.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <system_error>
 
@@ -24,73 +33,231 @@ namespace bit7z { // NOLINT(modernize-concat-nested-namespaces)
 namespace filesystem {
 
 namespace {
-auto countItemsInPath( const fs::path& path ) -> std::size_t {
-    std::error_code error;
-    const auto begin = fs::recursive_directory_iterator{
-        path,
-        fs::directory_options::skip_permission_denied,
-        error
-    };
-    return error ? 0 : static_cast< std::size_t >( std::distance( begin, fs::recursive_directory_iterator{} ) );
-}
-} // namespace
+// Maximum number of threads used for indexing a directory tree.
+constexpr unsigned kMaxIndexingThreads = 16;
 
-void listDirectoryItems(
-    const fs::path& basePath,
-    const fs::path& inArchivePath,
-    const tstring& filter,
-    IndexingOptions options,
-    BitItemsVector& result
-) {
-    std::error_code error;
-    const bool includeRootPath = filter.empty() ||
-                                 !basePath.has_parent_path() ||
-                                 inArchivePath.filename() != fs::canonical( basePath, error ).filename();
-    const bool shouldIncludeMatchedItems = options.filterPolicy == FilterPolicy::Include;
-
-    result.reserve( result.size() + countItemsInPath( basePath ) );
-    for (
-        auto it = fs::recursive_directory_iterator{ basePath, fs::directory_options::skip_permission_denied, error };
-        it != fs::recursive_directory_iterator{};
-        ++it
-    ) {
-        const auto& currentEntry = *it;
-        const auto& itemPath = currentEntry.path();
-
-        const auto itemIsDir = currentEntry.is_directory( error );
-        const auto itemName = pathToTstring( itemPath.filename() );
-
-        /* An item matches if:
-         *  - Its name matches the wildcard pattern, and
-         *  - Either is a file, or we are interested also to include folders in the index.
-         *
-         * Note: The boolean expression uses short-circuiting to optimize the evaluation. */
-        const bool itemMatches = ( !options.onlyFiles || !itemIsDir ) && fsutil::wildcardMatch( filter, itemName );
-        if ( itemMatches == shouldIncludeMatchedItems ) {
-            const auto prefix = itemPath.lexically_relative( basePath ).remove_filename();
-            const auto searchPath = includeRootPath ? inArchivePath / prefix : prefix;
+constexpr auto kNoIndex = std::numeric_limits< std::size_t >::max();
+
+struct DirectoryNode final {
+    explicit DirectoryNode( fs::path dirPath ) : path{ std::move( dirPath ) } {}
+
+    fs::path path;
+    std::vector< BitInputItem > items;
+    std::vector< std::unique_ptr< DirectoryNode > > subdirectories;
+
+    /* For each listed entry (in the order given by the filesystem), the index of its item in the items vector,
+     * and the index of its node in the subdirectories vector (kNoIndex if it was not indexed or not recursed into). */
+    std::vector< std::pair< std::size_t, std::size_t > > entries;
+};
+
+/* Indexes a directory tree using a pool of threads, each listing a whole directory at a time.
+ * The directories' contents are then merged in the same (pre-order) order of a recursive_directory_iterator,
+ * so that the result doesn't depend on how the directories were scheduled among the threads. */
+class DirectoryIndexer final {
+    public:
+        DirectoryIndexer(
+            const fs::path& basePath,
+            const fs::path& inArchivePath,
+            const tstring& filter,
+            IndexingOptions options
+        ) : mBasePath{ basePath },
+            mInArchivePath{ inArchivePath },
+            mFilter{ filter },
+            mOptions{ options },
+            mIncludeRootPath{ false },
+            mRunningTasks{ 0 } {
+            std::error_code error;
+            mIncludeRootPath = filter.empty() ||
+                               !basePath.has_parent_path() ||
+                               inArchivePath.filename() != fs::canonical( basePath, error ).filename();
+        }
+
+        void index( BitItemsVector& result ) {
+            DirectoryNode root{ mBasePath };
+
+            // Listing the base directory on the calling thread: if it has no subdirectories, no thread is needed.
+            std::vector< DirectoryNode* > subdirectories;
+            listDirectory( root, subdirectories, true );
+            if ( !subdirectories.empty() ) {
+                mPendingTasks.assign( subdirectories.cbegin(), subdirectories.cend() );
+
+                const auto threadsCount = std::min( std::max( std::thread::hardware_concurrency(), 1U ),
+                                                    kMaxIndexingThreads );
+                std::vector< std::thread > workers;
+                workers.reserve( threadsCount - 1 );
+                for ( unsigned i = 1; i < threadsCount; ++i ) {
+                    try {
+                        workers.emplace_back( &DirectoryIndexer::processTasks, this );
+                    } catch ( const std::system_error& ) {
+                        // No more threads can be started: the ones already running (and this one) do all the work.
+                        break;
+                    }
+                }
+                processTasks();
+                for ( auto& worker : workers ) {
+                    worker.join();
+                }
+                if ( mError ) {
+                    std::rethrow_exception( mError );
+                }
+            }
+
+            result.reserve( result.size() + countItems( root ) );
+            mergeItems( root, result );
+        }
+
+    private:
+        const fs::path& mBasePath;
+        const fs::path& mInArchivePath;
+        const tstring& mFilter;
+        IndexingOptions mOptions;
+        bool mIncludeRootPath;
+
+        std::mutex mMutex;
+        std::condition_variable mTaskCondition;
+        std::deque< DirectoryNode* > mPendingTasks;
+        std::size_t mRunningTasks;
+        std::exception_ptr mError;
+
+        void processTasks() {
+            std::unique_lock< std::mutex > lock( mMutex );
+            while ( true ) {
+                mTaskCondition.wait( lock, [ this ]() -> bool {
+                    return !mPendingTasks.empty() || mRunningTasks == 0;
+                } );
+                if ( mPendingTasks.empty() ) {
+                    break; // No pending directories, and no running task that could add new ones.
+                }
+
+                // Note: taking the most recently found directory keeps the working set of the threads small.
+                DirectoryNode* node = mPendingTasks.back();
+                mPendingTasks.pop_back();
+                ++mRunningTasks;
+                lock.unlock();
+
+                std::vector< DirectoryNode* > subdirectories;
+                std::exception_ptr error;
+                try {
+                    listDirectory( *node, subdirectories, false );
+                } catch ( ... ) {
+                    error = std::current_exception();
+                }
+
+                lock.lock();
+                --mRunningTasks;
+                if ( error ) {
+                    if ( !mError ) {
+                        mError = error;
+                    }
+                    mPendingTasks.clear();
+                } else if ( !mError ) {
+                    mPendingTasks.insert( mPendingTasks.end(), subdirectories.cbegin(), subdirectories.cend() );
+                }
+                mTaskCondition.notify_all();
+            }
+        }
+
+        void listDirectory( DirectoryNode& node, std::vector< DirectoryNode* >& subdirectories, bool isRoot ) const {
+            const bool shouldIncludeMatchedItems = mOptions.filterPolicy == FilterPolicy::Include;
+
+            std::error_code iterationError;
+            auto it = fs::directory_iterator{ node.path, fs::directory_options::skip_permission_denied, iterationError };
+
+            /* Note: like a recursive_directory_iterator, we ignore the errors when opening the base directory,
+             * while failing to open or read any other directory is an error. */
+            if ( iterationError && isRoot ) {
+                return;
+            }
+
+            std::error_code error;
+            for ( ; it != fs::directory_iterator{}; it.increment( iterationError ) ) {
+                const auto& currentEntry = *it;
+                const auto& itemPath = currentEntry.path();
+
+                // Note: the file type is usually cached by the directory entry, so it doesn't need a stat call.
+                const auto itemIsDir = currentEntry.is_directory( error );
+                const auto itemName = pathToTstring( itemPath.filename() );
+
+                /* An item matches if:
+                 *  - Its name matches the wildcard pattern, and
+                 *  - Either is a file, or we are interested also to include folders in the index.
+                 *
+                 * Note: The boolean expression uses short-circuiting to optimize the evaluation. */
+                const bool itemMatches = ( !mOptions.onlyFiles || !itemIsDir ) &&
+                                         fsutil::wildcardMatch( mFilter, itemName );
+
+                auto itemIndex = kNoIndex;
+                if ( itemMatches == shouldIncludeMatchedItems ) {
+                    itemIndex = node.items.size();
+                    addItem( node, currentEntry );
+                }
+
+                /* We recurse inside the current item only if:
+                 *  - it is a directory (but not a symbolic link to a directory, like recursive_directory_iterator); and
+                 *  - we are indexing recursively, or the directory's name matches the wildcard filter. */
+                auto subdirectoryIndex = kNoIndex;
+                if ( itemIsDir && !currentEntry.is_symlink( error ) &&
+                     ( mOptions.recursive || ( itemMatches == shouldIncludeMatchedItems ) ) ) {
+                    subdirectoryIndex = node.subdirectories.size();
+                    node.subdirectories.emplace_back( new DirectoryNode{ itemPath } );
+                    subdirectories.push_back( node.subdirectories.back().get() );
+                }
+                node.entries.emplace_back( itemIndex, subdirectoryIndex );
+            }
+            if ( iterationError ) {
+                throw fs::filesystem_error{ "Could not list the directory", node.path, iterationError };
+            }
+        }
+
+        void addItem( DirectoryNode& node, const fs::directory_entry& entry ) const {
+            const auto& itemPath = entry.path();
+            const auto prefix = itemPath.lexically_relative( mBasePath ).remove_filename();
+            const auto searchPath = mIncludeRootPath ? mInArchivePath / prefix : prefix;
 #ifdef BIT7Z_AUTO_PREFIX_LONG_PATHS
             if ( fsutil::shouldFormatLongPath( itemPath ) ) {
-                result.emplace_back(
+                std::error_code error;
+                node.items.emplace_back(
                     searchPath,
                     fs::directory_entry{ fsutil::formatLongPath( itemPath ), error },
-                    options.symlinkPolicy
+                    mOptions.symlinkPolicy,
+                    mOptions.lazyMetadata
                 );
-            } else {
-                result.emplace_back( searchPath, currentEntry, options.symlinkPolicy );
+                return;
             }
-#else
-            result.emplace_back( searchPath, currentEntry, options.symlinkPolicy );
 #endif
+            node.items.emplace_back( searchPath, entry, mOptions.symlinkPolicy, mOptions.lazyMetadata );
         }
 
-        /* We don't need to recurse inside the current item if:
-         *  - it is not a directory; or
-         *  - we are not indexing recursively, and the directory's name doesn't match the wildcard filter. */
-        if ( !itemIsDir || ( !options.recursive && ( itemMatches != shouldIncludeMatchedItems ) ) ) {
-            it.disable_recursion_pending();
+        static auto countItems( const DirectoryNode& node ) -> std::size_t {
+            std::size_t result = node.items.size();
+            for ( const auto& subdirectory : node.subdirectories ) {
+                result += countItems( *subdirectory );
+            }
+            return result;
+        }
+
+        static void mergeItems( DirectoryNode& node, BitItemsVector& result ) {
+            for ( const auto& entry : node.entries ) {
+                if ( entry.first != kNoIndex ) {
+                    result.push_back( std::move( node.items[ entry.first ] ) );
+                }
+                if ( entry.second != kNoIndex ) {
+                    mergeItems( *node.subdirectories[ entry.second ], result );
+                }
+            }
         }
-    }
+};
+} // namespace
+
+void listDirectoryItems(
+    const fs::path& basePath,
+    const fs::path& inArchivePath,
+    const tstring& filter,
+    IndexingOptions options,
+    BitItemsVector& result
+) {
+    DirectoryIndexer indexer{ basePath, inArchivePath, filter, options };
+    indexer.index( result );
 }
 
 } // namespace filesystem
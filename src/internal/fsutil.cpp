@@ -20,6 +20,8 @@
 #ifndef _WIN32
 #include "internal/dateutil.hpp"
 
+#include <unistd.h> // For access
+
 // For some reason, GCC on macOS requires including <climits> for defining OPEN_MAX.
 #if defined( __APPLE__ ) && !defined( __clang__ )
 #include <climits>
@@ -221,6 +223,16 @@ auto fsutil::setFileModifiedTime( const fs::path& filePath, FILETIME ftModified
 }
 #endif
 
+auto fsutil::isWritable( const fs::path& path ) noexcept -> bool {
+#ifdef _WIN32
+    const auto attributes = ::GetFileAttributesW( path.c_str() );
+    return attributes != INVALID_FILE_ATTRIBUTES &&
+           ( ( attributes & FILE_ATTRIBUTE_DIRECTORY ) != 0 || ( attributes & FILE_ATTRIBUTE_READONLY ) == 0 );
+#else
+    return access( path.c_str(), W_OK ) == 0;
+#endif
+}
+
 #if defined( _WIN32 ) && defined( BIT7Z_AUTO_PREFIX_LONG_PATHS )
 
 namespace {
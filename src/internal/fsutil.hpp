@@ -180,6 +180,14 @@ BIT7Z_NODISCARD auto wildcardMatch( const tstring& pattern, const tstring& path
 auto setFileModifiedTime( const fs::path& filePath, FILETIME ftModified ) noexcept -> bool;
 #endif
 
+/**
+ * @brief Checks whether the given file or directory can be written (for a directory: whether files can be
+ *        created in or deleted from it).
+ *
+ * @note On Windows, only the read-only attribute is checked, which is ignored for directories.
+ */
+BIT7Z_NODISCARD auto isWritable( const fs::path& path ) noexcept -> bool;
+
 BIT7Z_NODISCARD
 BIT7Z_ALWAYS_INLINE
 auto getFileMetadata( const fs::path& filePath, SymlinkPolicy policy ) -> FileMetadata {
@@ -0,0 +1,650 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/inplaceappender.hpp"
+
+#include "biterror.hpp"
+#include "bitexception.hpp"
+#include "internal/filehandle.hpp"
+#include "internal/fsutil.hpp"
+#include "internal/util.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <system_error>
+#include <utility>
+
+namespace bit7z {
+
+namespace {
+// The tail of an archive is kept in memory (and in the journal), so we limit its size.
+constexpr std::uint64_t kMaxTailSize = 64ULL * 1024 * 1024;
+
+constexpr std::array< byte_t, 8 > kJournalMagic{ 'B', 'I', 'T', '7', 'Z', 'J', 'N', 'L' };
+constexpr std::size_t kJournalHeaderSize = kJournalMagic.size() + 4 * sizeof( std::uint64_t );
+
+// Appended to the journal (after the tail of the archive) once the append is committed.
+constexpr std::array< byte_t, 8 > kJournalCommitMagic{ 'B', 'I', 'T', '7', 'Z', 'C', 'M', 'T' };
+
+/* The size of the regions at the start and at the end of the existing items that identify the archive file
+ * in the journal (hashing all the existing items would cost as much as rewriting them). */
+constexpr std::size_t kFingerprintRegionSize = 64 * 1024;
+
+constexpr std::size_t kTarBlockSize = 512;
+constexpr std::size_t kTarSizeOffset = 124;
+constexpr std::size_t kTarSizeLength = 12;
+constexpr std::size_t kTarChecksumOffset = 148;
+constexpr std::size_t kTarChecksumLength = 8;
+constexpr std::size_t kTarTypeFlagOffset = 156;
+
+constexpr std::uint32_t kZipEndRecordSignature = 0x06054B50;
+constexpr std::uint32_t kZip64LocatorSignature = 0x07064B50;
+constexpr std::uint32_t kZipCentralEntrySignature = 0x02014B50;
+constexpr std::size_t kZipEndRecordSize = 22;
+constexpr std::size_t kZip64LocatorSize = 20;
+constexpr std::size_t kZipCentralEntrySize = 46;
+constexpr std::size_t kZipMaxCommentSize = 0xFFFF;
+constexpr std::uint16_t kZipMaxEntries = 0xFFFF;
+constexpr std::uint32_t kZipMaxValue = 0xFFFFFFFF;
+
+auto journalPathOf( const fs::path& archivePath ) -> fs::path {
+    fs::path result = archivePath;
+    result += BIT7Z_NATIVE_STRING( ".bit7z-journal" );
+    return result;
+}
+
+auto readLE16( const buffer_t& buffer, std::size_t offset ) -> std::uint16_t {
+    return static_cast< std::uint16_t >( buffer[ offset ] | ( buffer[ offset + 1 ] << 8U ) );
+}
+
+auto readLE32( const buffer_t& buffer, std::size_t offset ) -> std::uint32_t {
+    return static_cast< std::uint32_t >( readLE16( buffer, offset ) ) |
+           ( static_cast< std::uint32_t >( readLE16( buffer, offset + 2 ) ) << 16U );
+}
+
+auto readLE64( const buffer_t& buffer, std::size_t offset ) -> std::uint64_t {
+    return static_cast< std::uint64_t >( readLE32( buffer, offset ) ) |
+           ( static_cast< std::uint64_t >( readLE32( buffer, offset + 4 ) ) << 32U );
+}
+
+void writeLE16( buffer_t& buffer, std::size_t offset, std::uint16_t value ) {
+    buffer[ offset ] = static_cast< byte_t >( value & 0xFFU );
+    buffer[ offset + 1 ] = static_cast< byte_t >( value >> 8U );
+}
+
+void writeLE32( buffer_t& buffer, std::size_t offset, std::uint32_t value ) {
+    writeLE16( buffer, offset, static_cast< std::uint16_t >( value & 0xFFFFU ) );
+    writeLE16( buffer, offset + 2, static_cast< std::uint16_t >( value >> 16U ) );
+}
+
+void writeLE64( buffer_t& buffer, std::size_t offset, std::uint64_t value ) {
+    writeLE32( buffer, offset, static_cast< std::uint32_t >( value & 0xFFFFFFFFU ) );
+    writeLE32( buffer, offset + 4, static_cast< std::uint32_t >( value >> 32U ) );
+}
+
+auto fileSizeOf( const FileHandle& file ) -> std::uint64_t {
+    std::uint64_t fileSize = 0;
+    const auto result = file.seek( SeekOrigin::End, 0, fileSize );
+    if ( result != S_OK ) {
+        throw BitException( "Failed to get the size of the archive file", make_hresult_code( result ) );
+    }
+    return fileSize;
+}
+
+// Reads exactly buffer.size() bytes at the given offset of the file.
+auto readAt( const InputFile& file, std::uint64_t offset, buffer_t& buffer ) noexcept -> bool {
+    std::uint64_t position = 0;
+    if ( file.seek( SeekOrigin::Begin, static_cast< std::int64_t >( offset ), position ) != S_OK ) {
+        return false;
+    }
+    std::uint32_t readSize = 0;
+    const auto result = file.read( buffer.data(), static_cast< std::uint32_t >( buffer.size() ), readSize );
+    return result == S_OK && readSize == buffer.size();
+}
+
+auto writeAt( const OutputFile& file, std::uint64_t offset, const buffer_t& buffer ) noexcept -> HRESULT {
+    std::uint64_t position = 0;
+    RINOK( file.seek( SeekOrigin::Begin, static_cast< std::int64_t >( offset ), position ) ) //-V3504
+    std::uint32_t writtenSize = 0;
+    RINOK( file.write( buffer.data(), static_cast< std::uint32_t >( buffer.size() ), writtenSize ) ) //-V3504
+    return writtenSize == buffer.size() ? S_OK : E_FAIL;
+}
+
+// Hashes the first and the last bytes before the offset, which are never modified when appending.
+auto fingerprintOf( const InputFile& file, std::uint64_t offset ) -> Optional< ContentHash > {
+    const auto regionSize = static_cast< std::size_t >( std::min< std::uint64_t >( offset, kFingerprintRegionSize ) );
+    buffer_t firstRegion( regionSize );
+    buffer_t lastRegion( regionSize );
+    if ( !readAt( file, 0, firstRegion ) || !readAt( file, offset - regionSize, lastRegion ) ) {
+        return nullopt;
+    }
+    ContentHasher hasher;
+    hasher.update( firstRegion.data(), firstRegion.size() );
+    hasher.update( lastRegion.data(), lastRegion.size() );
+    return hasher.finalize();
+}
+
+/* Parses a numeric field of a tar header, either in octal (optionally space-padded and NUL-terminated),
+ * or in the base-256 encoding used by GNU tar for large values. */
+auto parseTarNumber( const buffer_t& header, std::size_t offset, std::size_t length, std::uint64_t& value ) -> bool {
+    value = 0;
+    if ( ( header[ offset ] & 0x80U ) != 0 ) {
+        if ( header[ offset ] != 0x80U ) { // Negative or too big values.
+            return false;
+        }
+        for ( std::size_t index = offset + 1; index < offset + length; ++index ) {
+            if ( ( value >> 56U ) != 0 ) {
+                return false;
+            }
+            value = ( value << 8U ) | header[ index ];
+        }
+        return true;
+    }
+
+    std::size_t index = offset;
+    while ( index < offset + length && header[ index ] == ' ' ) {
+        ++index;
+    }
+    for ( ; index < offset + length && header[ index ] != ' ' && header[ index ] != '\0'; ++index ) {
+        if ( header[ index ] < '0' || header[ index ] > '7' || ( value >> 61U ) != 0 ) {
+            return false;
+        }
+        value = ( value << 3U ) | static_cast< std::uint64_t >( header[ index ] - '0' );
+    }
+    return true;
+}
+
+// Note: some old tar implementations computed the checksum using signed chars.
+auto isValidTarHeader( const buffer_t& header ) -> bool {
+    std::uint64_t checksum = 0;
+    if ( !parseTarNumber( header, kTarChecksumOffset, kTarChecksumLength, checksum ) ) {
+        return false;
+    }
+    std::uint64_t unsignedSum = 0;
+    std::int64_t signedSum = 0;
+    for ( std::size_t index = 0; index < kTarBlockSize; ++index ) {
+        const bool isChecksumField = index >= kTarChecksumOffset && index < kTarChecksumOffset + kTarChecksumLength;
+        const byte_t byte = isChecksumField ? static_cast< byte_t >( ' ' ) : header[ index ];
+        unsignedSum += byte;
+        signedSum += static_cast< signed char >( byte );
+    }
+    return checksum == unsignedSum || static_cast< std::int64_t >( checksum ) == signedSum;
+}
+
+auto isZeroFilled( const buffer_t& buffer ) -> bool {
+    return std::all_of( buffer.cbegin(), buffer.cend(), []( byte_t byte ) -> bool {
+        return byte == 0;
+    } );
+}
+
+// The new items are written over the end-of-archive blocks, i.e., the first zero block after the headers.
+auto findTarAppendPoint( const InputFile& file, std::uint64_t fileSize ) -> Optional< AppendPoint > {
+    buffer_t header( kTarBlockSize );
+    std::uint64_t offset = 0;
+    while ( fileSize - offset >= kTarBlockSize ) {
+        if ( !readAt( file, offset, header ) ) {
+            return nullopt;
+        }
+        if ( isZeroFilled( header ) ) {
+            break;
+        }
+        std::uint64_t itemSize = 0;
+        if ( !isValidTarHeader( header ) || !parseTarNumber( header, kTarSizeOffset, kTarSizeLength, itemSize ) ) {
+            return nullopt;
+        }
+
+        // Links, devices, directories, and FIFOs have no data: a non-zero size might be interpreted in other ways.
+        const auto typeFlag = header[ kTarTypeFlagOffset ];
+        if ( typeFlag >= '1' && typeFlag <= '6' && itemSize != 0 ) {
+            return nullopt;
+        }
+        if ( itemSize > fileSize ) {
+            return nullopt;
+        }
+        offset += kTarBlockSize + ( ( itemSize + kTarBlockSize - 1 ) / kTarBlockSize ) * kTarBlockSize;
+        if ( offset > fileSize ) {
+            return nullopt;
+        }
+    }
+
+    // Archives without end-of-archive blocks, or with some data after them, are not appended in place.
+    const auto tailSize = fileSize - offset;
+    if ( tailSize < kTarBlockSize || tailSize > kMaxTailSize ) {
+        return nullopt;
+    }
+    buffer_t tail( static_cast< std::size_t >( tailSize ) );
+    if ( !readAt( file, offset, tail ) || !isZeroFilled( tail ) ) {
+        return nullopt;
+    }
+    const auto fingerprint = fingerprintOf( file, offset );
+    if ( !fingerprint ) {
+        return nullopt;
+    }
+    return AppendPoint{ AppendableFormat::Tar, offset, fileSize, *fingerprint, std::move( tail ) };
+}
+
+struct ZipEndRecord {
+    std::size_t position; // The position of the record in the buffer it was found in.
+    std::uint16_t entries;
+    std::uint32_t centralDirSize;
+    std::uint32_t centralDirOffset;
+    std::uint16_t commentSize;
+};
+
+/* Finds the end of central directory record of a single-disk non-Zip64 zip archive
+ * in the given buffer, which must contain the end of the archive. */
+auto findZipEndRecord( const buffer_t& buffer ) -> Optional< ZipEndRecord > {
+    if ( buffer.size() < kZipEndRecordSize ) {
+        return nullopt;
+    }
+    for ( std::size_t position = buffer.size() - kZipEndRecordSize + 1; position-- > 0; ) {
+        if ( readLE32( buffer, position ) != kZipEndRecordSignature ) {
+            continue;
+        }
+        const auto commentSize = readLE16( buffer, position + 20 );
+        if ( position + kZipEndRecordSize + commentSize != buffer.size() ) {
+            continue; // The signature is part of the comment.
+        }
+
+        const auto entries = readLE16( buffer, position + 10 );
+        const auto centralDirSize = readLE32( buffer, position + 12 );
+        const auto centralDirOffset = readLE32( buffer, position + 16 );
+        const bool isMultiDisk = readLE16( buffer, position + 4 ) != 0 || readLE16( buffer, position + 6 ) != 0 ||
+                                 readLE16( buffer, position + 8 ) != entries;
+        const bool isZip64 = entries == kZipMaxEntries ||
+                             centralDirSize == kZipMaxValue ||
+                             centralDirOffset == kZipMaxValue ||
+                             ( position >= kZip64LocatorSize &&
+                               readLE32( buffer, position - kZip64LocatorSize ) == kZip64LocatorSignature );
+        if ( isMultiDisk || isZip64 ) {
+            return nullopt;
+        }
+        return ZipEndRecord{ position, entries, centralDirSize, centralDirOffset, commentSize };
+    }
+    return nullopt;
+}
+
+/* Walks the entries of the central directory, adding the given offset to their local header offsets.
+ * Returns false if the central directory is malformed, or if some offset cannot be relocated. */
+auto relocateZipCentralDir( buffer_t& centralDir, std::size_t expectedEntries, std::uint32_t offset ) -> bool {
+    std::size_t entries = 0;
+    std::size_t position = 0;
+    while ( position < centralDir.size() ) {
+        if ( centralDir.size() - position < kZipCentralEntrySize ||
+             readLE32( centralDir, position ) != kZipCentralEntrySignature ) {
+            return false;
+        }
+        if ( offset != 0 ) {
+            const auto localHeaderOffset = readLE32( centralDir, position + 42 );
+            if ( localHeaderOffset == kZipMaxValue || kZipMaxValue - localHeaderOffset <= offset ) {
+                return false;
+            }
+            writeLE32( centralDir, position + 42, localHeaderOffset + offset );
+        }
+        position += kZipCentralEntrySize +
+                    readLE16( centralDir, position + 28 ) +
+                    readLE16( centralDir, position + 30 ) +
+                    readLE16( centralDir, position + 32 );
+        ++entries;
+    }
+    return position == centralDir.size() && entries == expectedEntries;
+}
+
+// The new items are written over the central directory, which must be right before the end record.
+auto findZipAppendPoint( const InputFile& file, std::uint64_t fileSize ) -> Optional< AppendPoint > {
+    const auto trailerSize = std::min< std::uint64_t >( fileSize,
+                                                        kZip64LocatorSize + kZipEndRecordSize + kZipMaxCommentSize );
+    buffer_t trailer( static_cast< std::size_t >( trailerSize ) );
+    if ( !readAt( file, fileSize - trailerSize, trailer ) ) {
+        return nullopt;
+    }
+    const auto endRecord = findZipEndRecord( trailer );
+    if ( !endRecord ) {
+        return nullopt;
+    }
+
+    const auto endRecordOffset = fileSize - trailerSize + endRecord->position;
+    const std::uint64_t centralDirOffset = endRecord->centralDirOffset;
+    if ( centralDirOffset + endRecord->centralDirSize != endRecordOffset ||
+         fileSize - centralDirOffset > kMaxTailSize ) {
+        return nullopt;
+    }
+
+    buffer_t tail( static_cast< std::size_t >( fileSize - centralDirOffset ) );
+    if ( !readAt( file, centralDirOffset, tail ) ) {
+        return nullopt;
+    }
+    buffer_t centralDir( tail.cbegin(), tail.cbegin() + endRecord->centralDirSize );
+    if ( !relocateZipCentralDir( centralDir, endRecord->entries, 0 ) ) {
+        return nullopt;
+    }
+    const auto fingerprint = fingerprintOf( file, centralDirOffset );
+    if ( !fingerprint ) {
+        return nullopt;
+    }
+    return AppendPoint{ AppendableFormat::Zip, centralDirOffset, fileSize, *fingerprint, std::move( tail ) };
+}
+
+/* Reads the central directory of the zip archive of the new items (written at the append point),
+ * and merges it with the one of the existing items. Returns the new trailer of the archive file,
+ * i.e., the merged central directory and end record, to be written at the given offset. */
+auto mergeZipTrailers(
+    const fs::path& archivePath,
+    const AppendPoint& appendPoint,
+    std::uint64_t newArchiveSize,
+    std::uint64_t& trailerOffset
+) -> buffer_t {
+    const auto oldEndRecord = findZipEndRecord( appendPoint.tail );
+    if ( !oldEndRecord ) {
+        throw BitException( "Could not find the end record of the zip archive", make_error_code( BitError::Fail ) );
+    }
+
+    const InputFile archive{ archivePath.native() };
+    buffer_t newTrailer( static_cast< std::size_t >( std::min< std::uint64_t >(
+        newArchiveSize, kZip64LocatorSize + kZipEndRecordSize
+    ) ) );
+    const auto newTrailerOffset = appendPoint.offset + newArchiveSize - newTrailer.size();
+    if ( !readAt( archive, newTrailerOffset, newTrailer ) ) {
+        throw BitException( "Failed to read the appended zip archive", make_error_code( BitError::Fail ) );
+    }
+
+    // Note: the end record of the new archive has no comment, so it is at the end of the trailer.
+    const auto newEndRecord = findZipEndRecord( newTrailer );
+    if ( !newEndRecord ||
+         newEndRecord->position != newTrailer.size() - kZipEndRecordSize ||
+         std::uint64_t{ newEndRecord->centralDirOffset } + newEndRecord->centralDirSize + kZipEndRecordSize !=
+         newArchiveSize ) {
+        throw BitException( "The appended items need a Zip64 archive",
+                            make_error_code( BitError::UnsupportedOperation ) );
+    }
+
+    buffer_t newCentralDir( newEndRecord->centralDirSize );
+    if ( !readAt( archive, appendPoint.offset + newEndRecord->centralDirOffset, newCentralDir ) ) {
+        throw BitException( "Failed to read the appended zip archive", make_error_code( BitError::Fail ) );
+    }
+
+    trailerOffset = appendPoint.offset + newEndRecord->centralDirOffset;
+    const std::uint64_t centralDirSize = std::uint64_t{ oldEndRecord->centralDirSize } + newCentralDir.size();
+    const std::uint32_t entries = std::uint32_t{ oldEndRecord->entries } + newEndRecord->entries;
+    if ( appendPoint.offset >= kZipMaxValue ||
+         !relocateZipCentralDir( newCentralDir,
+                                 newEndRecord->entries,
+                                 static_cast< std::uint32_t >( appendPoint.offset ) ) ||
+         trailerOffset >= kZipMaxValue || centralDirSize >= kZipMaxValue || entries >= kZipMaxEntries ) {
+        throw BitException( "The appended items need a Zip64 archive",
+                            make_error_code( BitError::UnsupportedOperation ) );
+    }
+
+    // The old central directory, followed by the new one, and by the end record with the old comment.
+    buffer_t result( appendPoint.tail.cbegin(), appendPoint.tail.cbegin() + oldEndRecord->centralDirSize );
+    result.insert( result.end(), newCentralDir.cbegin(), newCentralDir.cend() );
+    const auto endRecordPosition = result.size();
+    result.insert( result.end(),
+                   appendPoint.tail.cbegin() + static_cast< std::ptrdiff_t >( oldEndRecord->position ),
+                   appendPoint.tail.cend() );
+    writeLE16( result, endRecordPosition + 8, static_cast< std::uint16_t >( entries ) );
+    writeLE16( result, endRecordPosition + 10, static_cast< std::uint16_t >( entries ) );
+    writeLE32( result, endRecordPosition + 12, static_cast< std::uint32_t >( centralDirSize ) );
+    writeLE32( result, endRecordPosition + 16, static_cast< std::uint32_t >( trailerOffset ) );
+    return result;
+}
+
+void writeJournal( const fs::path& journalPath, const AppendPoint& appendPoint ) {
+    buffer_t journal( kJournalHeaderSize );
+    std::copy( kJournalMagic.cbegin(), kJournalMagic.cend(), journal.begin() );
+    writeLE64( journal, kJournalMagic.size(), appendPoint.fileSize );
+    writeLE64( journal, kJournalMagic.size() + sizeof( std::uint64_t ), appendPoint.offset );
+    writeLE64( journal, kJournalMagic.size() + 2 * sizeof( std::uint64_t ), appendPoint.fingerprint.low );
+    writeLE64( journal, kJournalMagic.size() + 3 * sizeof( std::uint64_t ), appendPoint.fingerprint.high );
+    journal.insert( journal.end(), appendPoint.tail.cbegin(), appendPoint.tail.cend() );
+
+    // Note: the journal must be on the storage device before we start modifying the archive.
+    const OutputFile journalFile{ journalPath.native(), FileFlag::CreateNew };
+    HRESULT result = writeAt( journalFile, 0, journal );
+    if ( result == S_OK ) {
+        result = journalFile.sync();
+    }
+    if ( result != S_OK ) {
+        throw BitException( "Failed to write the journal file", make_hresult_code( result ),
+                            pathToTstring( journalPath ) );
+    }
+}
+
+// The append is committed once this record is on the storage device: from then on, it is never rolled back.
+void markJournalCommitted( const fs::path& journalPath, std::uint64_t journalSize ) {
+    const buffer_t commitRecord( kJournalCommitMagic.cbegin(), kJournalCommitMagic.cend() );
+    const OutputFile journalFile{ journalPath.native(), FileFlag::Existing };
+    HRESULT result = writeAt( journalFile, journalSize, commitRecord );
+    if ( result == S_OK ) {
+        result = journalFile.sync();
+    }
+    if ( result != S_OK ) {
+        throw BitException( "Failed to write the journal file", make_hresult_code( result ),
+                            pathToTstring( journalPath ) );
+    }
+}
+
+// Writes back the original tail of the archive, and truncates the archive to its original size.
+auto restoreTail(
+    const fs::path& archivePath,
+    std::uint64_t offset,
+    std::uint64_t fileSize,
+    const buffer_t& tail
+) noexcept -> HRESULT try {
+    const OutputFile archive{ archivePath.native(), FileFlag::Existing };
+    RINOK( writeAt( archive, offset, tail ) ) //-V3504
+    if ( !archive.resize( fileSize ) ) {
+        return E_FAIL;
+    }
+    return archive.sync();
+} catch ( const BitException& ) {
+    return E_FAIL;
+}
+
+// Note: the archive file must be locked by the caller.
+void recoverArchive( const fs::path& archivePath ) {
+    const auto journalPath = journalPathOf( archivePath );
+    std::error_code error;
+    if ( !fs::exists( journalPath, error ) ) {
+        return;
+    }
+
+    bool isValidJournal = false;
+    bool isCommitted = false;
+    std::uint64_t fileSize = 0;
+    std::uint64_t offset = 0;
+    ContentHash fingerprint{};
+    buffer_t tail;
+    {
+        const InputFile journalFile{ journalPath.native(), ExtraFlag::NoFollow };
+        const auto journalSize = fileSizeOf( journalFile );
+        buffer_t header( kJournalHeaderSize );
+        if ( journalSize >= kJournalHeaderSize &&
+             journalSize - kJournalHeaderSize <= kMaxTailSize + kJournalCommitMagic.size() &&
+             readAt( journalFile, 0, header ) &&
+             std::equal( kJournalMagic.cbegin(), kJournalMagic.cend(), header.cbegin() ) ) {
+            fileSize = readLE64( header, kJournalMagic.size() );
+            offset = readLE64( header, kJournalMagic.size() + sizeof( std::uint64_t ) );
+            fingerprint.low = readLE64( header, kJournalMagic.size() + 2 * sizeof( std::uint64_t ) );
+            fingerprint.high = readLE64( header, kJournalMagic.size() + 3 * sizeof( std::uint64_t ) );
+
+            // Note: the journal ends with the tail of the archive, possibly followed by the (partial) commit record.
+            const auto recordsSize = journalSize - kJournalHeaderSize;
+            if ( offset <= fileSize && fileSize - offset <= recordsSize &&
+                 recordsSize - ( fileSize - offset ) <= kJournalCommitMagic.size() ) {
+                tail.resize( static_cast< std::size_t >( fileSize - offset ) );
+                isValidJournal = readAt( journalFile, kJournalHeaderSize, tail );
+
+                buffer_t commitRecord( static_cast< std::size_t >( recordsSize - tail.size() ) );
+                isCommitted = isValidJournal && commitRecord.size() == kJournalCommitMagic.size() &&
+                              readAt( journalFile, kJournalHeaderSize + tail.size(), commitRecord ) &&
+                              std::equal( commitRecord.cbegin(), commitRecord.cend(), kJournalCommitMagic.cbegin() );
+            }
+        }
+    }
+
+    /* Note: an incomplete journal means that the process was interrupted while writing it,
+     * i.e., before starting to modify the archive, so we can just delete it.
+     * The same holds for a stale journal, i.e., if the archive file was replaced after the interruption,
+     * and for the journal of a committed append, i.e., if the process was interrupted right before deleting it. */
+    bool needsRestore = isValidJournal && !isCommitted;
+    if ( needsRestore ) {
+        const InputFile archive{ archivePath.native() };
+        const auto archiveFingerprint = fileSizeOf( archive ) >= offset ? fingerprintOf( archive, offset ) : nullopt;
+        needsRestore = archiveFingerprint && *archiveFingerprint == fingerprint;
+    }
+    if ( needsRestore ) {
+        const auto result = restoreTail( archivePath, offset, fileSize, tail );
+        if ( result != S_OK ) {
+            throw BitException( "Failed to restore the archive from its journal", make_hresult_code( result ),
+                                pathToTstring( archivePath ) );
+        }
+    }
+    if ( !fs::remove( journalPath, error ) ) {
+        throw BitException( "Failed to delete the journal file", error, pathToTstring( journalPath ) );
+    }
+}
+} // namespace
+
+auto findAppendPoint( const fs::path& archivePath, AppendableFormat format ) -> Optional< AppendPoint > {
+    const InputFile archive{ archivePath.native() };
+    const auto fileSize = fileSizeOf( archive );
+    return format == AppendableFormat::Tar ? findTarAppendPoint( archive, fileSize )
+                                           : findZipAppendPoint( archive, fileSize );
+}
+
+// Note: on Windows, the file is shared for writing, so that the lock doesn't prevent modifying the archive.
+ArchiveFileLock::ArchiveFileLock( const fs::path& archivePath, bool wait )
+    : mArchivePath{ archivePath },
+      mFile{ archivePath.native(), /*storeOpenFiles=*/true },
+      mLocked{ mFile.lock( wait ) } {}
+
+auto ArchiveFileLock::archivePath() const noexcept -> const fs::path& {
+    return mArchivePath;
+}
+
+auto ArchiveFileLock::isLocked() const noexcept -> bool {
+    return mLocked;
+}
+
+InPlaceAppender::InPlaceAppender(
+    const ArchiveFileLock& archiveLock,
+    AppendPoint appendPoint,
+    std::uint32_t writeBufferSize
+) : mArchivePath{ archiveLock.archivePath() },
+    mJournalPath{ journalPathOf( mArchivePath ) },
+    mAppendPoint{ std::move( appendPoint ) },
+    mCommitted{ false } {
+    writeJournal( mJournalPath, mAppendPoint );
+    try {
+        mFileStream = make_com< CFileOutStream >( mArchivePath, FileFlag::Existing, writeBufferSize );
+        mStream = make_com< COffsetOutStream >( mFileStream, mAppendPoint.offset );
+    } catch ( ... ) {
+        // The archive was not modified yet.
+        std::error_code error;
+        fs::remove( mJournalPath, error );
+        throw;
+    }
+}
+
+InPlaceAppender::~InPlaceAppender() {
+    if ( !mCommitted ) {
+        rollback();
+    }
+}
+
+auto InPlaceAppender::stream() const noexcept -> IOutStream* {
+    return mStream;
+}
+
+void InPlaceAppender::commit() {
+    const auto newArchiveSize = mStream->size();
+    mStream.Release();
+    const auto flushResult = mFileStream->flush();
+    if ( flushResult != S_OK ) {
+        throw BitException( "Failed to write the archive file", make_hresult_code( flushResult ),
+                            pathToTstring( mArchivePath ) );
+    }
+    mFileStream.Release();
+
+    std::uint64_t trailerOffset = mAppendPoint.offset + newArchiveSize;
+    buffer_t trailer;
+    if ( mAppendPoint.format == AppendableFormat::Zip ) {
+        trailer = mergeZipTrailers( mArchivePath, mAppendPoint, newArchiveSize, trailerOffset );
+    }
+
+    HRESULT result = S_OK;
+    {
+        const OutputFile archive{ mArchivePath.native(), FileFlag::Existing };
+        if ( !trailer.empty() ) {
+            result = writeAt( archive, trailerOffset, trailer );
+        }
+        if ( result == S_OK && !archive.resize( trailerOffset + trailer.size() ) ) {
+            result = E_FAIL;
+        }
+        if ( result == S_OK ) {
+            result = archive.sync();
+        }
+    }
+    if ( result != S_OK ) {
+        throw BitException( "Failed to write the archive file", make_hresult_code( result ),
+                            pathToTstring( mArchivePath ) );
+    }
+
+    // Note: until the journal is marked as committed, the append would be rolled back.
+    markJournalCommitted( mJournalPath, kJournalHeaderSize + mAppendPoint.tail.size() );
+    mCommitted = true;
+
+    // The journal of a committed append is just discarded by the next recovery, so it is fine if we can't delete it.
+    std::error_code error;
+    fs::remove( mJournalPath, error );
+}
+
+void InPlaceAppender::rollback() noexcept {
+    mStream.Release();
+    mFileStream.Release();
+    if ( restoreTail( mArchivePath, mAppendPoint.offset, mAppendPoint.fileSize, mAppendPoint.tail ) == S_OK ) {
+        std::error_code error;
+        fs::remove( mJournalPath, error );
+    }
+    // Otherwise, the journal is kept, so that the archive will be restored by the next recovery.
+}
+
+void InPlaceAppender::recover( const ArchiveFileLock& archiveLock ) {
+    recoverArchive( archiveLock.archivePath() );
+}
+
+void InPlaceAppender::tryRecover( const fs::path& archivePath ) noexcept try {
+    std::error_code error;
+    if ( !fs::exists( journalPathOf( archivePath ), error ) ) {
+        return;
+    }
+
+    // Readers might lack the permissions needed for the recovery, e.g., if the archive is on read-only media.
+    const auto parentPath = archivePath.parent_path();
+    const auto directory = parentPath.empty() ? fs::path{ BIT7Z_NATIVE_STRING( "." ) } : parentPath;
+    if ( !filesystem::fsutil::isWritable( archivePath ) || !filesystem::fsutil::isWritable( directory ) ) {
+        return;
+    }
+
+    // If the archive is locked, an append is in progress, and its journal must be left alone.
+    const ArchiveFileLock archiveLock{ archivePath, false };
+    if ( archiveLock.isLocked() ) {
+        recoverArchive( archivePath );
+    }
+} catch ( const std::exception& ) { // NOLINT(bugprone-empty-catch)
+    // The archive is left as it is: readers will fail to open it if it was left half-appended.
+}
+
+
+} // namespace bit7z
@@ -0,0 +1,170 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INPLACEAPPENDER_HPP
+#define INPLACEAPPENDER_HPP
+
+#include "bittypes.hpp"
+#include "internal/cfileoutstream.hpp"
+#include "internal/coffsetoutstream.hpp"
+#include "internal/com.hpp"
+#include "internal/contenthash.hpp"
+#include "internal/filehandle.hpp"
+#include "internal/fs.hpp"
+#include "internal/optional.hpp"
+
+#include <cstdint>
+
+namespace bit7z {
+
+/**
+ * @brief The archive formats whose existing items can be kept in place when appending new ones.
+ */
+enum struct AppendableFormat : std::uint8_t {
+    Tar, ///< The new items overwrite the end-of-archive blocks.
+    Zip  ///< The new items overwrite the central directory, which is then rewritten after them.
+};
+
+/**
+ * @brief The point of an archive file from which new items can be written, keeping the existing ones untouched.
+ */
+struct AppendPoint {
+    AppendableFormat format;
+    std::uint64_t offset;    ///< The offset where the new items are to be written.
+    std::uint64_t fileSize;  ///< The original size of the archive file.
+    ContentHash fingerprint; ///< A hash identifying the content of the archive file before the offset.
+    buffer_t tail;           ///< The original content of the archive file from the offset to its end.
+};
+
+/**
+ * @brief Finds where new items can be appended to the given archive file.
+ *
+ * Only the simplest layouts are supported: uncompressed tar archives, and single-disk non-Zip64 zip archives
+ * (without any data between the central directory and its end record).
+ *
+ * @return the append point of the archive, or an empty optional if new items cannot be appended in place.
+ * @throws BitException if the archive file cannot be opened or read.
+ */
+auto findAppendPoint( const fs::path& archivePath, AppendableFormat format ) -> Optional< AppendPoint >;
+
+/**
+ * @brief RAII exclusive advisory lock on an archive file, serializing the in-place appends to the archive
+ *        and their recovery among threads and processes.
+ */
+class ArchiveFileLock final {
+    public:
+        /**
+         * @brief Locks the given archive file.
+         *
+         * @param archivePath the path of the archive file.
+         * @param wait        whether to wait for the lock to be released if it is already held.
+         *
+         * @throws BitException if the archive file cannot be opened.
+         */
+        explicit ArchiveFileLock( const fs::path& archivePath, bool wait = true );
+
+        /**
+         * @return the path of the locked archive file.
+         */
+        BIT7Z_NODISCARD auto archivePath() const noexcept -> const fs::path&;
+
+        /**
+         * @return whether the lock was taken (it might not be, e.g., if the file system doesn't support locking,
+         *         or if it is held elsewhere and we didn't wait for it).
+         */
+        BIT7Z_NODISCARD auto isLocked() const noexcept -> bool;
+
+    private:
+        fs::path mArchivePath;
+        InputFile mFile;
+        bool mLocked;
+};
+
+/**
+ * @brief RAII wrapper that appends a new archive to the end of the items of an existing archive file,
+ * and merges the two on commit().
+ *
+ * Before modifying the archive file, the original content of its tail is saved to a journal file
+ * ("<archive>.bit7z-journal"), which is marked as committed and then removed on commit().
+ * If the appender is destroyed without committing, or the process crashes in between, the archive file is restored
+ * from the journal (by the destructor, or by the next recovery of the same archive, respectively).
+ *
+ * The archive file must be locked for the whole lifetime of the appender, and during recover():
+ * this way, the recovery never runs in the middle of an append.
+ */
+class InPlaceAppender final {
+    public:
+        /**
+         * @brief Writes the journal of the append, and prepares the stream for the new archive.
+         *
+         * @param archiveLock     the lock on the archive file to be appended, which must outlive the appender.
+         * @param appendPoint     the append point of the archive file.
+         * @param writeBufferSize the size of the buffer used for writing the new archive.
+         */
+        InPlaceAppender(
+            const ArchiveFileLock& archiveLock,
+            AppendPoint appendPoint,
+            std::uint32_t writeBufferSize = 0
+        );
+
+        InPlaceAppender( const InPlaceAppender& ) = delete;
+
+        InPlaceAppender( InPlaceAppender&& ) = delete;
+
+        auto operator=( const InPlaceAppender& ) -> InPlaceAppender& = delete;
+
+        auto operator=( InPlaceAppender&& ) -> InPlaceAppender& = delete;
+
+        ~InPlaceAppender();
+
+        /**
+         * @return a non-owning pointer to the stream where the archive of the new items must be written,
+         *         valid as long as this InPlaceAppender is alive and commit() has not been called.
+         */
+        BIT7Z_NODISCARD auto stream() const noexcept -> IOutStream*;
+
+        /**
+         * @brief Merges the archive of the new items with the existing ones, and removes the journal.
+         * @throws BitException on failure (the archive file is then restored by the destructor).
+         */
+        void commit();
+
+        /**
+         * @brief Restores the locked archive file if a previous append was interrupted before committing.
+         *
+         * @note The journal is discarded without restoring anything if the append was committed, or if the content
+         *       of the archive file before the append point does not match the one recorded in the journal,
+         *       e.g., because the archive file was replaced in the meantime.
+         *
+         * @throws BitException if the archive file cannot be restored, or the journal cannot be deleted.
+         */
+        static void recover( const ArchiveFileLock& archiveLock );
+
+        /**
+         * @brief Best-effort version of recover(), used when opening an archive file for reading.
+         *
+         * The recovery is skipped if the archive file is locked (i.e., an append is in progress),
+         * or if the archive file or its directory are not writable; any error is ignored.
+         */
+        static void tryRecover( const fs::path& archivePath ) noexcept;
+
+    private:
+        fs::path mArchivePath;
+        fs::path mJournalPath;
+        AppendPoint mAppendPoint;
+        CMyComPtr< CFileOutStream > mFileStream;
+        CMyComPtr< COffsetOutStream > mStream;
+        bool mCommitted;
+
+        void rollback() noexcept;
+};
+
+} // namespace bit7z
+
+#endif // INPLACEAPPENDER_HPP
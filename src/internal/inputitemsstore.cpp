@@ -0,0 +1,219 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/inputitemsstore.hpp"
+
+#include "bitexception.hpp"
+#include "internal/inputitemutil.hpp"
+#include "internal/stringutil.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace bit7z {
+
+using detail::InputItemType;
+
+namespace {
+#ifdef _WIN32
+constexpr auto kPathSeparators = L"\\/";
+
+auto toNativeString( const sevenzip_string& str ) -> const native_string& {
+    return str;
+}
+
+auto toSevenzipString( native_string&& str ) -> sevenzip_string {
+    return std::move( str );
+}
+#else
+constexpr auto kPathSeparators = "/";
+
+auto toNativeString( const sevenzip_string& str ) -> native_string {
+    return to_native_string( str );
+}
+
+auto toSevenzipString( const native_string& str ) -> sevenzip_string {
+    return widen( str );
+}
+#endif
+
+// Note: the separator is kept in the directory prefix, so that joining the prefix and the name gives back the path.
+auto splitPosition( const native_string& path ) -> std::size_t {
+    const auto separator = path.find_last_of( kPathSeparators );
+    return separator == native_string::npos ? 0 : separator + 1;
+}
+} // namespace
+
+void InputItemsStore::append( BitItemsVector& items ) {
+    for ( auto& item : items ) {
+        if ( item.mProperties.inputType == InputItemType::Filesystem ) {
+            appendCompactItem( item );
+        } else {
+            mOtherItemsIndices.push_back( size() );
+            mOtherItems.push_back( std::move( item ) );
+        }
+    }
+    items.clear();
+    items.shrink_to_fit();
+}
+
+auto InputItemsStore::size() const noexcept -> std::size_t {
+    return mCompactItems.size() + mOtherItems.size();
+}
+
+auto InputItemsStore::internDirectory( native_string directory ) -> DirectoryId {
+    const auto nextId = static_cast< DirectoryId >( mDirectories.size() );
+    const auto result = mDirectoryIds.emplace( std::move( directory ), nextId );
+    if ( result.second ) {
+        // Note: the elements of an unordered_map are never moved, so we can safely point to its keys.
+        mDirectories.push_back( &result.first->first );
+    }
+    return result.first->second;
+}
+
+void InputItemsStore::appendCompactItem( const BitInputItem& item ) {
+    const auto& itemPath = item.mPath;
+    const auto nameStart = splitPosition( itemPath );
+
+    const auto& inArchivePath = toNativeString( item.mInArchivePath );
+    const auto inArchiveNameStart = splitPosition( inArchivePath );
+
+    const auto nameLength = itemPath.size() - nameStart;
+    const bool isRenamed = inArchivePath.compare( inArchiveNameStart, native_string::npos, itemPath, nameStart ) != 0;
+
+    CompactItem storedItem{
+        item.mProperties,
+        itemPath.substr( nameStart ),
+        internDirectory( itemPath.substr( 0, nameStart ) ),
+        internDirectory( inArchivePath.substr( 0, inArchiveNameStart ) ),
+        static_cast< std::uint32_t >( nameLength ),
+        item.mFilesystemItem.symlinkPolicy, // NOLINT(*-pro-type-union-access)
+        isRenamed
+    };
+    if ( isRenamed ) {
+        storedItem.names.append( inArchivePath, inArchiveNameStart, native_string::npos );
+    }
+    mCompactItems.push_back( std::move( storedItem ) );
+}
+
+auto InputItemsStore::otherItem( std::size_t index ) const -> const BitInputItem* {
+    const auto position = std::lower_bound( mOtherItemsIndices.cbegin(), mOtherItemsIndices.cend(), index );
+    if ( position == mOtherItemsIndices.cend() || *position != index ) {
+        return nullptr;
+    }
+    return &mOtherItems[ static_cast< std::size_t >( position - mOtherItemsIndices.cbegin() ) ];
+}
+
+auto InputItemsStore::compactItem( std::size_t index ) const -> const CompactItem& {
+    const auto otherItemsBefore = std::lower_bound( mOtherItemsIndices.cbegin(), mOtherItemsIndices.cend(), index )
+                                  - mOtherItemsIndices.cbegin();
+    return mCompactItems[ index - static_cast< std::size_t >( otherItemsBefore ) ];
+}
+
+auto InputItemsStore::compactItemPath( const CompactItem& item ) const -> native_string {
+    const auto& directory = *mDirectories[ item.directory ];
+    native_string result;
+    result.reserve( directory.size() + item.nameLength );
+    result.append( directory ).append( item.names, 0, item.nameLength );
+    return result;
+}
+
+void InputItemsStore::loadMetadata( const CompactItem& item ) const {
+    if ( item.properties.lazyMetadata ) {
+        item.properties = BitInputItem::readFileProperties( compactItemPath( item ), item.symlinkPolicy );
+    }
+}
+
+auto InputItemsStore::itemPath( std::size_t index ) const -> native_string {
+    const auto* item = otherItem( index );
+    if ( item != nullptr ) {
+        return item->path();
+    }
+    return compactItemPath( compactItem( index ) );
+}
+
+auto InputItemsStore::inArchivePath( std::size_t index ) const -> sevenzip_string {
+    const auto* otherItemPtr = otherItem( index );
+    if ( otherItemPtr != nullptr ) {
+        return otherItemPtr->inArchivePath();
+    }
+
+    const auto& item = compactItem( index );
+    const auto& directory = *mDirectories[ item.inArchiveDirectory ];
+    const auto nameStart = item.isRenamed ? item.nameLength : 0;
+    const auto nameLength = item.isRenamed ? native_string::npos : item.nameLength;
+    native_string result;
+    result.reserve( directory.size() + item.names.size() - nameStart );
+    result.append( directory ).append( item.names, nameStart, nameLength );
+    return toSevenzipString( std::move( result ) );
+}
+
+auto InputItemsStore::itemProperty( std::size_t index, BitProperty property ) const -> BitPropVariant {
+    const auto* otherItemPtr = otherItem( index );
+    if ( otherItemPtr != nullptr ) {
+        return otherItemPtr->itemProperty( property );
+    }
+
+    const auto& item = compactItem( index );
+    // Note: the path and the item type are known even if the metadata was not read yet.
+    if ( property != BitProperty::Path && property != BitProperty::IsDir ) {
+        loadMetadata( item );
+    }
+
+    if ( property == BitProperty::Path ) {
+        return BitPropVariant{ inArchivePath( index ) };
+    }
+    return inputItemProperty( item.properties, property );
+}
+
+auto InputItemsStore::regularFilePath( std::size_t index ) const -> native_string {
+    if ( otherItem( index ) != nullptr ) { // Only non-filesystem items are not compacted.
+        return {};
+    }
+
+    const auto& item = compactItem( index );
+    loadMetadata( item );
+    const auto attributes = item.properties.attributes;
+    if ( isDirectoryItem( attributes ) || isStoredSymlinkItem( attributes, item.symlinkPolicy ) ) {
+        return {};
+    }
+    return compactItemPath( item );
+}
+
+auto InputItemsStore::itemStream(
+    std::size_t index,
+    ISequentialInStream** inStream,
+    bool storeOpenFiles,
+    std::uint32_t readBufferSize
+) const -> HRESULT try {
+    const auto* otherItemPtr = otherItem( index );
+    if ( otherItemPtr != nullptr ) {
+        return otherItemPtr->getStream( inStream, storeOpenFiles, readBufferSize );
+    }
+
+    const auto& item = compactItem( index );
+    if ( isDirectoryItem( item.properties.attributes ) ) {
+        return S_OK;
+    }
+
+    auto inStreamLoc = makeFileItemStream( compactItemPath( item ),
+                                           item.properties.attributes,
+                                           item.symlinkPolicy,
+                                           storeOpenFiles,
+                                           readBufferSize );
+    *inStream = inStreamLoc.Detach();
+    return S_OK;
+} catch ( const BitException& exception ) {
+    return exception.hresultCode();
+}
+
+} // namespace bit7z
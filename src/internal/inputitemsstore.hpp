@@ -0,0 +1,114 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INPUTITEMSSTORE_HPP
+#define INPUTITEMSSTORE_HPP
+
+#include "bitinputitem.hpp"
+#include "bititemsvector.hpp"
+#include "bitpropvariant.hpp"
+#include "bittypes.hpp"
+#include "internal/com.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace bit7z {
+
+/**
+ * Compact storage of the items to be compressed by a BitOutputArchive.
+ *
+ * Filesystem items are stored as a pair of interned directory prefixes (one for the filesystem path,
+ * one for the in-archive path) plus the item names, all in the native encoding; the in-archive path is converted
+ * to the 7-Zip wide encoding only when it is requested. Sibling items share their directory prefixes,
+ * and short names fit in the strings' inline storage, so most items need no heap allocations at all.
+ *
+ * All the other kinds of items (buffers, streams, and renamed items) are stored as they are.
+ */
+class InputItemsStore final {
+    public:
+        /**
+         * Moves the given items at the end of the store, leaving the vector empty.
+         */
+        void append( BitItemsVector& items );
+
+        BIT7Z_NODISCARD
+        auto size() const noexcept -> std::size_t;
+
+        BIT7Z_NODISCARD
+        auto itemPath( std::size_t index ) const -> native_string;
+
+        BIT7Z_NODISCARD
+        auto inArchivePath( std::size_t index ) const -> sevenzip_string;
+
+        BIT7Z_NODISCARD
+        auto itemProperty( std::size_t index, BitProperty property ) const -> BitPropVariant;
+
+        /**
+         * @return the filesystem path of the item if it is a file whose content will be compressed,
+         *         or an empty string otherwise (e.g., for directories, buffers, and stored symbolic links).
+         */
+        BIT7Z_NODISCARD
+        auto regularFilePath( std::size_t index ) const -> native_string;
+
+        BIT7Z_NODISCARD
+        auto itemStream(
+            std::size_t index,
+            ISequentialInStream** inStream,
+            bool storeOpenFiles,
+            std::uint32_t readBufferSize
+        ) const -> HRESULT;
+
+    private:
+        using DirectoryId = std::uint32_t;
+
+        struct CompactItem final {
+            // Note: the metadata of lazily indexed items is read when first needed, even from const methods.
+            mutable detail::InputItemProperties properties;
+
+            // The item's filesystem name, followed by its in-archive name if the latter is different.
+            native_string names;
+            DirectoryId directory;
+            DirectoryId inArchiveDirectory;
+            std::uint32_t nameLength;
+            SymlinkPolicy symlinkPolicy;
+            bool isRenamed;
+        };
+
+        // The interned directory prefixes, including their trailing path separator.
+        std::unordered_map< native_string, DirectoryId > mDirectoryIds;
+        std::vector< const native_string* > mDirectories;
+
+        std::vector< CompactItem > mCompactItems;
+
+        // The items that cannot be compacted, and their (sorted) positions in the store.
+        BitItemsVector mOtherItems;
+        std::vector< std::size_t > mOtherItemsIndices;
+
+        auto internDirectory( native_string directory ) -> DirectoryId;
+
+        void appendCompactItem( const BitInputItem& item );
+
+        BIT7Z_NODISCARD
+        auto otherItem( std::size_t index ) const -> const BitInputItem*;
+
+        BIT7Z_NODISCARD
+        auto compactItem( std::size_t index ) const -> const CompactItem&;
+
+        BIT7Z_NODISCARD
+        auto compactItemPath( const CompactItem& item ) const -> native_string;
+
+        void loadMetadata( const CompactItem& item ) const;
+};
+
+} // namespace bit7z
+
+#endif //INPUTITEMSSTORE_HPP
@@ -0,0 +1,75 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/inputitemutil.hpp"
+
+#include "internal/cfileinstream.hpp"
+#include "internal/csymlinkinstream.hpp"
+#include "internal/util.hpp"
+
+namespace bit7z {
+
+auto isDirectoryItem( std::uint32_t attributes ) noexcept -> bool {
+    return HAS_FLAG( attributes, FILE_ATTRIBUTE_DIRECTORY );
+}
+
+auto isSymlinkItem( std::uint32_t attributes ) noexcept -> bool {
+    return HAS_FLAG( attributes, FILE_ATTRIBUTE_REPARSE_POINT );
+}
+
+auto isStoredSymlinkItem( std::uint32_t attributes, SymlinkPolicy symlinkPolicy ) noexcept -> bool {
+    return symlinkPolicy == SymlinkPolicy::DoNotFollow && isSymlinkItem( attributes );
+}
+
+auto inputItemProperty( const detail::InputItemProperties& properties, BitProperty property ) -> BitPropVariant {
+    BitPropVariant prop;
+    switch ( property ) {
+        case BitProperty::IsDir:
+            prop = isDirectoryItem( properties.attributes );
+            break;
+        case BitProperty::Size:
+            // Note: like 7-Zip does for stdin, an unknown size is reported as (UInt64)(Int64)-1 (i.e., kUnknownSize);
+            // the formats storing the size after the data (e.g., 7z, zip, and gzip) will store the actual size read.
+            prop = properties.size;
+            break;
+        case BitProperty::Attrib:
+            prop = properties.attributes;
+            break;
+        case BitProperty::CTime:
+            prop = properties.creationTime;
+            break;
+        case BitProperty::ATime:
+            prop = properties.lastAccessTime;
+            break;
+        case BitProperty::MTime:
+            prop = properties.lastWriteTime;
+            break;
+        default: //empty prop
+            break;
+    }
+    return prop;
+}
+
+auto makeFileItemStream(
+    const native_string& itemPath,
+    std::uint32_t attributes,
+    SymlinkPolicy symlinkPolicy,
+    bool storeOpenFiles,
+    std::uint32_t readBufferSize
+) -> CMyComPtr< ISequentialInStream > {
+    if ( isStoredSymlinkItem( attributes, symlinkPolicy ) ) {
+        return bit7z::make_com< CSymlinkInStream, ISequentialInStream >( itemPath );
+    }
+    return bit7z::make_com< CFileInStream, ISequentialInStream >( itemPath, storeOpenFiles, readBufferSize );
+}
+
+} // namespace bit7z
@@ -0,0 +1,59 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INPUTITEMUTIL_HPP
+#define INPUTITEMUTIL_HPP
+
+#include "bitinputitem.hpp"
+#include "bitpropvariant.hpp"
+#include "bittypes.hpp"
+#include "internal/com.hpp"
+
+#include <7zip/IStream.h>
+
+#include <cstdint>
+
+#define HAS_FLAG( attributes, x ) \
+    ( ( ( attributes ) & static_cast< decltype( attributes ) >( x ) ) == static_cast< decltype( attributes ) >( x ) )
+
+namespace bit7z {
+
+/* The logic shared by BitInputItem and the compact filesystem items of the InputItemsStore. */
+
+BIT7Z_NODISCARD auto isDirectoryItem( std::uint32_t attributes ) noexcept -> bool;
+
+BIT7Z_NODISCARD auto isSymlinkItem( std::uint32_t attributes ) noexcept -> bool;
+
+/**
+ * @return true if the item is a symbolic link to be stored as such, rather than the file it points to.
+ */
+BIT7Z_NODISCARD auto isStoredSymlinkItem( std::uint32_t attributes, SymlinkPolicy symlinkPolicy ) noexcept -> bool;
+
+/**
+ * @return the value of the given property of an item, except for the BitProperty::Path
+ *         (which is stored differently by each kind of item, and must be handled by the caller).
+ */
+BIT7Z_NODISCARD
+auto inputItemProperty( const detail::InputItemProperties& properties, BitProperty property ) -> BitPropVariant;
+
+/**
+ * @return the stream reading the content of the given (non-directory) filesystem item.
+ */
+BIT7Z_NODISCARD
+auto makeFileItemStream(
+    const native_string& itemPath,
+    std::uint32_t attributes,
+    SymlinkPolicy symlinkPolicy,
+    bool storeOpenFiles,
+    std::uint32_t readBufferSize
+) -> CMyComPtr< ISequentialInStream >;
+
+} // namespace bit7z
+
+#endif //INPUTITEMUTIL_HPP
@@ -77,6 +77,8 @@ auto InternalCategory::message( int errorValue ) const -> std::string {
             return "The item has an absolute path.";
         case BitError::InvalidItemPath:
             return "The item has an invalid path.";
+        case BitError::InsufficientOutputBufferSize:
+            return "The output buffer is too small.";
         default:
             return "Unknown internal error (code " + std::to_string( errorValue ) + ").";
     }
@@ -98,6 +100,7 @@ auto InternalCategory::default_error_condition( int errorValue ) const noexcept
         case BitError::NonEmptyOutputBuffer:
         case BitError::NullOutputBuffer:
         case BitError::InvalidZipPassword:
+        case BitError::InsufficientOutputBufferSize:
             return std::make_error_condition( std::errc::invalid_argument );
         case BitError::NoMatchingItems:
         case BitError::NoMatchingFile:
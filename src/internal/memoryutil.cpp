@@ -0,0 +1,67 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "internal/memoryutil.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined( __APPLE__ ) || defined( BSD ) || \
+      defined( __FreeBSD__ ) || defined( __NetBSD__ ) || defined( __OpenBSD__ ) || defined( __DragonFly__ )
+#include <sys/types.h>
+#include <sys/sysctl.h>
+#else
+#include <unistd.h>
+#if !defined( _SC_AVPHYS_PAGES ) || !defined( _SC_PAGE_SIZE )
+# include <sys/sysinfo.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <cstdint>
+
+namespace bit7z {
+
+auto getFreeRam() -> std::uint64_t {
+#if defined( _WIN64 ) || defined( _WIN32 )
+    MEMORYSTATUSEX memStatus{};
+    memStatus.dwLength = sizeof( memStatus );
+    GlobalMemoryStatusEx( &memStatus );
+    return memStatus.ullAvailPhys;
+#elif defined( __APPLE__ ) || defined( BSD ) || \
+      defined( __FreeBSD__ ) || defined( __NetBSD__ ) || defined( __OpenBSD__ ) || defined( __DragonFly__ )
+    static int mib[] = { CTL_HW, HW_USERMEM };
+    std::uint64_t value = 0;
+    std::size_t length = sizeof( value );
+
+    if ( sysctl( mib, 2, &value, &length, nullptr, 0 ) == 0 ) {
+        return value;
+    }
+    return 0;
+#elif defined( _SC_AVPHYS_PAGES ) && defined( _SC_PAGE_SIZE )
+    const long pages = sysconf( _SC_AVPHYS_PAGES );
+    const long page_size = sysconf( _SC_PAGE_SIZE );
+    if ( pages < 0 || page_size < 0 ) {
+        return 0;
+    }
+    return static_cast< std::uint64_t >( pages ) * static_cast< std::uint64_t >( page_size );
+#else
+    struct sysinfo info{};
+    sysinfo (&info);
+    return ( info.freeram + info.bufferram ) * info.mem_unit;
+#endif
+}
+
+auto defaultMaxMemoryUsage() -> std::uint64_t {
+    return std::max( getFreeRam() / 4, kMinMaxMemoryUsage );
+}
+
+} // namespace bit7z
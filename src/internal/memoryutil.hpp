@@ -0,0 +1,34 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef MEMORYUTIL_HPP
+#define MEMORYUTIL_HPP
+
+#include <cstdint>
+
+namespace bit7z {
+
+// Minimum value for the maximum memory usage allowed for a BufferQueue.
+constexpr std::uint64_t kMinMaxMemoryUsage = 4ULL * 1024 * 1024; // 4 MiB //-V112
+
+/**
+ * @return the amount of physical memory currently available on the system (in bytes),
+ *         or zero if it could not be retrieved.
+ */
+auto getFreeRam() -> std::uint64_t;
+
+/**
+ * @return the default max memory usage of the buffers used while extracting nested archives
+ *         (a quarter of the free RAM, but never less than kMinMaxMemoryUsage).
+ */
+auto defaultMaxMemoryUsage() -> std::uint64_t;
+
+} // namespace bit7z
+
+#endif //MEMORYUTIL_HPP
@@ -16,7 +16,7 @@
 #include "bitexception.hpp"
 #include "bitpropvariant.hpp"
 #include "internal/callback.hpp"
-#include "internal/cfileinstream.hpp"
+#include "internal/cmappedfileinstream.hpp"
 #include "internal/fsutil.hpp"
 #include "internal/stringutil.hpp"
 #include "internal/util.hpp"
@@ -73,7 +73,7 @@ STDMETHODIMP OpenCallback::GetStream( const wchar_t* name, IInStream** inStream
         }
 
         try {
-            auto inStreamTemp = bit7z::make_com< CFileInStream >( streamPath.native() );
+            auto inStreamTemp = makeFileInStream( streamPath, mHandler.useMemoryMapping(), mHandler.readBufferSize() );
             *inStream = inStreamTemp.Detach();
         } catch ( const BitException& exception ) {
             return exception.nativeCode();
@@ -18,14 +18,18 @@
 #include "internal/util.hpp"
 
 #include <cstdint>
+#include <utility>
 
 using namespace NWindows;
 
 namespace bit7z {
 
-SequentialExtractCallback::SequentialExtractCallback( const BitInputArchive& inputArchive, BufferQueue& queue )
-    : ExtractCallback( inputArchive ),
-      mBufferQueue{ queue } {}
+SequentialExtractCallback::SequentialExtractCallback(
+    const BitInputArchive& inputArchive,
+    BufferQueue& queue,
+    FilterCallback filterCallback
+) : ExtractCallback( inputArchive, std::move( filterCallback ) ),
+    mBufferQueue{ queue } {}
 
 void SequentialExtractCallback::releaseStream() {
     mSeqOutStream.Release();
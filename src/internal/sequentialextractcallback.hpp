@@ -21,7 +21,11 @@ class BitInputArchive;
 
 class SequentialExtractCallback final : public ExtractCallback {
     public:
-        SequentialExtractCallback( const BitInputArchive& inputArchive, BufferQueue& queue );
+        SequentialExtractCallback(
+            const BitInputArchive& inputArchive,
+            BufferQueue& queue,
+            FilterCallback filterCallback = {}
+        );
 
         SequentialExtractCallback( const SequentialExtractCallback& ) = delete;
 
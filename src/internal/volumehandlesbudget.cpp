@@ -0,0 +1,147 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _WIN32
+
+#include "internal/volumehandlesbudget.hpp"
+
+#include <algorithm>
+#include <climits> // For _POSIX_OPEN_MAX
+#include <unistd.h>
+
+namespace bit7z {
+
+namespace {
+auto defaultMaxOpenHandles() -> std::size_t {
+    // 7-Zip takes into account this number of handles as reserved for other internal needs of the process.
+    constexpr std::size_t kHandlesReserve = 10;
+
+    // The volumes of all the multi-volume archives can use up to half of the remaining handles,
+    // leaving the other half to the files opened by the process for any other purpose.
+    constexpr std::size_t kVolumesShare = 2;
+
+    // We want at least 3 open handles as a threshold.
+    constexpr std::size_t kMinOpenHandles = 3;
+
+    long systemMaxOpenHandles = sysconf( _SC_OPEN_MAX );
+    if ( systemMaxOpenHandles < 1 ) {
+#ifdef _POSIX_OPEN_MAX
+        systemMaxOpenHandles = _POSIX_OPEN_MAX;
+#else
+        systemMaxOpenHandles = 30;
+#endif
+    }
+    const auto availableOpenHandles = static_cast< std::size_t >( systemMaxOpenHandles );
+    const auto result = availableOpenHandles > kHandlesReserve
+                            ? ( availableOpenHandles - kHandlesReserve ) / kVolumesShare
+                            : 1;
+    return std::max( result, kMinOpenHandles );
+}
+} // namespace
+
+VolumeHandlesBudget::VolumeHandlesBudget()
+    : mDefaultMaxOpenHandles{ defaultMaxOpenHandles() },
+      mMaxOpenHandles{ mDefaultMaxOpenHandles },
+      mOpenHandles{ 0 },
+      mOpens{ 0 },
+      mEvictions{ 0 },
+      mAccessCounter{ 0 } {}
+
+auto VolumeHandlesBudget::instance() -> VolumeHandlesBudget& {
+    static VolumeHandlesBudget budget;
+    return budget;
+}
+
+void VolumeHandlesBudget::registerOwner( VolumeHandlesOwner& owner ) {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    mOwners.push_back( &owner );
+}
+
+void VolumeHandlesBudget::unregisterOwner( const VolumeHandlesOwner& owner, std::size_t openHandles ) noexcept {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    const auto ownerIt = std::find( mOwners.begin(), mOwners.end(), &owner );
+    if ( ownerIt != mOwners.end() ) {
+        mOwners.erase( ownerIt );
+    }
+    mOpenHandles -= std::min( openHandles, mOpenHandles );
+}
+
+auto VolumeHandlesBudget::trackOpened( const VolumeHandlesOwner& owner ) noexcept -> bool {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    ++mOpens;
+    ++mOpenHandles;
+    if ( mOpenHandles < mMaxOpenHandles ) {
+        return false;
+    }
+
+    // Looking for the least recently used volume among the owners not in use by other threads.
+    // Note: we only try to lock the other owners, as their threads might be waiting for the budget's mutex.
+    const auto ownCandidate = owner.evictionCandidate();
+    auto lruCandidate = ownCandidate;
+    VolumeHandlesOwner* lruOwner = nullptr;
+    std::unique_lock< std::mutex > lruOwnerLock;
+    for ( auto* otherOwner : mOwners ) {
+        if ( otherOwner == &owner ) {
+            continue;
+        }
+
+        std::unique_lock< std::mutex > otherOwnerLock{ otherOwner->mutex(), std::try_to_lock };
+        if ( !otherOwnerLock.owns_lock() ) {
+            continue;
+        }
+
+        const auto candidate = otherOwner->evictionCandidate();
+        if ( candidate < lruCandidate ) {
+            lruCandidate = candidate;
+            lruOwner = otherOwner;
+            lruOwnerLock = std::move( otherOwnerLock );
+        }
+    }
+
+    if ( lruCandidate == kNoEvictionCandidate ) {
+        return false; // No volume can be closed now, so the budget is temporarily exceeded.
+    }
+
+    --mOpenHandles;
+    ++mEvictions;
+    if ( lruOwner == nullptr ) {
+        return true;
+    }
+    lruOwner->evictCandidate();
+    return false;
+}
+
+void VolumeHandlesBudget::trackClosed() noexcept {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    if ( mOpenHandles > 0 ) {
+        --mOpenHandles;
+    }
+}
+
+auto VolumeHandlesBudget::maxOpenHandles() noexcept -> std::size_t {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    return mMaxOpenHandles;
+}
+
+void VolumeHandlesBudget::setMaxOpenHandles( std::size_t maxHandles ) noexcept {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    mMaxOpenHandles = maxHandles == 0 ? mDefaultMaxOpenHandles : maxHandles;
+}
+
+auto VolumeHandlesBudget::statistics() noexcept -> VolumeHandlesStats {
+    const std::lock_guard< std::mutex > lock{ mMutex };
+    return { mOpenHandles, mMaxOpenHandles, mOpens, mEvictions };
+}
+
+} // namespace bit7z
+
+#endif // !_WIN32
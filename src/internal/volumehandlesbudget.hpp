@@ -0,0 +1,141 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef VOLUMEHANDLESBUDGET_HPP
+#define VOLUMEHANDLESBUDGET_HPP
+
+#ifndef _WIN32
+
+#include "bitdefines.hpp"
+#include "bitvolumehandles.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace bit7z {
+
+constexpr auto kNoEvictionCandidate = std::numeric_limits< std::uint64_t >::max();
+
+/**
+ * @brief Interface of the objects owning volume handles accounted in the VolumeHandlesBudget.
+ *
+ * The mutex of the owner must be held by the thread using its volumes,
+ * so that the budget can close them from other threads only when they are not in use.
+ */
+class VolumeHandlesOwner {
+    public:
+        VolumeHandlesOwner() = default;
+
+        VolumeHandlesOwner( const VolumeHandlesOwner& ) = delete;
+
+        VolumeHandlesOwner( VolumeHandlesOwner&& ) = delete;
+
+        auto operator=( const VolumeHandlesOwner& ) -> VolumeHandlesOwner& = delete;
+
+        auto operator=( VolumeHandlesOwner&& ) -> VolumeHandlesOwner& = delete;
+
+        virtual ~VolumeHandlesOwner() = default;
+
+        /** @brief Returns the mutex protecting the volumes of the owner. */
+        BIT7Z_NODISCARD
+        auto mutex() noexcept -> std::mutex& {
+            return mMutex;
+        }
+
+        /** @brief Returns the last access tick of the volume the owner would close, or kNoEvictionCandidate. */
+        BIT7Z_NODISCARD
+        virtual auto evictionCandidate() const noexcept -> std::uint64_t = 0;
+
+        /** @brief Closes the volume returned by evictionCandidate(). */
+        virtual void evictCandidate() noexcept = 0;
+
+    private:
+        std::mutex mMutex;
+};
+
+/**
+ * @brief Process-wide budget of the handles opened for the volumes of multi-volume archives.
+ *
+ * When a new handle exceeds the budget, the least recently used volume among all the registered
+ * owners is closed; owners whose mutex is held by another thread are skipped.
+ */
+class VolumeHandlesBudget final {
+    public:
+        BIT7Z_NODISCARD static auto instance() -> VolumeHandlesBudget&;
+
+        VolumeHandlesBudget( const VolumeHandlesBudget& ) = delete;
+
+        VolumeHandlesBudget( VolumeHandlesBudget&& ) = delete;
+
+        auto operator=( const VolumeHandlesBudget& ) -> VolumeHandlesBudget& = delete;
+
+        auto operator=( VolumeHandlesBudget&& ) -> VolumeHandlesBudget& = delete;
+
+        ~VolumeHandlesBudget() = default;
+
+        void registerOwner( VolumeHandlesOwner& owner );
+
+        /**
+         * @brief Removes the owner from the budget, releasing the accounting of its still open handles.
+         *
+         * @param owner       the owner to be removed.
+         * @param openHandles the number of handles the owner still has open.
+         */
+        void unregisterOwner( const VolumeHandlesOwner& owner, std::size_t openHandles ) noexcept;
+
+        /** @brief Returns a new access tick, greater than all the previously returned ones. */
+        BIT7Z_NODISCARD
+        auto nextAccess() noexcept -> std::uint64_t {
+            return mAccessCounter.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        /**
+         * @brief Accounts a handle just opened by the given owner, closing the least recently used volume
+         * if the budget is exhausted.
+         *
+         * @note The mutex of the owner must be held by the calling thread.
+         *
+         * @param owner the owner of the opened handle.
+         *
+         * @return true if the least recently used volume is the candidate of the given owner,
+         *         which must then close it by itself (its closing is already accounted).
+         */
+        auto trackOpened( const VolumeHandlesOwner& owner ) noexcept -> bool;
+
+        /** @brief Accounts a handle closed by its owner. */
+        void trackClosed() noexcept;
+
+        BIT7Z_NODISCARD auto maxOpenHandles() noexcept -> std::size_t;
+
+        void setMaxOpenHandles( std::size_t maxHandles ) noexcept;
+
+        BIT7Z_NODISCARD auto statistics() noexcept -> VolumeHandlesStats;
+
+    private:
+        std::mutex mMutex;
+        std::vector< VolumeHandlesOwner* > mOwners;
+        std::size_t mDefaultMaxOpenHandles;
+        std::size_t mMaxOpenHandles;
+        std::size_t mOpenHandles;
+        std::uint64_t mOpens;
+        std::uint64_t mEvictions;
+        std::atomic< std::uint64_t > mAccessCounter;
+
+        VolumeHandlesBudget();
+};
+
+} // namespace bit7z
+
+#endif // !_WIN32
+
+#endif //VOLUMEHANDLESBUDGET_HPP
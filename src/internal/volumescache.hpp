@@ -17,8 +17,9 @@
 #include <type_traits>
 
 #ifndef _WIN32
-#include <climits> // For _POSIX_OPEN_MAX
-#include <unistd.h>
+#include "internal/volumehandlesbudget.hpp"
+
+#include <mutex>
 #endif
 
 namespace bit7z {
@@ -40,6 +41,7 @@ struct CachedVolume final {
 #ifndef _WIN32
     std::size_t newerVolume = kNoVolume;
     std::size_t olderVolume = kNoVolume;
+    std::uint64_t lastAccess = 0;
 #endif
 };
 
@@ -53,42 +55,48 @@ using VolumesCache = std::vector< CachedVolume< T > >;
 
 #else // !_WIN32
 
+/**
+ * @brief Returns the number of open volume handles (among all the volumes caches) triggering an eviction.
+ */
 BIT7Z_ALWAYS_INLINE
 auto openHandlesThreshold() -> std::size_t {
-    // Here we use the same constants and thresholds used by 7-Zip.
-
-    // 7-Zip takes into account this number of handles as reserved for other internal needs of the process.
-    constexpr std::size_t kHandlesReserve = 10;
-
-    // 7-Zip supposes that we have up to 3 file processing tasks within the process.
-    constexpr std::size_t kProcessingTasks = 3;
-
-    // We want at least 3 open handles as a threshold.
-    constexpr std::size_t kMinOpenHandles = 3;
-
-    long systemMaxOpenHandles = sysconf( _SC_OPEN_MAX );
-    if ( systemMaxOpenHandles < 1 ) {
-#ifdef _POSIX_OPEN_MAX
-        systemMaxOpenHandles = _POSIX_OPEN_MAX;
-#else
-        systemMaxOpenHandles = 30;
-#endif
-    }
-    const auto availableOpenHandles = static_cast< std::size_t >( systemMaxOpenHandles );
-    const auto result = availableOpenHandles > kHandlesReserve
-                            ? ( availableOpenHandles - kHandlesReserve ) / kProcessingTasks
-                            : 1;
-    return std::max( result, kMinOpenHandles );
+    return VolumeHandlesBudget::instance().maxOpenHandles();
 }
 
 /**
  * @brief Wraps a std::vector of CachedVolume with an LRU doubly-linked list of open volumes,
  * threaded through CachedVolume::newerVolume/olderVolume.
  * The "newest" end is the head (most recently accessed), the "oldest" end is the tail.
+ *
+ * The open volumes of all the caches share the process-wide VolumeHandlesBudget, so opening a volume
+ * might close the least recently used volume of another cache; hence, the cache must be locked
+ * (see lock()) while its volumes are being opened or used.
  */
 template< typename T, EvictionPolicy Policy >
-class VolumesCache {
+class VolumesCache final : public VolumeHandlesOwner {
     public:
+        VolumesCache() {
+            VolumeHandlesBudget::instance().registerOwner( *this );
+        }
+
+        VolumesCache( const VolumesCache& ) = delete;
+
+        VolumesCache( VolumesCache&& ) = delete;
+
+        auto operator=( const VolumesCache& ) -> VolumesCache& = delete;
+
+        auto operator=( VolumesCache&& ) -> VolumesCache& = delete;
+
+        ~VolumesCache() override {
+            VolumeHandlesBudget::instance().unregisterOwner( *this, mOpenCount );
+        }
+
+        /** @brief Locks the cache, preventing other threads from closing its volumes. */
+        BIT7Z_NODISCARD
+        auto lock() -> std::unique_lock< std::mutex > {
+            return std::unique_lock< std::mutex >{ mutex() };
+        }
+
         /** @brief Returns the cached volume at the given index. */
         BIT7Z_NODISCARD
         auto operator[]( std::size_t index ) noexcept -> CachedVolume< T >& {
@@ -190,6 +198,15 @@ class VolumesCache {
             linkAsNewest( volume, index );
         }
 
+        /**
+         * @brief Marks the newest volume as just accessed, without changing the LRU list.
+         *
+         * @param volume The newest volume.
+         */
+        void touch( CachedVolume< T >& volume ) noexcept {
+            volume.lastAccess = VolumeHandlesBudget::instance().nextAccess();
+        }
+
         /**
          * @brief Unlinks a volume from its current position in the LRU list (does not release the stream).
          *
@@ -218,6 +235,22 @@ class VolumesCache {
          */
         void trackClosed() noexcept {
             --mOpenCount;
+            VolumeHandlesBudget::instance().trackClosed();
+        }
+
+        /** @brief Returns the last access tick of the volume the eviction policy would close. */
+        BIT7Z_NODISCARD
+        auto evictionCandidate() const noexcept -> std::uint64_t override {
+            const auto candidate = Policy == EvictionPolicy::Oldest ? mOldest : mNewest;
+            if ( candidate == kNoVolume ) {
+                return kNoEvictionCandidate;
+            }
+            return mVolumes[ candidate ].lastAccess; // NOLINT(*-pro-bounds-*)
+        }
+
+        /** @brief Closes the volume the eviction policy would close. */
+        void evictCandidate() noexcept override {
+            evict();
         }
 
     private:
@@ -236,6 +269,7 @@ class VolumesCache {
             }
             volume.olderVolume = mNewest;
             volume.newerVolume = kNoVolume;
+            volume.lastAccess = VolumeHandlesBudget::instance().nextAccess();
             mNewest = index;
         }
 
@@ -271,11 +305,10 @@ class VolumesCache {
             --mOpenCount;
         }
 
-        // Tracks a newly opened stream and evicts a volume if the open-handles threshold is reached.
+        // Tracks a newly opened stream and evicts a volume if the budget chose one of this cache.
         void trackOpened() noexcept {
             ++mOpenCount;
-            static const auto threshold = openHandlesThreshold();
-            if ( mOpenCount >= threshold ) {
+            if ( VolumeHandlesBudget::instance().trackOpened( *this ) ) {
                 evict();
             }
         }
@@ -403,6 +403,126 @@ TEMPLATE_LIST_TEST_CASE(
     REQUIRE_FALSE( compressor.storeOpenFiles() );
 }
 
+TEMPLATE_LIST_TEST_CASE(
+    "BitAbstractArchiveCreator: setLazyFileMetadata(...) / lazyFileMetadata()",
+    "[bitabstractarchivecreator]",
+    CreatorTypes
+) {
+    TestType compressor( test::sevenzipLib(), BitFormat::SevenZip );
+    REQUIRE_FALSE( compressor.lazyFileMetadata() );
+
+    compressor.setLazyFileMetadata( true );
+    REQUIRE( compressor.lazyFileMetadata() );
+
+    compressor.setLazyFileMetadata( false );
+    REQUIRE_FALSE( compressor.lazyFileMetadata() );
+}
+
+TEMPLATE_LIST_TEST_CASE(
+    "BitAbstractArchiveCreator: setDeduplicateFiles(...) / deduplicateFiles()",
+    "[bitabstractarchivecreator]",
+    CreatorTypes
+) {
+    TestType compressor( test::sevenzipLib(), BitFormat::SevenZip );
+    REQUIRE_FALSE( compressor.deduplicateFiles() );
+
+    compressor.setDeduplicateFiles( true );
+    REQUIRE( compressor.deduplicateFiles() );
+
+    compressor.setDeduplicateFiles( false );
+    REQUIRE_FALSE( compressor.deduplicateFiles() );
+}
+
+TEMPLATE_LIST_TEST_CASE(
+    "BitAbstractArchiveCreator: setSortStrategy(...) / sortStrategy()",
+    "[bitabstractarchivecreator]",
+    CreatorTypes
+) {
+    TestType compressor( test::sevenzipLib(), BitFormat::SevenZip );
+    REQUIRE( compressor.sortStrategy() == SortStrategy::None );
+
+    compressor.setSortStrategy( SortStrategy::ByType );
+    REQUIRE( compressor.sortStrategy() == SortStrategy::ByType );
+
+    compressor.setSortStrategy( SortStrategy::None );
+    REQUIRE( compressor.sortStrategy() == SortStrategy::None );
+}
+
+TEMPLATE_LIST_TEST_CASE(
+    "BitAbstractArchiveCreator: setStoreIncompressibleFiles(...) / storeIncompressibleFiles()",
+    "[bitabstractarchivecreator]",
+    CreatorTypes
+) {
+    TestType compressor( test::sevenzipLib(), BitFormat::SevenZip );
+    REQUIRE_FALSE( compressor.storeIncompressibleFiles() );
+
+    compressor.setStoreIncompressibleFiles( true );
+    REQUIRE( compressor.storeIncompressibleFiles() );
+
+    compressor.setStoreIncompressibleFiles( false );
+    REQUIRE_FALSE( compressor.storeIncompressibleFiles() );
+}
+
+TEMPLATE_LIST_TEST_CASE(
+    "BitAbstractArchiveCreator: setReadBufferSize(...) / readBufferSize()",
+    "[bitabstractarchivecreator]",
+    CreatorTypes
+) {
+    TestType compressor( test::sevenzipLib(), BitFormat::SevenZip );
+    REQUIRE( compressor.readBufferSize() == 0 );
+
+    compressor.setReadBufferSize( 64 * 1024 );
+    REQUIRE( compressor.readBufferSize() == 64 * 1024 );
+
+    compressor.setReadBufferSize( 0 );
+    REQUIRE( compressor.readBufferSize() == 0 );
+}
+
+TEMPLATE_LIST_TEST_CASE(
+    "BitAbstractArchiveCreator: setUseMemoryMapping(...) / useMemoryMapping()",
+    "[bitabstractarchivecreator]",
+    CreatorTypes
+) {
+    TestType compressor( test::sevenzipLib(), BitFormat::SevenZip );
+    REQUIRE_FALSE( compressor.useMemoryMapping() );
+
+    compressor.setUseMemoryMapping( true );
+    REQUIRE( compressor.useMemoryMapping() );
+
+    compressor.setUseMemoryMapping( false );
+    REQUIRE_FALSE( compressor.useMemoryMapping() );
+}
+
+TEMPLATE_LIST_TEST_CASE(
+    "BitAbstractArchiveCreator: setWriteBufferSize(...) / writeBufferSize()",
+    "[bitabstractarchivecreator]",
+    CreatorTypes
+) {
+    TestType compressor( test::sevenzipLib(), BitFormat::SevenZip );
+    REQUIRE( compressor.writeBufferSize() == 0u );
+
+    compressor.setWriteBufferSize( 1024u * 1024u );
+    REQUIRE( compressor.writeBufferSize() == 1024u * 1024u );
+
+    compressor.setWriteBufferSize( 0u );
+    REQUIRE( compressor.writeBufferSize() == 0u );
+}
+
+TEMPLATE_LIST_TEST_CASE(
+    "BitAbstractArchiveCreator: setSequentialOutput(...) / sequentialOutput()",
+    "[bitabstractarchivecreator]",
+    CreatorTypes
+) {
+    TestType compressor( test::sevenzipLib(), BitFormat::Tar );
+    REQUIRE_FALSE( compressor.sequentialOutput() );
+
+    compressor.setSequentialOutput( true );
+    REQUIRE( compressor.sequentialOutput() );
+
+    compressor.setSequentialOutput( false );
+    REQUIRE_FALSE( compressor.sequentialOutput() );
+}
+
 TEMPLATE_LIST_TEST_CASE(
     "BitAbstractArchiveCreator: setThreadCount(...) / threadCount()",
     "[bitabstractarchivecreator]",
@@ -999,3 +999,44 @@ TEST_CASE( "BitArchiveEditor: Adding a new file to an existing archive", "[bitar
     REQUIRE( items[ BIT7Z_STRING( "alpha.txt" ) ] == alphaBytes );
     REQUIRE( items[ BIT7Z_STRING( "beta.txt" ) ] == betaBytes );
 }
+
+TEST_CASE( "BitArchiveEditor: Applying several rounds of changes with the same editor", "[bitarchiveeditor]" ) {
+    const Bit7zLibrary lib{ sevenzipLibPath() };
+    const TempTestDirectory testDir{ "bitarchiveeditor" };
+
+    const tstring archivePathStr = to_tstring( testDir.path() / BIT7Z_NATIVE_STRING( "archive.7z" ) );
+    const buffer_t alphaBytes = as_bytes( "Alpha original" );
+    const buffer_t betaBytes = as_bytes( "Beta original" );
+    seedArchive( lib, archivePathStr, {
+        { BIT7Z_STRING( "alpha.txt" ), alphaBytes },
+        { BIT7Z_STRING( "beta.txt" ), betaBytes }
+    } );
+
+    const auto policy = GENERATE( ReopenPolicy::Immediate, ReopenPolicy::Deferred );
+    DYNAMIC_SECTION( "Deferred reopen: " << ( policy == ReopenPolicy::Deferred ) ) {
+        const buffer_t addedBytes = as_bytes( "Added content" );
+        const buffer_t updatedBytes = as_bytes( "Beta updated" );
+        {
+            BitArchiveEditor editor{ lib, archivePathStr, BitFormat::SevenZip };
+            editor.addFile( addedBytes, BIT7Z_STRING( "added.txt" ) );
+            REQUIRE_NOTHROW( editor.applyChanges( policy ) );
+            // The changes already applied must not be applied again.
+            REQUIRE( editor.itemsCount() == 3u );
+
+            REQUIRE_NOTHROW( editor.deleteItem( BIT7Z_STRING( "alpha.txt" ) ) );
+            REQUIRE_NOTHROW( editor.updateItem( BIT7Z_STRING( "beta.txt" ), updatedBytes ) );
+            REQUIRE_NOTHROW( editor.applyChanges( policy ) );
+            REQUIRE( editor.itemsCount() == 2u );
+
+            // Without any new change, applying the changes does nothing.
+            REQUIRE_NOTHROW( editor.applyChanges( policy ) );
+        }
+
+        const BitArchiveReader reader{ lib, archivePathStr, BitFormat::SevenZip };
+        REQUIRE( reader.itemsCount() == 2u );
+        std::map< tstring, buffer_t > items;
+        reader.extractTo( items );
+        REQUIRE( items[ BIT7Z_STRING( "added.txt" ) ] == addedBytes );
+        REQUIRE( items[ BIT7Z_STRING( "beta.txt" ) ] == updatedBytes );
+    }
+}
@@ -0,0 +1,88 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <bit7z/bitbufferview.hpp>
+#include <bit7z/bittypes.hpp>
+
+#include <array>
+#include <string>
+
+using bit7z::BitBufferView;
+using bit7z::buffer_t;
+using bit7z::byte_t;
+
+TEST_CASE( "BitBufferView: Creating an empty view", "[bitbufferview]" ) {
+    constexpr BitBufferView view{};
+
+    REQUIRE( view.data() == nullptr );
+    REQUIRE( view.size() == 0 ); // NOLINT(*-container-size-empty)
+    REQUIRE( view.empty() );
+    REQUIRE( view.begin() == view.end() );
+}
+
+TEST_CASE( "BitBufferView: Creating a view of an empty buffer", "[bitbufferview]" ) {
+    const buffer_t buffer{};
+    const BitBufferView view{ buffer };
+
+    REQUIRE( view.data() == nullptr );
+    REQUIRE( view.size() == 0 ); // NOLINT(*-container-size-empty)
+    REQUIRE( view.empty() );
+    REQUIRE( view.begin() == view.end() );
+}
+
+TEST_CASE( "BitBufferView: Creating a view of a buffer", "[bitbufferview]" ) {
+    const buffer_t buffer{ 1, 2, 3, 4, 5 };
+    const BitBufferView view{ buffer };
+
+    REQUIRE( view.data() == buffer.data() );
+    REQUIRE( view.size() == buffer.size() );
+    REQUIRE_FALSE( view.empty() );
+    REQUIRE( buffer_t( view.begin(), view.end() ) == buffer );
+}
+
+TEST_CASE( "BitBufferView: Creating a view of a std::array", "[bitbufferview]" ) {
+    const std::array< byte_t, 3 > array{ { 1, 2, 3 } };
+    const BitBufferView view{ array };
+
+    REQUIRE( view.data() == array.data() );
+    REQUIRE( view.size() == array.size() );
+    REQUIRE_FALSE( view.empty() );
+}
+
+TEST_CASE( "BitBufferView: Creating a view of a C array", "[bitbufferview]" ) {
+    const byte_t array[] = { 1, 2, 3, 4 }; // NOLINT(*-avoid-c-arrays)
+    const BitBufferView view{ array };
+
+    REQUIRE( view.data() == &array[ 0 ] );
+    REQUIRE( view.size() == 4 );
+    REQUIRE_FALSE( view.empty() );
+}
+
+TEST_CASE( "BitBufferView: Creating a view of a memory region", "[bitbufferview]" ) {
+    const std::string content = "Hello World!";
+    const auto* contentData = reinterpret_cast< const byte_t* >( content.data() );
+
+    const BitBufferView view{ contentData, content.size() };
+    REQUIRE( view.data() == contentData );
+    REQUIRE( view.size() == content.size() );
+    REQUIRE( std::string( view.begin(), view.end() ) == content );
+
+    const BitBufferView emptyView{ contentData, 0 };
+    REQUIRE( emptyView.data() == nullptr );
+    REQUIRE( emptyView.empty() );
+
+    const BitBufferView nullView{ nullptr, 10 };
+    REQUIRE( nullView.data() == nullptr );
+    REQUIRE( nullView.empty() );
+}
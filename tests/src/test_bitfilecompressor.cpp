@@ -22,6 +22,7 @@
 #include <bit7z/bitfilecompressor.hpp>
 #include <bit7z/bitformat.hpp>
 
+#include <cstdint>
 #include <map>
 #include <ostream>
 #include <sstream>
@@ -148,6 +149,36 @@ TEST_CASE( "BitFileCompressor: Compressing a vector of filesystem paths", "[bitf
     fs::remove( outArchive );
 }
 
+TEST_CASE( "BitFileCompressor: Compressing filesystem paths with a write buffer", "[bitfilecompressor]" ) {
+    static const TestDirectory testDir{ test_filesystem_dir };
+    const TempDirectory outDir{ "test_bitfilecompressor" };
+
+    const auto testFormat = GENERATE(
+        as< TestOutputFormat >(),
+        TestOutputFormat{ "7z", BitFormat::SevenZip },
+        TestOutputFormat{ "tar", BitFormat::Tar },
+        TestOutputFormat{ "zip", BitFormat::Zip }
+    );
+
+    const auto outArchive = outDir.path() / ( "output." + testFormat.extension );
+    const auto outArchiveStr = to_tstring( outArchive );
+
+    // Small buffers make the seeks back done for writing the archive headers land outside the buffered data.
+    const std::uint32_t writeBufferSize = GENERATE( 1u, 4096u, 1024u * 1024u );
+    DYNAMIC_SECTION( testFormat.extension << ": write buffer size " << writeBufferSize ) {
+        BitFileCompressor compressor{ test::sevenzipLib(), testFormat.format };
+        compressor.setWriteBufferSize( writeBufferSize );
+
+        const std::vector< tstring > inPaths{ italy.name, loremIpsum.name };
+        REQUIRE_NOTHROW( compressor.compress( inPaths, outArchiveStr ) );
+
+        const BitArchiveReader reader{ test::sevenzipLib(), outArchiveStr, testFormat.format };
+        REQUIRE_NEW_ARCHIVE( reader, multipleFilesContent() );
+    }
+
+    fs::remove( outArchive );
+}
+
 TEST_CASE( "BitFileCompressor: Compressing filesystem paths using aliases (vector of pairs)", "[bitfilecompressor]" ) {
     static const TestDirectory testDir{ test_filesystem_dir };
     const TempDirectory outDir{ "test_bitfilecompressor" };
@@ -20,6 +20,8 @@
 
 #include "utils/crc.hpp"
 
+#include <map>
+
 using namespace bit7z;
 using namespace bit7z::test;
 using namespace bit7z::test::filesystem;
@@ -349,6 +351,51 @@ TEST_CASE(
     }
 }
 
+TEST_CASE( "BitFileExtractor: extracting archives read via memory mapping", "[bitfileextractor]" ) {
+    const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "multiple_items" };
+
+#ifdef BIT7Z_BUILD_FOR_P7ZIP
+    const auto testArchive = GENERATE(
+        as< TestInputFormat >(),
+        TestInputFormat{ "7z", BitFormat::SevenZip },
+        TestInputFormat{ "iso", BitFormat::Iso },
+        TestInputFormat{ "tar", BitFormat::Tar },
+        TestInputFormat{ "wim", BitFormat::Wim },
+        TestInputFormat{ "zip", BitFormat::Zip }
+    );
+#else
+    const auto testArchive = GENERATE(
+        as< TestInputFormat >(),
+        TestInputFormat{ "7z", BitFormat::SevenZip },
+        TestInputFormat{ "iso", BitFormat::Iso },
+        TestInputFormat{ "rar4.rar", BitFormat::Rar },
+        TestInputFormat{ "rar5.rar", BitFormat::Rar5 },
+        TestInputFormat{ "tar", BitFormat::Tar },
+        TestInputFormat{ "wim", BitFormat::Wim },
+        TestInputFormat{ "zip", BitFormat::Zip }
+    );
+#endif
+
+    const auto useMemoryMapping = GENERATE( true, false );
+    const auto readBufferSize = GENERATE( 0u, 4096u );
+
+    DYNAMIC_SECTION( "Archive format: " << testArchive.extension << ", memory mapping: " << useMemoryMapping
+                     << ", read buffer size: " << readBufferSize ) {
+        const fs::path arcFileName = "multiple_items." + testArchive.extension;
+
+        const BitFileExtractor extractor( test::sevenzipLib(), testArchive.format );
+        std::map< tstring, buffer_t > expectedContent;
+        REQUIRE_NOTHROW( extractor.extract( to_tstring( arcFileName ), expectedContent ) );
+
+        BitFileExtractor mappedExtractor( test::sevenzipLib(), testArchive.format );
+        mappedExtractor.setUseMemoryMapping( useMemoryMapping );
+        mappedExtractor.setReadBufferSize( readBufferSize );
+        std::map< tstring, buffer_t > extractedContent;
+        REQUIRE_NOTHROW( mappedExtractor.extract( to_tstring( arcFileName ), extractedContent ) );
+        REQUIRE( extractedContent == expectedContent );
+    }
+}
+
 #ifdef BIT7Z_REGEX_MATCHING
 
 TEST_CASE( "BitFileExtractor: using an empty regex pattern should throw (filesystem output)", "[bitfileextractor]" ) {
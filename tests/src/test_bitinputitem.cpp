@@ -19,11 +19,13 @@
 
 #include "utils/filesystem.hpp"
 #include "utils/shared_lib.hpp"
+#include "utils/streams.hpp"
 
 #include "bitarchivereader.hpp"
 #include "bitexception.hpp"
 #include "bitinputitem.hpp"
 
+#include <istream>
 #include <sstream>
 
 using bit7z::buffer_t;
@@ -144,6 +146,26 @@ TEST_CASE( "BitInputItem std::istream constructor should set the correct metadat
     REQUIRE( item.hasNewData() );
 }
 
+TEST_CASE( "BitInputItem std::istream constructor should handle non-seekable streams", "[bitinputitem]" ) {
+    const buffer_t data( 100, static_cast< byte_t >( 'a' ) );
+    test::NonSeekableInputBuffer inputBuffer{ data };
+    std::istream inputStream{ &inputBuffer };
+    REQUIRE( inputStream.tellg() == std::istream::pos_type{ -1 } );
+
+    const BitInputItem item{ inputStream, BIT7Z_STRING( "stream.txt" ) };
+    REQUIRE_FALSE( item.hasKnownSize() );
+    REQUIRE( item.size() == BitInputItem::kUnknownSize );
+    REQUIRE( item.itemProperty( BitProperty::Size ).getUInt64() == BitInputItem::kUnknownSize );
+    REQUIRE( item.hasNewData() );
+
+    // The stream must not have been consumed.
+    REQUIRE( inputStream.get() == 'a' );
+
+    std::istringstream seekableStream{ "Hello, World!" };
+    const BitInputItem seekableItem{ seekableStream, BIT7Z_STRING( "seekable.txt" ) };
+    REQUIRE( seekableItem.hasKnownSize() );
+}
+
 TEST_CASE(
     "BitInputItem rename constructor should correctly read the metadata of an item from an existing archive",
     "[bitinputitem]"
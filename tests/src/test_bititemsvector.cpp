@@ -3914,3 +3914,70 @@ TEST_CASE( "BitItemsVector: Indexing long paths", "[bititemsvector]" ) {
 }
 
 #endif
+
+TEST_CASE( "BitItemsVector: Indexing a directory gives the same items order on every run", "[bititemsvector]" ) {
+    static const TestDirectory testDir{ test_filesystem_dir };
+
+    BitItemsVector firstRun;
+    REQUIRE_NOTHROW( indexDirectory( firstRun, BIT7Z_STRING( "." ) ) );
+
+    BitItemsVector secondRun;
+    REQUIRE_NOTHROW( indexDirectory( secondRun, BIT7Z_STRING( "." ) ) );
+
+    REQUIRE( firstRun.size() == secondRun.size() );
+    for ( std::size_t index = 0; index < firstRun.size(); ++index ) {
+        REQUIRE( firstRun[ index ].inArchivePath() == secondRun[ index ].inArchivePath() );
+    }
+
+    // Each folder must be listed right before its content (pre-order), as the folders are indexed concurrently.
+    for ( std::size_t index = 0; index < firstRun.size(); ++index ) {
+        const fs::path parentPath = fs::path{ firstRun[ index ].inArchivePath() }.parent_path();
+        if ( parentPath.empty() ) {
+            continue;
+        }
+        const auto parentItem = std::find_if(
+            firstRun.cbegin(),
+            firstRun.cend(),
+            [ &parentPath ]( const BitInputItem& item ) -> bool {
+                return fs::path{ item.inArchivePath() } == parentPath;
+            }
+        );
+        REQUIRE( parentItem != firstRun.cend() );
+        REQUIRE( static_cast< std::size_t >( std::distance( firstRun.cbegin(), parentItem ) ) < index );
+    }
+}
+
+TEST_CASE( "BitItemsVector: Indexing a directory with lazy metadata", "[bititemsvector]" ) {
+    static const TestDirectory testDir{ test_filesystem_dir };
+
+    const auto symlinkPolicy = GENERATE( SymlinkPolicy::Follow, SymlinkPolicy::DoNotFollow );
+
+    IndexingOptions options{};
+    options.symlinkPolicy = symlinkPolicy;
+
+    BitItemsVector expectedItems;
+    REQUIRE_NOTHROW( indexDirectory( expectedItems, BIT7Z_STRING( "." ), {}, options ) );
+
+    options.lazyMetadata = true;
+    BitItemsVector lazyItems;
+    REQUIRE_NOTHROW( indexDirectory( lazyItems, BIT7Z_STRING( "." ), {}, options ) );
+
+    REQUIRE( lazyItems.size() == expectedItems.size() );
+    for ( std::size_t index = 0; index < lazyItems.size(); ++index ) {
+        const auto& lazyItem = lazyItems[ index ];
+        const auto& expectedItem = expectedItems[ index ];
+        INFO( "Item index: " << index )
+        REQUIRE( lazyItem.path() == expectedItem.path() );
+        REQUIRE( lazyItem.inArchivePath() == expectedItem.inArchivePath() );
+
+        // The item type is known without reading the metadata.
+        REQUIRE( lazyItem.isDir() == expectedItem.isDir() );
+        REQUIRE( lazyItem.isSymLink() == expectedItem.isSymLink() );
+
+        // The metadata is read on first use.
+        REQUIRE( lazyItem.itemProperty( BitProperty::Size ) == expectedItem.itemProperty( BitProperty::Size ) );
+        REQUIRE( lazyItem.itemProperty( BitProperty::MTime ) == expectedItem.itemProperty( BitProperty::MTime ) );
+        REQUIRE( lazyItem.attributes() == expectedItem.attributes() );
+        REQUIRE( lazyItem.size() == expectedItem.size() );
+    }
+}
@@ -0,0 +1,179 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/archive.hpp"
+#include "utils/shared_lib.hpp"
+
+#include <bit7z/bitexception.hpp>
+#include <bit7z/bitnestedarchivepipeline.hpp>
+#include <bit7z/bittypes.hpp>
+
+using namespace bit7z;
+using namespace bit7z::test;
+using namespace bit7z::test::filesystem;
+
+namespace {
+auto tarballFormat( const BitArchiveItem& item ) -> const BitInFormat& {
+    const auto& ext = item.extension();
+    if ( ext == BIT7Z_STRING( "gz" ) ) {
+        return BitFormat::GZip;
+    }
+    if ( ext == BIT7Z_STRING( "bz2" ) ) {
+        return BitFormat::BZip2;
+    }
+    return BitFormat::Xz;
+}
+} // namespace
+
+// NOLINTNEXTLINE(*-err58-cpp)
+TEST_CASE( "BitNestedArchivePipeline: Reading a deeply-nested archive", "[bitnestedarchivepipeline]" ) {
+    const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "nested" };
+
+    const tstring arcFileName = BIT7Z_STRING( "deeply_nested.tar" );
+    const BitArchiveReader outerArchive( test::sevenzipLib(), arcFileName, BitFormat::Tar );
+
+    for ( const auto& item : outerArchive ) {
+        const auto& format = tarballFormat( item );
+        const BitNestedArchiveReader tarballArchive( test::sevenzipLib(), outerArchive, item.index(), format );
+        const auto innerPath = tarballArchive.items().front().path();
+
+        const auto nestedPath = arcFileName + BIT7Z_STRING( "!/" ) + item.path() + BIT7Z_STRING( "!/" ) + innerPath;
+        INFO( "Nested path: " << nestedPath )
+
+        const BitNestedArchivePipeline pipeline( test::sevenzipLib(),
+                                                 nestedPath,
+                                                 { BitFormat::Tar, format, BitFormat::Tar } );
+        REQUIRE( pipeline.stagesCount() == 2 );
+
+        const auto& innerArchive = pipeline.archive();
+        REQUIRE( innerArchive.itemsCount() == multipleFilesContent().fileCount );
+        REQUIRE_NOTHROW( innerArchive.test() );
+
+        const TempTestDirectory outDir{ "test_bitnestedarchivepipeline" };
+        INFO( "Test directory: " << outDir )
+        REQUIRE_NOTHROW( innerArchive.extractTo( outDir ) );
+        for ( const auto& expectedItem : multipleFilesContent().items ) {
+            REQUIRE_FILESYSTEM_ITEM( expectedItem );
+        }
+    }
+}
+
+// NOLINTNEXTLINE(*-err58-cpp)
+TEST_CASE( "BitNestedArchivePipeline: Splitting the memory budget among the stages", "[bitnestedarchivepipeline]" ) {
+    const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "nested" };
+
+    const tstring arcFileName = BIT7Z_STRING( "deeply_nested.tar" );
+    const BitArchiveReader outerArchive( test::sevenzipLib(), arcFileName, BitFormat::Tar );
+    const auto tarball = outerArchive.itemAt( 0 );
+
+    // Note: the innermost archive is looked up only when reading it, so its path is not checked here.
+    const auto nestedPath = arcFileName + BIT7Z_STRING( "!/" ) + tarball.path() + BIT7Z_STRING( "!/inner.tar" );
+    BitNestedArchivePipeline pipeline( test::sevenzipLib(),
+                                       nestedPath,
+                                       { BitFormat::Tar, tarballFormat( tarball ), BitFormat::Tar } );
+    REQUIRE( pipeline.stagesCount() == 2 );
+
+    constexpr auto kMemoryBudget = 64ULL * 1024 * 1024; // 64 MiB
+    pipeline.setMaxMemoryUsage( kMemoryBudget );
+    REQUIRE( pipeline.maxMemoryUsage() == kMemoryBudget );
+    REQUIRE( pipeline.archive().maxMemoryUsage() == kMemoryBudget / 2 );
+
+    // Each stage is still allowed to use at least the minimum memory.
+    pipeline.setMaxMemoryUsage( 0 );
+    REQUIRE( pipeline.archive().maxMemoryUsage() == 4ULL * 1024 * 1024 );
+}
+
+// NOLINTNEXTLINE(*-err58-cpp)
+TEST_CASE( "BitNestedArchivePipeline: Invalid nested paths", "[bitnestedarchivepipeline]" ) {
+    const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "nested" };
+
+    SECTION( "Path without nested archives" ) {
+        REQUIRE_THROWS_AS( BitNestedArchivePipeline( test::sevenzipLib(),
+                                                     BIT7Z_STRING( "deeply_nested.tar" ),
+                                                     { BitFormat::Tar } ), BitException );
+    }
+
+    SECTION( "Path with an empty component" ) {
+        REQUIRE_THROWS_AS( BitNestedArchivePipeline( test::sevenzipLib(),
+                                                     BIT7Z_STRING( "deeply_nested.tar!/!/inner.tar" ),
+                                                     { BitFormat::Tar, BitFormat::GZip, BitFormat::Tar } ),
+                           BitException );
+    }
+
+    SECTION( "Wrong number of formats" ) {
+        REQUIRE_THROWS_AS( BitNestedArchivePipeline( test::sevenzipLib(),
+                                                     BIT7Z_STRING( "deeply_nested.tar!/inner.tar.gz" ),
+                                                     { BitFormat::Tar } ), BitException );
+    }
+
+    SECTION( "Non-existing nested archive" ) {
+        REQUIRE_THROWS_AS( BitNestedArchivePipeline( test::sevenzipLib(),
+                                                     BIT7Z_STRING( "deeply_nested.tar!/non_existing.tar.gz" ),
+                                                     { BitFormat::Tar, BitFormat::GZip } ), BitException );
+    }
+}
+
+// NOLINTNEXTLINE(*-err58-cpp)
+TEST_CASE( "BitNestedArchivePipeline: Cancelling the pipeline", "[bitnestedarchivepipeline]" ) {
+    const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "nested" };
+
+    const tstring arcFileName = BIT7Z_STRING( "deeply_nested.tar" );
+    const BitArchiveReader outerArchive( test::sevenzipLib(), arcFileName, BitFormat::Tar );
+    const auto tarball = outerArchive.itemAt( 0 );
+    const auto& format = tarballFormat( tarball );
+    const BitNestedArchiveReader tarballArchive( test::sevenzipLib(), outerArchive, tarball.index(), format );
+    const auto innerPath = tarballArchive.items().front().path();
+
+    const auto nestedPath = arcFileName + BIT7Z_STRING( "!/" ) + tarball.path() + BIT7Z_STRING( "!/" ) + innerPath;
+    INFO( "Nested path: " << nestedPath )
+
+    BitNestedArchivePipeline pipeline( test::sevenzipLib(), nestedPath, { BitFormat::Tar, format, BitFormat::Tar } );
+    const auto& innerArchive = pipeline.archive();
+
+    SECTION( "Cancelling between two reads" ) {
+        // Reading the items in order doesn't need to reopen the archive...
+        const auto firstPath = innerArchive.itemProperty( 0, BitProperty::Path );
+        REQUIRE( innerArchive.openCount() == 1 );
+
+        // ...unless the pipeline was cancelled in between.
+        pipeline.cancel();
+        const auto secondPath = innerArchive.itemProperty( 1, BitProperty::Path );
+        REQUIRE( innerArchive.openCount() == 2 );
+        REQUIRE( secondPath.isString() );
+        REQUIRE( secondPath.getString() != firstPath.getString() );
+    }
+
+    SECTION( "Cancelling while extracting the innermost archive" ) {
+        pipeline.archive().setProgressCallback( [ &pipeline ]( std::uint64_t ) -> bool {
+            pipeline.cancel();
+            return true;
+        } );
+        // Note: the extraction might still succeed if the cancelled data was already buffered.
+        try {
+            innerArchive.test();
+        } catch ( const BitException& ) { // NOLINT(*-empty-catch)
+        }
+
+        // The pipeline is reopened by the next operation.
+        pipeline.archive().setProgressCallback( {} );
+        const auto openCount = innerArchive.openCount();
+        REQUIRE_NOTHROW( innerArchive.test() );
+        REQUIRE( innerArchive.openCount() == openCount + 1 );
+    }
+
+    SECTION( "Cancelling an idle pipeline" ) {
+        REQUIRE_NOTHROW( pipeline.cancel() );
+        REQUIRE( innerArchive.itemsCount() == multipleFilesContent().fileCount );
+    }
+}
@@ -37,7 +37,7 @@ void require_extracts_to_filesystem( const BitNestedArchiveReader& info, const E
 #ifdef BIT7Z_AUTO_FORMAT
 // NOLINTNEXTLINE(*-err58-cpp)
 TEMPLATE_TEST_CASE(
-    "BitNestedArchiveReader: Automatic format detection is not supported",
+    "BitNestedArchiveReader: Automatic format detection of nested archives",
     "[bitnestedarchivereader]",
     tstring,
     buffer_t,
@@ -61,7 +61,15 @@ TEMPLATE_TEST_CASE(
         getInputArchive( arcFileName, inputArchive );
         const BitArchiveReader outerArchive( test::sevenzipLib(), inputArchive, testArchive.format );
 
-        REQUIRE_THROWS( BitNestedArchiveReader{ test::sevenzipLib(), outerArchive, BitFormat::Auto } );
+        const BitNestedArchiveReader innerArchive( test::sevenzipLib(), outerArchive, BitFormat::Auto );
+        REQUIRE( innerArchive.detectedFormat() == BitFormat::Auto );
+
+        REQUIRE( innerArchive.itemsCount() == multipleFilesContent().fileCount );
+        REQUIRE( innerArchive.detectedFormat() == BitFormat::Tar );
+        REQUIRE( innerArchive.openCount() == 1 );
+
+        require_extracts_to_filesystem( innerArchive, multipleFilesContent().items );
+        REQUIRE( innerArchive.openCount() == 2 );
     }
 }
 #endif
@@ -343,6 +351,52 @@ TEMPLATE_TEST_CASE(
     }
 }
 
+// NOLINTNEXTLINE(*-err58-cpp)
+TEMPLATE_TEST_CASE(
+    "BitNestedArchiveReader: Adaptive memory usage stays within the given bounds",
+    "[bitnestedarchivereader]",
+    tstring,
+    buffer_t,
+    stream_t
+) {
+    const TestDirectory testDir{ fs::path{ test_archives_dir } / "extraction" / "nested" };
+
+    const auto testArchive = GENERATE(
+        as< TestInputFormat >(),
+        TestInputFormat{ "7z", BitFormat::SevenZip },
+        TestInputFormat{ "gz", BitFormat::GZip },
+        TestInputFormat{ "bz2", BitFormat::BZip2 },
+        TestInputFormat{ "xz", BitFormat::Xz },
+        TestInputFormat{ "zip", BitFormat::Zip }
+    );
+
+    DYNAMIC_SECTION( "Archive format: " << testArchive.extension ) {
+        const fs::path arcFileName = "nested.tar." + testArchive.extension;
+
+        TestType inputArchive{};
+        getInputArchive( arcFileName, inputArchive );
+        const BitArchiveReader outerArchive( test::sevenzipLib(), inputArchive, testArchive.format );
+        BitNestedArchiveReader innerArchive( test::sevenzipLib(), outerArchive, BitFormat::Tar );
+
+        constexpr auto kMinMemoryUsage = 4ULL * 1024 * 1024;
+        constexpr auto kMaxMemoryUsage = 32ULL * 1024 * 1024;
+        innerArchive.setMaxMemoryUsage( 64ULL * 1024 * 1024 );
+        innerArchive.setAdaptiveMemoryUsage( kMinMemoryUsage, kMaxMemoryUsage );
+        REQUIRE( innerArchive.maxMemoryUsage() == kMaxMemoryUsage );
+
+        REQUIRE_NOTHROW( innerArchive.test() );
+        require_extracts_to_filesystem( innerArchive, multipleFilesContent().items );
+
+        const auto metrics = innerArchive.bufferingMetrics();
+        REQUIRE( metrics.memoryLimit >= kMinMemoryUsage );
+        REQUIRE( metrics.memoryLimit <= kMaxMemoryUsage );
+        REQUIRE( metrics.peakMemoryUsage > 0 );
+
+        innerArchive.setMaxMemoryUsage( kMinMemoryUsage );
+        REQUIRE( innerArchive.maxMemoryUsage() == kMinMemoryUsage );
+    }
+}
+
 // NOLINTNEXTLINE(*-err58-cpp)
 TEMPLATE_TEST_CASE(
     "BitNestedArchiveReader: Extracting a deeply-nested archive",
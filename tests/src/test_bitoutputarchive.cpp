@@ -15,16 +15,30 @@
 #include "utils/archive.hpp"
 #include "utils/crc.hpp"
 #include "utils/exception.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/format.hpp"
+#include "utils/random.hpp"
 #include "utils/shared_lib.hpp"
+#include "utils/streams.hpp"
 
 #include <bit7z/biterror.hpp>
 #include <bit7z/bitexception.hpp>
 #include <bit7z/bitformat.hpp>
 #include <bit7z/bitarchivereader.hpp>
 #include <bit7z/bitarchivewriter.hpp>
+#include <bit7z/bitbufferview.hpp>
+#include <bit7z/bitinputsource.hpp>
+#include <bit7z/bitmemextractor.hpp>
+#include <bit7z/bitsegmentedbuffer.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace bit7z;
 using namespace bit7z::test;
@@ -166,6 +180,242 @@ TEST_CASE( "BitOutputArchive: Updating an archive overwrites items with matching
     REQUIRE( extractedItems.count( BIT7Z_STRING( "brand_new.dat" ) ) == 1 );
 }
 
+TEST_CASE( "BitOutputArchive: Synchronizing an archive keeps the unchanged items", "[bitoutputarchive]" ) {
+    const TempTestDirectory testDir{ "test_bitoutputarchive" };
+    INFO( "Test directory: " << testDir )
+
+    const buffer_t originalContent( 64, 0x2A );
+    const buffer_t sameSizeContent( 64, 0x42 );
+    const buffer_t changedContent( 128, 0x42 );
+
+    writeFile( "unchanged.bin", originalContent );
+    writeFile( "changed.bin", originalContent );
+    const std::vector< tstring > inputFiles{ BIT7Z_STRING( "unchanged.bin" ), BIT7Z_STRING( "changed.bin" ) };
+
+    const tstring archivePath = BIT7Z_STRING( "sync.7z" );
+    {
+        BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+        REQUIRE_NOTHROW( writer.addFiles( inputFiles ) );
+        REQUIRE_NOTHROW( writer.compressTo( archivePath ) );
+    }
+
+    // Rewriting a file while preserving its size and modification time makes it look unchanged,
+    // so the archive must keep the old content, proving that the item was not compressed again.
+    const auto unchangedTime = fs::last_write_time( "unchanged.bin" );
+    writeFile( "unchanged.bin", sameSizeContent );
+    fs::last_write_time( "unchanged.bin", unchangedTime );
+    writeFile( "changed.bin", changedContent );
+
+    buffer_t outputBuffer;
+    {
+        BitArchiveWriter writer{ test::sevenzipLib(), archivePath, BitFormat::SevenZip };
+        writer.setUpdateMode( UpdateMode::Sync );
+        REQUIRE_NOTHROW( writer.addFiles( inputFiles ) );
+        REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+    }
+
+    const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, BitFormat::SevenZip };
+    REQUIRE( result.itemsCount() == 2 );
+
+    std::map< tstring, buffer_t > extractedItems;
+    REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+    REQUIRE( extractedItems[ BIT7Z_STRING( "unchanged.bin" ) ] == originalContent );
+    REQUIRE( extractedItems[ BIT7Z_STRING( "changed.bin" ) ] == changedContent );
+}
+
+TEST_CASE( "BitOutputArchive: Appending items to an archive file in place", "[bitoutputarchive]" ) {
+    const TempTestDirectory testDir{ "test_bitoutputarchive" };
+    INFO( "Test directory: " << testDir )
+
+    const auto testFormat = GENERATE(
+        as< TestOutputFormat >(),
+        TestOutputFormat{ "tar", BitFormat::Tar },
+        TestOutputFormat{ "zip", BitFormat::Zip }
+    );
+
+    DYNAMIC_SECTION( "Archive format: " << testFormat.extension ) {
+        const buffer_t oldContent = randomContent( 4096 );
+        const buffer_t newContent( 1024, 0x42 );
+        const tstring archivePath = to_tstring( fs::path{ "append." + testFormat.extension } );
+        {
+            BitArchiveWriter writer{ test::sevenzipLib(), testFormat.format };
+            REQUIRE_NOTHROW( writer.addFile( oldContent, BIT7Z_STRING( "old.bin" ) ) );
+            REQUIRE_NOTHROW( writer.compressTo( archivePath ) );
+        }
+        const auto originalArchive = loadFile( archivePath );
+
+        /* A hard link keeps pointing to the original file if the archive is rewritten
+         * (i.e., written to a temporary file and renamed), so it tells whether the file was modified in place. */
+        const fs::path archiveLink{ "append.link" };
+        fs::create_hard_link( archivePath, archiveLink );
+
+        {
+            BitArchiveWriter writer{ test::sevenzipLib(), archivePath, testFormat.format };
+            REQUIRE_NOTHROW( writer.addFile( newContent, BIT7Z_STRING( "new.bin" ) ) );
+            REQUIRE_NOTHROW( writer.compressTo( archivePath ) );
+        }
+        REQUIRE_FALSE( fs::exists( archivePath + BIT7Z_STRING( ".bit7z-journal" ) ) );
+
+        // The existing item must not have been rewritten: the archive still starts with its original bytes.
+        const auto resultArchive = loadFile( archivePath );
+        const auto keptSize = static_cast< std::ptrdiff_t >( originalArchive.size() / 2 );
+        REQUIRE( resultArchive.size() > originalArchive.size() );
+        REQUIRE( std::equal( originalArchive.cbegin(), originalArchive.cbegin() + keptSize, resultArchive.cbegin() ) );
+        REQUIRE( loadFile( archiveLink ) == resultArchive );
+
+        const BitArchiveReader result{ test::sevenzipLib(), archivePath, testFormat.format };
+        REQUIRE( result.itemsCount() == 2 );
+
+        std::map< tstring, buffer_t > extractedItems;
+        REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+        REQUIRE( extractedItems[ BIT7Z_STRING( "old.bin" ) ] == oldContent );
+        REQUIRE( extractedItems[ BIT7Z_STRING( "new.bin" ) ] == newContent );
+    }
+}
+
+TEST_CASE( "BitOutputArchive: Compressing identical files with deduplication", "[bitoutputarchive]" ) {
+    const TempTestDirectory testDir{ "test_bitoutputarchive" };
+    INFO( "Test directory: " << testDir )
+
+    const buffer_t firstContent( 4096, 0x2A );
+    const buffer_t secondContent( 4096, 0x42 );
+
+    writeFile( "first.bin", firstContent );
+    writeFile( "second.bin", secondContent ); // Same size of first.bin, but different content.
+    writeFile( "first_copy.bin", firstContent );
+    const std::vector< tstring > inputFiles{
+        BIT7Z_STRING( "first.bin" ), BIT7Z_STRING( "second.bin" ), BIT7Z_STRING( "first_copy.bin" )
+    };
+
+    SECTION( "Tar archives store the duplicate files as hard links" ) {
+        BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::Tar };
+        writer.setDeduplicateFiles( true );
+        REQUIRE_NOTHROW( writer.addFiles( inputFiles ) );
+
+        buffer_t outputBuffer;
+        REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+
+        const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, BitFormat::Tar };
+        REQUIRE( result.itemsCount() == 3 );
+
+        const auto copyItem = result.find( BIT7Z_STRING( "first_copy.bin" ) );
+        REQUIRE( copyItem != result.cend() );
+        REQUIRE( copyItem->itemProperty( BitProperty::HardLink ) == BitPropVariant{ L"first.bin" } );
+
+        const auto secondItem = result.find( BIT7Z_STRING( "second.bin" ) );
+        REQUIRE( secondItem != result.cend() );
+        REQUIRE( secondItem->itemProperty( BitProperty::HardLink ).isEmpty() );
+    }
+
+    SECTION( "Other formats store the duplicate files next to each other" ) {
+        BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+        writer.setDeduplicateFiles( true );
+        REQUIRE_NOTHROW( writer.addFiles( inputFiles ) );
+
+        buffer_t outputBuffer;
+        REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+
+        const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, BitFormat::SevenZip };
+        REQUIRE( result.itemsCount() == 3 );
+
+        std::map< tstring, buffer_t > extractedItems;
+        REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+        REQUIRE( extractedItems[ BIT7Z_STRING( "first.bin" ) ] == firstContent );
+        REQUIRE( extractedItems[ BIT7Z_STRING( "second.bin" ) ] == secondContent );
+        REQUIRE( extractedItems[ BIT7Z_STRING( "first_copy.bin" ) ] == firstContent );
+    }
+}
+
+TEST_CASE( "BitOutputArchive: Sorting the new items by type", "[bitoutputarchive]" ) {
+    const buffer_t smallContent( 16, 0x2A );
+    const buffer_t largeContent( 64, 0x2A );
+
+    BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::Tar };
+    writer.setSortStrategy( SortStrategy::ByType );
+    REQUIRE_NOTHROW( writer.addFile( smallContent, BIT7Z_STRING( "b.txt" ) ) );
+    REQUIRE_NOTHROW( writer.addFile( smallContent, BIT7Z_STRING( "folder/a.jpg" ) ) );
+    REQUIRE_NOTHROW( writer.addFile( largeContent, BIT7Z_STRING( "a.TXT" ) ) );
+    REQUIRE_NOTHROW( writer.addFile( smallContent, BIT7Z_STRING( "other/a.txt" ) ) );
+    REQUIRE_NOTHROW( writer.addFile( smallContent, BIT7Z_STRING( "README" ) ) );
+
+    buffer_t outputBuffer;
+    REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+
+    // Note: the tar format stores the items in the same order in which they are passed by bit7z.
+    const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, BitFormat::Tar };
+    std::vector< tstring > itemNames;
+    for ( const auto& item : result ) {
+        itemNames.push_back( item.name() );
+    }
+    const std::vector< tstring > expectedNames{
+        BIT7Z_STRING( "README" ),
+        BIT7Z_STRING( "a.jpg" ),
+        BIT7Z_STRING( "a.txt" ), // "other/a.txt", which is smaller than "a.TXT".
+        BIT7Z_STRING( "a.TXT" ),
+        BIT7Z_STRING( "b.txt" )
+    };
+    REQUIRE( itemNames == expectedNames );
+}
+
+TEST_CASE( "BitOutputArchive: Storing incompressible files without compression", "[bitoutputarchive]" ) {
+    const TempTestDirectory testDir{ "test_bitoutputarchive" };
+    INFO( "Test directory: " << testDir )
+
+    const auto randomData = randomContent( 64 * 1024 );
+    writeFile( "random.bin", randomData );
+    writeFile( "photo.jpg", buffer_t( 1024, static_cast< byte_t >( 0x2A ) ) ); // Judged by its extension only.
+    std::vector< tstring > inputFiles{ BIT7Z_STRING( "random.bin" ), BIT7Z_STRING( "photo.jpg" ) };
+
+    const auto requireIncompressibleItems = []( const BitArchiveWriter& writer, bool stored ) {
+        const auto& items = writer.incompressibleItems();
+        REQUIRE( items.size() == 2 );
+        REQUIRE( items[ 0 ].path == BIT7Z_STRING( "random.bin" ) );
+        REQUIRE( items[ 0 ].reason == IncompressibleReason::HighEntropy );
+        REQUIRE( items[ 0 ].stored == stored );
+        REQUIRE( items[ 1 ].path == BIT7Z_STRING( "photo.jpg" ) );
+        REQUIRE( items[ 1 ].reason == IncompressibleReason::Extension );
+        REQUIRE( items[ 1 ].stored == stored );
+    };
+
+    SECTION( "All the files are incompressible" ) {
+        BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+        writer.setStoreIncompressibleFiles( true );
+        REQUIRE_NOTHROW( writer.addFiles( inputFiles ) );
+
+        buffer_t outputBuffer;
+        REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+        requireIncompressibleItems( writer, true );
+
+        const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, BitFormat::SevenZip };
+        for ( const auto& item : result ) {
+            INFO( "Item: " << item.path() )
+            REQUIRE( item.itemProperty( BitProperty::Method ).getString() == BIT7Z_STRING( "Copy" ) );
+        }
+
+        std::map< tstring, buffer_t > extractedItems;
+        REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+        REQUIRE( extractedItems[ BIT7Z_STRING( "random.bin" ) ] == randomData );
+    }
+
+    SECTION( "Only some files are incompressible" ) {
+        writeFile( "notes.txt", buffer_t( 64 * 1024, static_cast< byte_t >( 0x2A ) ) );
+        inputFiles.emplace_back( BIT7Z_STRING( "notes.txt" ) );
+
+        BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+        writer.setStoreIncompressibleFiles( true );
+        REQUIRE_NOTHROW( writer.addFiles( inputFiles ) );
+
+        buffer_t outputBuffer;
+        REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+        requireIncompressibleItems( writer, false );
+
+        const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, BitFormat::SevenZip };
+        const auto notesItem = result.find( BIT7Z_STRING( "notes.txt" ) );
+        REQUIRE( notesItem != result.cend() );
+        REQUIRE( notesItem->itemProperty( BitProperty::Method ).getString() != BIT7Z_STRING( "Copy" ) );
+    }
+}
+
 TEST_CASE( "BitOutputArchive: Compressing to a path without a filename should throw", "[bitoutputarchive]" ) {
     BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
     REQUIRE_THROWS_CODE(
@@ -233,6 +483,284 @@ TEST_CASE( "BitOutputArchive: Compressing to a non-empty buffer respects the ove
     }
 }
 
+TEST_CASE( "BitOutputArchive: Compressing to a segmented buffer", "[bitoutputarchive]" ) {
+    const auto fileContent = loadFile( fs::path{ test_filesystem_dir } / "folder" / "clouds.jpg" );
+
+    BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+    writer.addFile( fileContent, BIT7Z_STRING( "clouds.jpg" ) );
+    writer.addFile( fileContent, BIT7Z_STRING( "clouds_copy.jpg" ) );
+
+    // Small segments, so that both the archive data and the header patch-ups cross many segments' boundaries.
+    BitSegmentedBuffer outputBuffer{ 4096 };
+    REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+    REQUIRE( outputBuffer.segments().size() > 1 );
+
+    // The archive must be the same we would get by compressing to a contiguous buffer.
+    buffer_t contiguousBuffer;
+    REQUIRE_NOTHROW( writer.compressTo( contiguousBuffer ) );
+    const auto archive = outputBuffer.toBuffer();
+    REQUIRE( archive == contiguousBuffer );
+
+    const BitArchiveReader result{ test::sevenzipLib(), archive, BitFormat::SevenZip };
+    std::map< tstring, buffer_t > extractedItems;
+    REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+    REQUIRE( extractedItems.size() == 2 );
+    REQUIRE( extractedItems[ BIT7Z_STRING( "clouds.jpg" ) ] == fileContent );
+    REQUIRE( extractedItems[ BIT7Z_STRING( "clouds_copy.jpg" ) ] == fileContent );
+
+    // Like buffer_t, a non-empty segmented buffer is not overwritten by default.
+    REQUIRE_THROWS_CODE( writer.compressTo( outputBuffer ), BitError::NonEmptyOutputBuffer );
+
+    writer.setOverwriteMode( OverwriteMode::Overwrite );
+    REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+    REQUIRE( outputBuffer.toBuffer() == contiguousBuffer );
+}
+
+TEST_CASE( "BitOutputArchive: Compressing to a pre-allocated buffer", "[bitoutputarchive]" ) {
+    const auto fileContent = loadFile( fs::path{ test_filesystem_dir } / "folder" / "clouds.jpg" );
+
+    BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+    writer.addFile( fileContent, BIT7Z_STRING( "clouds.jpg" ) );
+
+    buffer_t expectedArchive;
+    REQUIRE_NOTHROW( writer.compressTo( expectedArchive ) );
+
+    SECTION( "Buffer larger than the archive" ) {
+        buffer_t outputBuffer( expectedArchive.size() + 1024 );
+        std::size_t archiveSize = 0;
+        REQUIRE_NOTHROW( archiveSize = writer.compressTo( outputBuffer.data(), outputBuffer.size() ) );
+        REQUIRE( archiveSize == expectedArchive.size() );
+        outputBuffer.resize( archiveSize );
+        REQUIRE( outputBuffer == expectedArchive );
+    }
+
+    SECTION( "Buffer with the exact size of the archive" ) {
+        buffer_t outputBuffer( expectedArchive.size() );
+        REQUIRE( writer.compressTo( outputBuffer.data(), outputBuffer.size() ) == expectedArchive.size() );
+        REQUIRE( outputBuffer == expectedArchive );
+    }
+
+    SECTION( "Buffer smaller than the archive" ) {
+        buffer_t outputBuffer( expectedArchive.size() - 1 );
+        REQUIRE_THROWS_CODE( writer.compressTo( outputBuffer.data(), outputBuffer.size() ),
+                             BitError::InsufficientOutputBufferSize );
+        // The error message reports the size needed by the archive.
+        REQUIRE_THROWS_WITH( writer.compressTo( outputBuffer.data(), outputBuffer.size() ),
+                             Catch::Matchers::Contains( std::to_string( expectedArchive.size() ) ) );
+    }
+
+    SECTION( "Fixed-size array" ) {
+        std::array< byte_t, 512 > outputBuffer{};
+        REQUIRE_THROWS_CODE( writer.compressTo( outputBuffer ), BitError::InsufficientOutputBufferSize );
+    }
+
+    SECTION( "Invalid buffer" ) {
+        REQUIRE_THROWS_CODE( writer.compressTo( nullptr, 1024 ), BitError::NullOutputBuffer );
+
+        byte_t outputByte{};
+        REQUIRE_THROWS_CODE( writer.compressTo( &outputByte, 0 ), BitError::InvalidOutputBufferSize );
+    }
+}
+
+TEST_CASE( "BitOutputArchive: Compressing and reading memory regions not owned by a buffer", "[bitoutputarchive]" ) {
+    const auto fileContent = loadFile( fs::path{ test_filesystem_dir } / "folder" / "clouds.jpg" );
+    const std::string textContent = "Lorem ipsum dolor sit amet, consectetur adipiscing elit.";
+
+    BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+    writer.addFile( BitBufferView{ fileContent.data(), fileContent.size() / 2 }, BIT7Z_STRING( "clouds_half.jpg" ) );
+    writer.addFile( BitBufferView{ reinterpret_cast< const byte_t* >( textContent.data() ), textContent.size() },
+                    BIT7Z_STRING( "lorem.txt" ) );
+
+    buffer_t outputBuffer;
+    REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+
+    // Moving the archive into a std::string, which is then read without being copied back into a buffer_t.
+    const std::string archive( outputBuffer.cbegin(), outputBuffer.cend() );
+    const BitBufferView archiveView{ reinterpret_cast< const byte_t* >( archive.data() ), archive.size() };
+    const BitArchiveReader result{ test::sevenzipLib(), archiveView, BitFormat::SevenZip };
+    REQUIRE( result.itemsCount() == 2 );
+
+    std::map< tstring, buffer_t > extractedItems;
+    REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+    const auto halfSize = static_cast< std::ptrdiff_t >( fileContent.size() / 2 );
+    REQUIRE( extractedItems[ BIT7Z_STRING( "clouds_half.jpg" ) ] ==
+             buffer_t( fileContent.cbegin(), fileContent.cbegin() + halfSize ) );
+    REQUIRE( extractedItems[ BIT7Z_STRING( "lorem.txt" ) ] == buffer_t( textContent.cbegin(), textContent.cend() ) );
+
+    const BitMemExtractor extractor{ test::sevenzipLib(), BitFormat::SevenZip };
+    const auto textItem = result.find( BIT7Z_STRING( "lorem.txt" ) );
+    REQUIRE( textItem != result.cend() );
+    buffer_t extractedText;
+    REQUIRE_NOTHROW( extractor.extract( archiveView, extractedText, textItem->index() ) );
+    REQUIRE( extractedText == buffer_t( textContent.cbegin(), textContent.cend() ) );
+}
+
+TEST_CASE( "BitOutputArchive: Compressing to a non-seekable stream", "[bitoutputarchive]" ) {
+    const auto fileContent = loadFile( fs::path{ test_filesystem_dir } / "folder" / "clouds.jpg" );
+    const buffer_t textContent( 1000, static_cast< byte_t >( 'a' ) );
+
+    buffer_t outputBuffer;
+    NonSeekableOutputBuffer outputStreamBuffer{ outputBuffer };
+    std::ostream outputStream{ &outputStreamBuffer };
+    REQUIRE( outputStream.tellp() == std::ostream::pos_type{ -1 } );
+
+    SECTION( "Formats supporting sequential output" ) {
+        const auto testFormat = GENERATE( as< TestOutputFormat >(),
+                                          TestOutputFormat{ "tar", BitFormat::Tar },
+                                          TestOutputFormat{ "gz", BitFormat::GZip },
+                                          TestOutputFormat{ "bz2", BitFormat::BZip2 },
+                                          TestOutputFormat{ "xz", BitFormat::Xz } );
+        INFO( "Format: " << testFormat.extension )
+        REQUIRE( testFormat.format.hasFeature( FormatFeatures::SequentialOutput ) );
+
+        const bool multipleFiles = testFormat.format.hasFeature( FormatFeatures::MultipleFiles );
+        BitArchiveWriter writer{ test::sevenzipLib(), testFormat.format };
+        writer.addFile( fileContent, BIT7Z_STRING( "clouds.jpg" ) );
+        if ( multipleFiles ) {
+            writer.addFile( textContent, BIT7Z_STRING( "text.txt" ) );
+        }
+        REQUIRE_NOTHROW( writer.compressTo( outputStream ) );
+        REQUIRE_FALSE( outputBuffer.empty() );
+
+        const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, testFormat.format };
+        std::map< tstring, buffer_t > extractedItems;
+        REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+        REQUIRE( extractedItems.size() == ( multipleFiles ? 2u : 1u ) );
+        if ( multipleFiles ) {
+            REQUIRE( extractedItems[ BIT7Z_STRING( "clouds.jpg" ) ] == fileContent );
+            REQUIRE( extractedItems[ BIT7Z_STRING( "text.txt" ) ] == textContent );
+        } else {
+            REQUIRE( extractedItems.cbegin()->second == fileContent );
+        }
+    }
+
+    SECTION( "Formats not supporting sequential output" ) {
+        REQUIRE_FALSE( BitFormat::SevenZip.hasFeature( FormatFeatures::SequentialOutput ) );
+
+        BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+        writer.addFile( fileContent, BIT7Z_STRING( "clouds.jpg" ) );
+        REQUIRE_THROWS_CODE( writer.compressTo( outputStream ), BitError::FormatFeatureNotSupported );
+        REQUIRE( outputBuffer.empty() );
+    }
+}
+
+TEST_CASE( "BitOutputArchive: Forcing the sequential output on a seekable stream", "[bitoutputarchive]" ) {
+    const auto fileContent = loadFile( fs::path{ test_filesystem_dir } / "folder" / "clouds.jpg" );
+
+    std::ostringstream outputStream;
+    SECTION( "Format supporting sequential output" ) {
+        BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::Tar };
+        writer.setSequentialOutput( true );
+        writer.addFile( fileContent, BIT7Z_STRING( "clouds.jpg" ) );
+        REQUIRE_NOTHROW( writer.compressTo( outputStream ) );
+
+        const auto archiveString = outputStream.str();
+        const buffer_t archive( archiveString.cbegin(), archiveString.cend() );
+        const BitArchiveReader result{ test::sevenzipLib(), archive, BitFormat::Tar };
+        std::map< tstring, buffer_t > extractedItems;
+        REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+        REQUIRE( extractedItems[ BIT7Z_STRING( "clouds.jpg" ) ] == fileContent );
+    }
+
+    SECTION( "Format not supporting sequential output" ) {
+        BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+        writer.setSequentialOutput( true );
+        writer.addFile( fileContent, BIT7Z_STRING( "clouds.jpg" ) );
+        REQUIRE_THROWS_CODE( writer.compressTo( outputStream ), BitError::FormatFeatureNotSupported );
+
+        // Without forcing it, the archive is written to the seekable stream as usual.
+        writer.setSequentialOutput( false );
+        REQUIRE_NOTHROW( writer.compressTo( outputStream ) );
+        REQUIRE_FALSE( outputStream.str().empty() );
+    }
+}
+
+TEST_CASE( "BitOutputArchive: Compressing a non-seekable input stream of unknown size", "[bitoutputarchive]" ) {
+    const auto fileContent = loadFile( fs::path{ test_filesystem_dir } / "folder" / "clouds.jpg" );
+
+    const auto testFormat = GENERATE( as< TestOutputFormat >(),
+                                      TestOutputFormat{ "7z", BitFormat::SevenZip },
+                                      TestOutputFormat{ "gz", BitFormat::GZip } );
+    INFO( "Format: " << testFormat.extension )
+    const auto& format = testFormat.format;
+
+    test::NonSeekableInputBuffer inputBuffer{ fileContent };
+    std::istream inputStream{ &inputBuffer };
+
+    BitArchiveWriter writer{ test::sevenzipLib(), format };
+    const auto& item = writer.addFile( inputStream, BIT7Z_STRING( "clouds.jpg" ) );
+    REQUIRE_FALSE( item.hasKnownSize() );
+
+    buffer_t outputBuffer;
+    REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+
+    // The archive stores the actual size of the data read from the stream.
+    const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, format };
+    REQUIRE( result.itemsCount() == 1 );
+    std::map< tstring, buffer_t > extractedItems;
+    REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+    REQUIRE( extractedItems.size() == 1 );
+    REQUIRE( extractedItems.cbegin()->second == fileContent );
+    if ( format == BitFormat::SevenZip ) {
+        REQUIRE( result.items()[ 0 ].size() == fileContent.size() );
+    }
+}
+
+namespace {
+// Input source producing the same buffer under different names, counting how many items it produced.
+class RepeatedBufferSource final : public BitInputSource {
+    public:
+        RepeatedBufferSource( const buffer_t& buffer, std::uint32_t count ) : mBuffer{ buffer }, mCount{ count } {}
+
+        auto itemsCount() const -> std::uint32_t override {
+            return mCount;
+        }
+
+        auto item( std::uint32_t index ) const -> BitInputItem override {
+            ++mProducedItems;
+            return BitInputItem{ mBuffer, BIT7Z_STRING( "item" ) + to_tstring( index ) + BIT7Z_STRING( ".dat" ) };
+        }
+
+        auto producedItems() const -> std::uint32_t {
+            return mProducedItems;
+        }
+
+    private:
+        const buffer_t& mBuffer;
+        std::uint32_t mCount;
+        mutable std::uint32_t mProducedItems{ 0 };
+};
+} // namespace
+
+TEST_CASE( "BitOutputArchive: Compressing the items produced by an input source", "[bitoutputarchive]" ) {
+    const auto fileContent = loadFile( fs::path{ test_filesystem_dir } / "folder" / "clouds.jpg" );
+    constexpr std::uint32_t kSourceItemsCount = 16;
+    const RepeatedBufferSource inputSource{ fileContent, kSourceItemsCount };
+
+    BitArchiveWriter writer{ test::sevenzipLib(), BitFormat::SevenZip };
+    REQUIRE_NOTHROW( writer.addFile( fileContent, BIT7Z_STRING( "clouds.jpg" ) ) );
+    REQUIRE_NOTHROW( writer.addItems( inputSource ) );
+    REQUIRE( writer.itemsCount() == kSourceItemsCount + 1 );
+    // The items are produced only during the compression.
+    REQUIRE( inputSource.producedItems() == 0 );
+
+    buffer_t outputBuffer;
+    REQUIRE_NOTHROW( writer.compressTo( outputBuffer ) );
+    REQUIRE( inputSource.producedItems() >= kSourceItemsCount );
+
+    const BitArchiveReader result{ test::sevenzipLib(), outputBuffer, BitFormat::SevenZip };
+    REQUIRE( result.itemsCount() == kSourceItemsCount + 1 );
+
+    std::map< tstring, buffer_t > extractedItems;
+    REQUIRE_NOTHROW( result.extractTo( extractedItems ) );
+    REQUIRE( extractedItems[ BIT7Z_STRING( "clouds.jpg" ) ] == fileContent );
+    for ( std::uint32_t index = 0; index < kSourceItemsCount; ++index ) {
+        const auto itemName = BIT7Z_STRING( "item" ) + to_tstring( index ) + BIT7Z_STRING( ".dat" );
+        INFO( "Item: " << itemName )
+        REQUIRE( extractedItems[ itemName ] == fileContent );
+    }
+}
+
 #ifdef _WIN32
 // NOLINTNEXTLINE(*-err58-cpp)
 TEST_CASE( "BitOutputArchive: Compressing a commented file should preserve the comment", "[bitoutputarchive]" ) {
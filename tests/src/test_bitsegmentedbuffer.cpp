@@ -0,0 +1,114 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/exception.hpp"
+
+#include <bit7z/biterror.hpp>
+#include <bit7z/bitsegmentedbuffer.hpp>
+#include <bit7z/bittypes.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+using namespace bit7z;
+
+namespace {
+auto sequentialContent( std::size_t size, int seed ) -> buffer_t {
+    buffer_t result( size );
+    for ( std::size_t index = 0; index < size; ++index ) {
+        result[ index ] = static_cast< byte_t >( ( index * 7 + static_cast< std::size_t >( seed ) ) % 256 );
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE( "BitSegmentedBuffer: Creating an empty buffer", "[bitsegmentedbuffer]" ) {
+    const BitSegmentedBuffer buffer{ 16 };
+    REQUIRE( buffer.segmentSize() == 16 );
+    REQUIRE( buffer.size() == 0 );
+    REQUIRE( buffer.empty() );
+    REQUIRE( buffer.segments().empty() );
+    REQUIRE( buffer.toBuffer().empty() );
+
+    REQUIRE_THROWS_CODE( BitSegmentedBuffer{ 0 }, BitError::InvalidOutputBufferSize );
+}
+
+TEST_CASE( "BitSegmentedBuffer: Writing and reading data across segments", "[bitsegmentedbuffer]" ) {
+    BitSegmentedBuffer buffer{ 16 };
+
+    const auto content = sequentialContent( 100, 1 );
+    buffer.write( 0, content.data(), content.size() );
+    REQUIRE( buffer.size() == content.size() );
+    REQUIRE( buffer.toBuffer() == content );
+
+    // Overwriting a range crossing the segments' boundaries.
+    auto expectedContent = content;
+    const auto patch = sequentialContent( 40, 3 );
+    buffer.write( 10, patch.data(), patch.size() );
+    std::copy( patch.cbegin(), patch.cend(), expectedContent.begin() + 10 );
+    REQUIRE( buffer.size() == content.size() );
+    REQUIRE( buffer.toBuffer() == expectedContent );
+
+    buffer_t readData( 30 );
+    REQUIRE( buffer.read( 5, readData.data(), readData.size() ) == readData.size() );
+    REQUIRE( std::equal( readData.cbegin(), readData.cend(), expectedContent.cbegin() + 5 ) );
+
+    // Reading past the end.
+    REQUIRE( buffer.read( 90, readData.data(), readData.size() ) == 10 );
+    REQUIRE( std::equal( readData.cbegin(), readData.cbegin() + 10, expectedContent.cbegin() + 90 ) );
+    REQUIRE( buffer.read( 100, readData.data(), readData.size() ) == 0 );
+
+    const auto segments = buffer.segments();
+    REQUIRE( segments.size() == 7 );
+    buffer_t gatheredContent;
+    for ( const auto& segment : segments ) {
+        REQUIRE( segment.size == ( gatheredContent.size() < 96 ? 16 : 4 ) );
+        gatheredContent.insert( gatheredContent.end(), segment.data, segment.data + segment.size );
+    }
+    REQUIRE( gatheredContent == expectedContent );
+
+    buffer.clear();
+    REQUIRE( buffer.empty() );
+    REQUIRE( buffer.segments().empty() );
+}
+
+TEST_CASE( "BitSegmentedBuffer: Resizing the buffer", "[bitsegmentedbuffer]" ) {
+    BitSegmentedBuffer buffer{ 16 };
+
+    const auto content = sequentialContent( 40, 5 );
+    buffer.write( 0, content.data(), content.size() );
+
+    buffer.resize( 20 );
+    REQUIRE( buffer.size() == 20 );
+    REQUIRE( buffer.segments().size() == 2 );
+    REQUIRE( buffer.toBuffer() == buffer_t( content.cbegin(), content.cbegin() + 20 ) );
+
+    // Growing the buffer again must not expose the bytes previously stored past the new size.
+    buffer.resize( 40 );
+    auto expectedContent = buffer_t( content.cbegin(), content.cbegin() + 20 );
+    expectedContent.resize( 40 );
+    REQUIRE( buffer.toBuffer() == expectedContent );
+
+    // Writing past the end fills the gap with zeros.
+    const auto tail = sequentialContent( 10, 9 );
+    buffer.write( 50, tail.data(), tail.size() );
+    expectedContent.resize( 50 );
+    expectedContent.insert( expectedContent.end(), tail.cbegin(), tail.cend() );
+    REQUIRE( buffer.size() == 60 );
+    REQUIRE( buffer.toBuffer() == expectedContent );
+
+    buffer.resize( 0 );
+    REQUIRE( buffer.empty() );
+    REQUIRE( buffer.segments().empty() );
+}
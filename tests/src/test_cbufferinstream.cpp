@@ -12,12 +12,14 @@
 
 #include <catch2/catch.hpp>
 
+#include <bit7z/bitbufferview.hpp>
 #include <bit7z/bitwindows.hpp>
 #include <bit7z/bittypes.hpp>
 #include <internal/cbufferinstream.hpp>
 
 #include <cstring>
 #include <limits>
+#include <string>
 
 using bit7z::byte_t;
 using bit7z::buffer_t;
@@ -363,3 +365,25 @@ TEST_CASE( "CBufferInStream: Reading a buffer stream", "[cbufferinstream][readin
         REQUIRE( result == static_cast< byte_t >( 'A' ) ); // And hence, the result value was not changed.
     }
 }
+
+TEST_CASE( "CBufferInStream: Reading a view of a memory region", "[cbufferinstream][reading]" ) {
+    const std::string content = "Hello World!";
+    // Viewing only the "World" part of the string, without copying it into a buffer_t.
+    const bit7z::BitBufferView view{ reinterpret_cast< const byte_t* >( content.data() ) + 6, 5 };
+    CBufferInStream inStream{ view };
+
+    buffer_t result( content.size(), static_cast< byte_t >( 0 ) );
+    UInt32 processedSize{ 0 };
+    REQUIRE( inStream.Read( &result[ 0 ], static_cast< UInt32 >( result.size() ), &processedSize ) == S_OK );
+    REQUIRE( processedSize == 5 );
+    REQUIRE( std::memcmp( result.data(), "World", 5 ) == 0 );
+
+    UInt64 newPosition{ 0 };
+    REQUIRE( inStream.Seek( -2, STREAM_SEEK_END, &newPosition ) == S_OK );
+    REQUIRE( newPosition == 3 );
+    REQUIRE( inStream.Read( &result[ 0 ], 1, &processedSize ) == S_OK );
+    REQUIRE( processedSize == 1 );
+    REQUIRE( result[ 0 ] == static_cast< byte_t >( 'l' ) );
+
+    REQUIRE( inStream.Seek( 6, STREAM_SEEK_SET, &newPosition ) == E_INVALIDARG );
+}
@@ -0,0 +1,109 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+#include "utils/random.hpp"
+
+#include <bit7z/bittypes.hpp>
+#include <internal/cfileinstream.hpp>
+#include <internal/windows.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+using namespace bit7z;
+using namespace bit7z::test;
+using namespace bit7z::test::filesystem;
+
+namespace {
+constexpr std::size_t kFileSize = 10000;
+} // namespace
+
+TEST_CASE( "CFileInStream: Reading and seeking a file stream", "[cfileinstream]" ) {
+    const TempTestDirectory testDir{ "test_cfileinstream" };
+    INFO( "Test directory: " << testDir )
+
+    const auto content = randomContent( kFileSize );
+    writeFile( "content.bin", content );
+
+    const std::uint32_t bufferSize = GENERATE( 0u, 1u, 7u, 512u, 4096u, 65536u );
+    DYNAMIC_SECTION( "Read buffer size: " << bufferSize ) {
+        CFileInStream inStream{ BIT7Z_NATIVE_STRING( "content.bin" ), false, bufferSize };
+
+        // Random sequence of reads and short seeks, like the ones made while parsing archive headers.
+        std::mt19937 generator{ 1234 }; // NOLINT(*-msc51-cpp)
+        std::uniform_int_distribution< std::uint32_t > readSizes{ 0, 1500 };
+        std::uniform_int_distribution< std::int64_t > seekOffsets{ -2000, 2000 };
+
+        std::uint64_t expectedPosition = 0;
+        buffer_t readBuffer;
+        for ( int operation = 0; operation < 500; ++operation ) {
+            INFO( "Operation: " << operation << ", position: " << expectedPosition )
+            if ( operation % 3 == 2 ) {
+                const auto targetPosition = static_cast< std::int64_t >( expectedPosition ) + seekOffsets( generator );
+                const auto clampedPosition = std::max< std::int64_t >( targetPosition, 0 );
+                UInt64 newPosition = 0;
+                REQUIRE( inStream.Seek( clampedPosition, STREAM_SEEK_SET, &newPosition ) == S_OK );
+                expectedPosition = static_cast< std::uint64_t >( clampedPosition );
+                REQUIRE( newPosition == expectedPosition );
+                continue;
+            }
+
+            const auto readSize = readSizes( generator );
+            readBuffer.assign( readSize, 0 );
+            UInt32 processedSize = 0;
+            REQUIRE( inStream.Read( readBuffer.data(), readSize, &processedSize ) == S_OK );
+
+            const auto expectedSize = expectedPosition >= kFileSize
+                ? 0
+                : std::min< std::uint64_t >( readSize, kFileSize - expectedPosition );
+            REQUIRE( processedSize == expectedSize );
+            REQUIRE( std::equal( readBuffer.cbegin(),
+                                 readBuffer.cbegin() + processedSize,
+                                 content.cbegin() + static_cast< std::ptrdiff_t >( expectedPosition ) ) );
+            expectedPosition += processedSize;
+        }
+    }
+}
+
+TEST_CASE( "CFileInStream: Seeking a buffered file stream", "[cfileinstream]" ) {
+    const TempTestDirectory testDir{ "test_cfileinstream" };
+    INFO( "Test directory: " << testDir )
+
+    writeFile( "content.bin", randomContent( kFileSize ) );
+    CFileInStream inStream{ BIT7Z_NATIVE_STRING( "content.bin" ), false, 4096 };
+
+    UInt64 newPosition = 0;
+    REQUIRE( inStream.Seek( 0, 3, &newPosition ) == STG_E_INVALIDFUNCTION );
+    REQUIRE( inStream.Seek( -1, STREAM_SEEK_SET, &newPosition ) == HRESULT_WIN32_ERROR_NEGATIVE_SEEK );
+
+    REQUIRE( inStream.Seek( -10, STREAM_SEEK_END, &newPosition ) == S_OK );
+    REQUIRE( newPosition == kFileSize - 10 );
+
+    REQUIRE( inStream.Seek( 4, STREAM_SEEK_CUR, &newPosition ) == S_OK );
+    REQUIRE( newPosition == kFileSize - 6 );
+
+    REQUIRE( inStream.Seek( -static_cast< std::int64_t >( kFileSize ), STREAM_SEEK_CUR, &newPosition )
+             == HRESULT_WIN32_ERROR_NEGATIVE_SEEK );
+
+    // Seeking past the end of the file is allowed, and reading from there gives no data.
+    REQUIRE( inStream.Seek( 100, STREAM_SEEK_END, &newPosition ) == S_OK );
+    REQUIRE( newPosition == kFileSize + 100 );
+
+    byte_t data = 0;
+    UInt32 processedSize = 1;
+    REQUIRE( inStream.Read( &data, 1, &processedSize ) == S_OK );
+    REQUIRE( processedSize == 0 );
+}
@@ -0,0 +1,105 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+
+#include <bit7z/bittypes.hpp>
+#include <internal/cfileoutstream.hpp>
+#include <internal/windows.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+using namespace bit7z;
+using namespace bit7z::test::filesystem;
+
+TEST_CASE( "CFileOutStream: Writing and seeking a file stream", "[cfileoutstream]" ) {
+    const TempTestDirectory testDir{ "test_cfileoutstream" };
+    INFO( "Test directory: " << testDir )
+
+    const std::uint32_t bufferSize = GENERATE( 0u, 1u, 7u, 512u, 4096u );
+    DYNAMIC_SECTION( "Write buffer size: " << bufferSize ) {
+        const fs::path filePath = "output_" + std::to_string( bufferSize ) + ".bin";
+
+        // The expected content of the file, updated with the same writes done on the stream.
+        buffer_t expectedContent;
+        {
+            CFileOutStream outStream{ filePath, FileFlag::CreateNew, bufferSize };
+
+            // Random sequence of writes and short seeks back, like the ones made for patching the archive headers.
+            std::mt19937 generator{ 1234 }; // NOLINT(*-msc51-cpp)
+            std::uniform_int_distribution< std::uint32_t > writeSizes{ 1, 1500 };
+            std::uniform_int_distribution< std::uint64_t > seekBacks{ 0, 2000 };
+            std::uniform_int_distribution< int > bytes{ 0, 255 };
+
+            std::uint64_t position = 0;
+            buffer_t data;
+            for ( int operation = 0; operation < 500; ++operation ) {
+                INFO( "Operation: " << operation << ", position: " << position )
+                if ( operation % 4 == 3 ) {
+                    position -= std::min( position, seekBacks( generator ) );
+                    UInt64 newPosition = 0;
+                    const auto offset = static_cast< Int64 >( position );
+                    REQUIRE( outStream.Seek( offset, STREAM_SEEK_SET, &newPosition ) == S_OK );
+                    REQUIRE( newPosition == position );
+                    continue;
+                }
+
+                data.resize( writeSizes( generator ) );
+                for ( auto& byte : data ) {
+                    byte = static_cast< byte_t >( bytes( generator ) );
+                }
+                UInt32 processedSize = 0;
+                const auto writeSize = static_cast< UInt32 >( data.size() );
+                REQUIRE( outStream.Write( data.data(), writeSize, &processedSize ) == S_OK );
+                REQUIRE( processedSize == data.size() );
+
+                const auto endPosition = static_cast< std::size_t >( position ) + data.size();
+                if ( endPosition > expectedContent.size() ) {
+                    expectedContent.resize( endPosition );
+                }
+                std::copy( data.cbegin(),
+                           data.cend(),
+                           expectedContent.begin() + static_cast< std::ptrdiff_t >( position ) );
+                position = endPosition;
+            }
+
+            UInt64 endPosition = 0;
+            REQUIRE( outStream.Seek( 0, STREAM_SEEK_END, &endPosition ) == S_OK );
+            REQUIRE( endPosition == expectedContent.size() );
+
+            REQUIRE( outStream.SetSize( expectedContent.size() - 100 ) == S_OK );
+            expectedContent.resize( expectedContent.size() - 100 );
+
+            REQUIRE( outStream.flush() == S_OK );
+        }
+        REQUIRE( loadFile( filePath ) == expectedContent );
+    }
+}
+
+TEST_CASE( "CFileOutStream: Buffered data is written when the stream is destroyed", "[cfileoutstream]" ) {
+    const TempTestDirectory testDir{ "test_cfileoutstream" };
+    INFO( "Test directory: " << testDir )
+
+    const buffer_t content( 100, static_cast< byte_t >( 0x2A ) );
+    {
+        CFileOutStream outStream{ fs::path{ "output.bin" }, FileFlag::CreateNew, 4096 };
+        UInt32 processedSize = 0;
+        REQUIRE( outStream.Write( content.data(), static_cast< UInt32 >( content.size() ), &processedSize ) == S_OK );
+        REQUIRE( processedSize == content.size() );
+        REQUIRE( fs::file_size( "output.bin" ) == 0 );
+    }
+    REQUIRE( loadFile( "output.bin" ) == content );
+}
@@ -0,0 +1,94 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+
+#include <bit7z/bitexception.hpp>
+#include <bit7z/bittypes.hpp>
+#include <internal/cmappedfileinstream.hpp>
+#include <internal/windows.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace bit7z;
+using namespace bit7z::test::filesystem;
+
+TEST_CASE( "CMappedFileInStream: Reading and seeking a memory-mapped file", "[cmappedfileinstream]" ) {
+    const TempTestDirectory testDir{ "test_cmappedfileinstream" };
+    INFO( "Test directory: " << testDir )
+
+    buffer_t content( 3 * 1024 * 1024 );
+    for ( std::size_t index = 0; index < content.size(); ++index ) {
+        content[ index ] = static_cast< byte_t >( ( index * 31 ) % 251 );
+    }
+    writeFile( "content.bin", content );
+
+    CMappedFileInStream inStream{ BIT7Z_NATIVE_STRING( "content.bin" ) };
+
+    buffer_t readBuffer( 64 * 1024 );
+    UInt32 processedSize = 0;
+
+    // Reading the whole file sequentially.
+    std::size_t position = 0;
+    while ( position < content.size() ) {
+        REQUIRE( inStream.Read( readBuffer.data(), 64 * 1024, &processedSize ) == S_OK );
+        REQUIRE( processedSize == 64 * 1024 );
+        REQUIRE( std::equal( readBuffer.cbegin(),
+                             readBuffer.cend(),
+                             content.cbegin() + static_cast< std::ptrdiff_t >( position ) ) );
+        position += processedSize;
+    }
+    REQUIRE( inStream.Read( readBuffer.data(), 1, &processedSize ) == S_OK );
+    REQUIRE( processedSize == 0 );
+
+    UInt64 newPosition = 0;
+    REQUIRE( inStream.Seek( -10, STREAM_SEEK_END, &newPosition ) == S_OK );
+    REQUIRE( newPosition == content.size() - 10 );
+    REQUIRE( inStream.Read( readBuffer.data(), 100, &processedSize ) == S_OK );
+    REQUIRE( processedSize == 10 );
+    REQUIRE( std::equal( readBuffer.cbegin(), readBuffer.cbegin() + 10, content.cend() - 10 ) );
+
+    REQUIRE( inStream.Seek( 42, STREAM_SEEK_SET, &newPosition ) == S_OK );
+    REQUIRE( inStream.Seek( -2, STREAM_SEEK_CUR, &newPosition ) == S_OK );
+    REQUIRE( newPosition == 40 );
+    REQUIRE( inStream.Read( readBuffer.data(), 5, &processedSize ) == S_OK );
+    REQUIRE( processedSize == 5 );
+    REQUIRE( std::equal( readBuffer.cbegin(), readBuffer.cbegin() + 5, content.cbegin() + 40 ) );
+
+    REQUIRE( inStream.Seek( -1, STREAM_SEEK_SET, &newPosition ) == HRESULT_WIN32_ERROR_NEGATIVE_SEEK );
+    REQUIRE( inStream.Seek( 0, 3, &newPosition ) == STG_E_INVALIDFUNCTION );
+}
+
+TEST_CASE( "CMappedFileInStream: Reading an empty memory-mapped file", "[cmappedfileinstream]" ) {
+    const TempTestDirectory testDir{ "test_cmappedfileinstream" };
+    INFO( "Test directory: " << testDir )
+
+    writeFile( "empty.bin", {} );
+
+    CMappedFileInStream inStream{ BIT7Z_NATIVE_STRING( "empty.bin" ) };
+
+    byte_t data = 0;
+    UInt32 processedSize = 1;
+    REQUIRE( inStream.Read( &data, 1, &processedSize ) == S_OK );
+    REQUIRE( processedSize == 0 );
+
+    UInt64 newPosition = 1;
+    REQUIRE( inStream.Seek( 0, STREAM_SEEK_END, &newPosition ) == S_OK );
+    REQUIRE( newPosition == 0 );
+}
+
+TEST_CASE( "CMappedFileInStream: Mapping a non-existing file", "[cmappedfileinstream]" ) {
+    REQUIRE_THROWS_AS( CMappedFileInStream{ BIT7Z_NATIVE_STRING( "non_existing.bin" ) }, BitException );
+}
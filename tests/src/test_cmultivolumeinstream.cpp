@@ -0,0 +1,83 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+
+#include <bit7z/bittypes.hpp>
+#include <internal/cmultivolumeinstream.hpp>
+#include <internal/windows.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+
+using namespace bit7z;
+using namespace bit7z::test::filesystem;
+
+TEST_CASE( "CMultiVolumeInStream: Reading and seeking the volumes of a split file", "[cmultivolumeinstream]" ) {
+    const TempTestDirectory testDir{ "test_cmultivolumeinstream" };
+    INFO( "Test directory: " << testDir )
+
+    // Volumes both smaller and bigger than the distance from the end at which the next volume is prefetched.
+    const std::array< std::size_t, 5 > volumeSizes{ 5000, 70000, 5 * 1024 * 1024, 1, 300000 };
+    std::mt19937 generator{ 1234 }; // NOLINT(*-msc51-cpp)
+    std::uniform_int_distribution< int > bytes{ 0, 255 };
+    buffer_t content;
+    for ( std::size_t volumeIndex = 0; volumeIndex < volumeSizes.size(); ++volumeIndex ) {
+        buffer_t volumeContent( volumeSizes[ volumeIndex ] );
+        for ( auto& byte : volumeContent ) {
+            byte = static_cast< byte_t >( bytes( generator ) );
+        }
+        writeFile( "split.bin.00" + std::to_string( volumeIndex + 1 ), volumeContent );
+        content.insert( content.end(), volumeContent.cbegin(), volumeContent.cend() );
+    }
+    // Files that are not volumes of the split file (the .007 file is not contiguous to the other volumes).
+    writeFile( "split.bin.007", buffer_t( 10, 0 ) );
+    writeFile( "other.bin.002", buffer_t( 10, 0 ) );
+
+    const bool useMemoryMapping = GENERATE( false, true );
+    const std::uint32_t readSize = GENERATE( 1000u, 65536u, 1024u * 1024u );
+    DYNAMIC_SECTION( "Memory mapping: " << useMemoryMapping << ", read size: " << readSize ) {
+        CMultiVolumeInStream inStream{ fs::path{ "split.bin.001" }, useMemoryMapping };
+
+        UInt64 endPosition = 0;
+        REQUIRE( inStream.Seek( 0, STREAM_SEEK_END, &endPosition ) == S_OK );
+        REQUIRE( endPosition == content.size() );
+        REQUIRE( inStream.Seek( 0, STREAM_SEEK_SET, nullptr ) == S_OK );
+
+        // Reading the whole file sequentially.
+        buffer_t readContent;
+        buffer_t readBuffer( readSize );
+        UInt32 processedSize = 0;
+        do {
+            REQUIRE( inStream.Read( readBuffer.data(), readSize, &processedSize ) == S_OK );
+            readContent.insert( readContent.end(), readBuffer.cbegin(), readBuffer.cbegin() + processedSize );
+        } while ( processedSize > 0 );
+        REQUIRE( readContent == content );
+
+        // Reading from random positions.
+        std::uniform_int_distribution< std::size_t > positions{ 0, content.size() - 1 };
+        for ( int readIndex = 0; readIndex < 100; ++readIndex ) {
+            const auto position = positions( generator );
+            INFO( "Position: " << position )
+            REQUIRE( inStream.Seek( static_cast< Int64 >( position ), STREAM_SEEK_SET, nullptr ) == S_OK );
+            REQUIRE( inStream.Read( readBuffer.data(), readSize, &processedSize ) == S_OK );
+            REQUIRE( processedSize > 0 );
+            REQUIRE( std::equal( readBuffer.cbegin(),
+                                 readBuffer.cbegin() + processedSize,
+                                 content.cbegin() + static_cast< std::ptrdiff_t >( position ) ) );
+        }
+    }
+}
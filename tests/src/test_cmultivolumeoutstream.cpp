@@ -0,0 +1,107 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+#include "utils/volumehandles.hpp"
+
+#include <bit7z/bittypes.hpp>
+#include <internal/cmultivolumeoutstream.hpp>
+#include <internal/windows.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+using namespace bit7z;
+using namespace bit7z::test;
+using namespace bit7z::test::filesystem;
+
+TEST_CASE( "CMultiVolumeOutStream: Writing the volumes of a split file", "[cmultivolumeoutstream]" ) {
+    const TempTestDirectory testDir{ "test_cmultivolumeoutstream" };
+    INFO( "Test directory: " << testDir )
+
+    constexpr std::uint64_t kVolumeSize = 65536;
+    constexpr std::size_t kContentSize = 300000; // The last volume is not complete.
+
+    std::mt19937 generator{ 1234 }; // NOLINT(*-msc51-cpp)
+    std::uniform_int_distribution< int > bytes{ 0, 255 };
+    buffer_t content( kContentSize );
+    for ( auto& byte : content ) {
+        byte = static_cast< byte_t >( bytes( generator ) );
+    }
+
+    // With the minimum budget of open handles, the volumes are continuously evicted and reopened.
+    const std::size_t maxVolumeHandles = GENERATE( 0u, 3u );
+    DYNAMIC_SECTION( "Max volume handles: " << maxVolumeHandles ) {
+        {
+            const MaxVolumeHandlesGuard guard{ maxVolumeHandles };
+            CMultiVolumeOutStream outStream{ kVolumeSize, fs::path{ "split.bin" } };
+
+            // Writing the content sequentially, with the header (i.e., the first bytes) written at the end.
+            constexpr std::size_t kHeaderSize = 32;
+            constexpr UInt32 kWriteSize = 10000;
+            REQUIRE( outStream.Seek( kHeaderSize, STREAM_SEEK_SET, nullptr ) == S_OK );
+            for ( std::size_t position = kHeaderSize; position < content.size(); ) {
+                const auto remainingSize = static_cast< UInt32 >( content.size() - position );
+                const auto writeSize = std::min( kWriteSize, remainingSize );
+                UInt32 processedSize = 0;
+                REQUIRE( outStream.Write( &content[ position ], writeSize, &processedSize ) == S_OK );
+                REQUIRE( processedSize > 0 );
+                position += processedSize;
+            }
+            REQUIRE( outStream.Seek( 0, STREAM_SEEK_SET, nullptr ) == S_OK );
+            UInt32 processedSize = 0;
+            REQUIRE( outStream.Write( content.data(), kHeaderSize, &processedSize ) == S_OK );
+            REQUIRE( processedSize == kHeaderSize );
+
+            REQUIRE( outStream.flush() == S_OK );
+        }
+
+        // The last volume must have been truncated to its actual size.
+        buffer_t writtenContent;
+        std::size_t volumeIndex = 1;
+        for ( std::size_t offset = 0; offset < content.size(); offset += kVolumeSize, ++volumeIndex ) {
+            const fs::path volumePath = "split.bin.00" + std::to_string( volumeIndex );
+            INFO( "Volume: " << volumePath )
+            REQUIRE( fs::file_size( volumePath ) == std::min< std::uint64_t >( kVolumeSize, content.size() - offset ) );
+
+            const auto volumeContent = loadFile( volumePath );
+            writtenContent.insert( writtenContent.end(), volumeContent.cbegin(), volumeContent.cend() );
+        }
+        REQUIRE_FALSE( fs::exists( "split.bin.00" + std::to_string( volumeIndex ) ) );
+        REQUIRE( writtenContent == content );
+    }
+}
+
+TEST_CASE( "CMultiVolumeOutStream: Shrinking a split file", "[cmultivolumeoutstream]" ) {
+    const TempTestDirectory testDir{ "test_cmultivolumeoutstream" };
+    INFO( "Test directory: " << testDir )
+
+    const buffer_t content( 250, static_cast< byte_t >( 0x2A ) );
+    {
+        CMultiVolumeOutStream outStream{ 100, fs::path{ "split.bin" } };
+        UInt32 processedSize = 0;
+        for ( std::size_t position = 0; position < content.size(); position += processedSize ) {
+            const auto writeSize = static_cast< UInt32 >( content.size() - position );
+            REQUIRE( outStream.Write( &content[ position ], writeSize, &processedSize ) == S_OK );
+        }
+        REQUIRE( fs::exists( "split.bin.003" ) );
+
+        REQUIRE( outStream.SetSize( 150 ) == S_OK );
+        REQUIRE( outStream.flush() == S_OK );
+    }
+    REQUIRE( fs::file_size( "split.bin.001" ) == 100 );
+    REQUIRE( fs::file_size( "split.bin.002" ) == 50 );
+    REQUIRE_FALSE( fs::exists( "split.bin.003" ) );
+}
@@ -0,0 +1,65 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+#include "utils/random.hpp"
+
+#include <internal/compressibility.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace bit7z;
+using namespace bit7z::test;
+using namespace bit7z::test::filesystem;
+
+TEST_CASE( "compressibility: Detecting incompressible file extensions", "[compressibility]" ) {
+    REQUIRE( hasIncompressibleExtension( BIT7Z_NATIVE_STRING( "photo.jpg" ) ) );
+    REQUIRE( hasIncompressibleExtension( BIT7Z_NATIVE_STRING( "folder/PHOTO.JPG" ) ) );
+    REQUIRE( hasIncompressibleExtension( BIT7Z_NATIVE_STRING( "movie.mp4" ) ) );
+    REQUIRE( hasIncompressibleExtension( BIT7Z_NATIVE_STRING( "archive.tar.gz" ) ) );
+
+    REQUIRE_FALSE( hasIncompressibleExtension( BIT7Z_NATIVE_STRING( "source.cpp" ) ) );
+    REQUIRE_FALSE( hasIncompressibleExtension( BIT7Z_NATIVE_STRING( "archive.tar" ) ) );
+    REQUIRE_FALSE( hasIncompressibleExtension( BIT7Z_NATIVE_STRING( "jpg" ) ) );
+    REQUIRE_FALSE( hasIncompressibleExtension( BIT7Z_NATIVE_STRING( "README" ) ) );
+}
+
+TEST_CASE( "compressibility: Computing the entropy of some content", "[compressibility]" ) {
+    REQUIRE( contentEntropy( nullptr, 0 ) == Approx( 0.0 ) );
+
+    const buffer_t constantContent( 1024, static_cast< byte_t >( 0x2A ) );
+    REQUIRE( contentEntropy( constantContent.data(), constantContent.size() ) == Approx( 0.0 ) );
+
+    buffer_t uniformContent;
+    for ( int value = 0; value < 256; ++value ) {
+        uniformContent.push_back( static_cast< byte_t >( value ) );
+    }
+    REQUIRE( contentEntropy( uniformContent.data(), uniformContent.size() ) == Approx( 8.0 ) );
+}
+
+TEST_CASE( "compressibility: Detecting incompressible file content", "[compressibility]" ) {
+    const TempTestDirectory testDir{ "test_compressibility" };
+    INFO( "Test directory: " << testDir )
+
+    writeFile( "random.bin", randomContent( 64 * 1024 ) );
+    REQUIRE( hasIncompressibleContent( BIT7Z_NATIVE_STRING( "random.bin" ) ) );
+
+    writeFile( "constant.bin", buffer_t( 64 * 1024, static_cast< byte_t >( 0x2A ) ) );
+    REQUIRE_FALSE( hasIncompressibleContent( BIT7Z_NATIVE_STRING( "constant.bin" ) ) );
+
+    // Small files are always considered compressible.
+    writeFile( "small_random.bin", randomContent( 512 ) );
+    REQUIRE_FALSE( hasIncompressibleContent( BIT7Z_NATIVE_STRING( "small_random.bin" ) ) );
+}
@@ -0,0 +1,90 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+
+#include <internal/contenthash.hpp>
+
+#include <algorithm>
+#include <string>
+
+using namespace bit7z;
+using namespace bit7z::test::filesystem;
+
+TEST_CASE( "ContentHasher: Hashing empty content", "[contenthash]" ) {
+    const ContentHasher hasher;
+    REQUIRE( hasher.finalize() == ContentHash{ 0, 0 } );
+}
+
+TEST_CASE( "ContentHasher: Hashing matches the MurmurHash3 reference values", "[contenthash]" ) {
+    const std::string content = "The quick brown fox jumps over the lazy dog";
+
+    ContentHasher hasher;
+    hasher.update( content.data(), content.size() );
+    REQUIRE( hasher.finalize() == ContentHash{ 0xE34BBC7BBC071B6CULL, 0x7A433CA9C49A9347ULL } );
+}
+
+TEST_CASE( "ContentHasher: Hashing content incrementally", "[contenthash]" ) {
+    const std::string content = "The quick brown fox jumps over the lazy dog";
+
+    ContentHasher hasher;
+    hasher.update( content.data(), content.size() );
+    const auto expectedHash = hasher.finalize();
+
+    const auto chunkSize = GENERATE( 1u, 3u, 8u, 16u, 17u );
+    DYNAMIC_SECTION( "Chunk size: " << chunkSize ) {
+        ContentHasher chunkedHasher;
+        for ( std::size_t offset = 0; offset < content.size(); offset += chunkSize ) {
+            const auto size = std::min< std::size_t >( chunkSize, content.size() - offset );
+            chunkedHasher.update( content.data() + offset, size );
+        }
+        REQUIRE( chunkedHasher.finalize() == expectedHash );
+    }
+}
+
+TEST_CASE( "ContentHasher: Hashing the content of files", "[contenthash]" ) {
+    static const TestDirectory testDir{ test_filesystem_dir };
+
+    const auto fileHash = hashFileContent( BIT7Z_NATIVE_STRING( "italy.svg" ) );
+
+    const auto fileContent = loadFile( "italy.svg" );
+    ContentHasher hasher;
+    hasher.update( fileContent.data(), fileContent.size() );
+    REQUIRE( fileHash == hasher.finalize() );
+
+    REQUIRE( fileHash != hashFileContent( BIT7Z_NATIVE_STRING( "folder/clouds.jpg" ) ) );
+}
+
+TEST_CASE( "ContentHasher: Comparing the content of files", "[contenthash]" ) {
+    const TempTestDirectory testDir{ "test_contenthash" };
+    INFO( "Test directory: " << testDir )
+
+    // Larger than the chunks read by isSameFileContent, so that the files are compared in several steps.
+    const buffer_t content( 200 * 1024, 0x2A );
+    writeFile( "original.bin", content );
+    writeFile( "copy.bin", content );
+
+    auto differentContent = content;
+    differentContent.back() = 0x42;
+    writeFile( "different.bin", differentContent );
+
+    auto longerContent = content;
+    longerContent.push_back( 0x2A );
+    writeFile( "longer.bin", longerContent );
+
+    REQUIRE( isSameFileContent( BIT7Z_NATIVE_STRING( "original.bin" ), BIT7Z_NATIVE_STRING( "copy.bin" ) ) );
+    REQUIRE_FALSE( isSameFileContent( BIT7Z_NATIVE_STRING( "original.bin" ), BIT7Z_NATIVE_STRING( "different.bin" ) ) );
+    REQUIRE_FALSE( isSameFileContent( BIT7Z_NATIVE_STRING( "original.bin" ), BIT7Z_NATIVE_STRING( "longer.bin" ) ) );
+    REQUIRE_FALSE( isSameFileContent( BIT7Z_NATIVE_STRING( "longer.bin" ), BIT7Z_NATIVE_STRING( "original.bin" ) ) );
+}
@@ -0,0 +1,478 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/crc.hpp"
+#include "utils/filesystem.hpp"
+
+#include <bit7z/bittypes.hpp>
+#include <internal/inplaceappender.hpp>
+#include <internal/windows.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace bit7z;
+using namespace bit7z::test;
+using namespace bit7z::test::filesystem;
+
+namespace {
+using TestEntries = std::vector< std::pair< std::string, buffer_t > >;
+
+void appendLE( buffer_t& buffer, std::uint64_t value, std::size_t size ) {
+    for ( std::size_t index = 0; index < size; ++index ) {
+        buffer.push_back( static_cast< byte_t >( ( value >> ( 8 * index ) ) & 0xFFU ) );
+    }
+}
+
+auto readLE( const buffer_t& buffer, std::size_t offset, std::size_t size ) -> std::uint64_t {
+    std::uint64_t result = 0;
+    for ( std::size_t index = size; index > 0; --index ) {
+        result = ( result << 8U ) | buffer.at( offset + index - 1 );
+    }
+    return result;
+}
+
+void writeOctal( buffer_t& header, std::size_t offset, std::size_t length, std::uint64_t value ) {
+    std::string field( length - 1, '0' );
+    for ( auto digit = field.rbegin(); digit != field.rend() && value > 0; ++digit, value >>= 3U ) {
+        *digit = static_cast< char >( '0' + ( value & 7U ) );
+    }
+    std::copy( field.cbegin(), field.cend(), header.begin() + static_cast< std::ptrdiff_t >( offset ) );
+}
+
+constexpr std::size_t kTarBlockSize = 512;
+
+// A ustar archive, padded to a record of 20 blocks like GNU tar does.
+auto makeTar( const TestEntries& entries ) -> buffer_t {
+    buffer_t result;
+    for ( const auto& entry : entries ) {
+        buffer_t header( kTarBlockSize, 0 );
+        std::copy( entry.first.cbegin(), entry.first.cend(), header.begin() );
+        writeOctal( header, 100, 8, 0644 );
+        writeOctal( header, 124, 12, entry.second.size() );
+        writeOctal( header, 136, 12, 0 );
+        header[ 156 ] = '0';
+        const std::string magic = "ustar";
+        std::copy( magic.cbegin(), magic.cend(), header.begin() + 257 );
+        header[ 263 ] = '0';
+        header[ 264 ] = '0';
+        std::fill_n( header.begin() + 148, 8, static_cast< byte_t >( ' ' ) );
+        std::uint64_t checksum = 0;
+        for ( const auto byte : header ) {
+            checksum += byte;
+        }
+        writeOctal( header, 148, 7, checksum );
+
+        result.insert( result.end(), header.cbegin(), header.cend() );
+        result.insert( result.end(), entry.second.cbegin(), entry.second.cend() );
+        result.resize( ( ( result.size() + kTarBlockSize - 1 ) / kTarBlockSize ) * kTarBlockSize, 0 );
+    }
+    result.resize( result.size() + 2 * kTarBlockSize, 0 );
+    result.resize( ( ( result.size() + 20 * kTarBlockSize - 1 ) / ( 20 * kTarBlockSize ) ) * 20 * kTarBlockSize, 0 );
+    return result;
+}
+
+auto listTar( const buffer_t& archive ) -> TestEntries {
+    TestEntries result;
+    std::size_t offset = 0;
+    while ( offset + kTarBlockSize <= archive.size() && archive[ offset ] != 0 ) {
+        const auto nameBegin = archive.cbegin() + static_cast< std::ptrdiff_t >( offset );
+        std::string name{ nameBegin, std::find( nameBegin, nameBegin + 100, 0 ) };
+        const auto size = std::stoull( std::string{ nameBegin + 124, nameBegin + 135 }, nullptr, 8 );
+        const auto dataBegin = nameBegin + kTarBlockSize;
+        const auto dataEnd = dataBegin + static_cast< std::ptrdiff_t >( size );
+        result.emplace_back( std::move( name ), buffer_t{ dataBegin, dataEnd } );
+        offset += kTarBlockSize + ( ( size + kTarBlockSize - 1 ) / kTarBlockSize ) * kTarBlockSize;
+    }
+    return result;
+}
+
+// A zip archive with stored entries.
+auto makeZip( const TestEntries& entries, const std::string& comment = {} ) -> buffer_t {
+    buffer_t result;
+    buffer_t centralDir;
+    for ( const auto& entry : entries ) {
+        const auto localHeaderOffset = result.size();
+        const auto crc = crc32( entry.second );
+        appendLE( result, 0x04034B50, 4 );
+        appendLE( result, 20, 2 ); // Version needed to extract.
+        appendLE( result, 0, 2 ); // Flags.
+        appendLE( result, 0, 2 ); // Stored.
+        appendLE( result, 0, 2 ); // Time.
+        appendLE( result, 0x21, 2 ); // Date (1980-01-01).
+        appendLE( result, crc, 4 );
+        appendLE( result, entry.second.size(), 4 );
+        appendLE( result, entry.second.size(), 4 );
+        appendLE( result, entry.first.size(), 2 );
+        appendLE( result, 0, 2 ); // Extra field size.
+        result.insert( result.end(), entry.first.cbegin(), entry.first.cend() );
+        result.insert( result.end(), entry.second.cbegin(), entry.second.cend() );
+
+        appendLE( centralDir, 0x02014B50, 4 );
+        appendLE( centralDir, 20, 2 ); // Version made by.
+        appendLE( centralDir, 20, 2 ); // Version needed to extract.
+        appendLE( centralDir, 0, 2 );
+        appendLE( centralDir, 0, 2 );
+        appendLE( centralDir, 0, 2 );
+        appendLE( centralDir, 0x21, 2 );
+        appendLE( centralDir, crc, 4 );
+        appendLE( centralDir, entry.second.size(), 4 );
+        appendLE( centralDir, entry.second.size(), 4 );
+        appendLE( centralDir, entry.first.size(), 2 );
+        appendLE( centralDir, 0, 2 ); // Extra field size.
+        appendLE( centralDir, 0, 2 ); // Comment size.
+        appendLE( centralDir, 0, 2 ); // Disk number.
+        appendLE( centralDir, 0, 2 ); // Internal attributes.
+        appendLE( centralDir, 0, 4 ); // External attributes.
+        appendLE( centralDir, localHeaderOffset, 4 );
+        centralDir.insert( centralDir.end(), entry.first.cbegin(), entry.first.cend() );
+    }
+    const auto centralDirOffset = result.size();
+    result.insert( result.end(), centralDir.cbegin(), centralDir.cend() );
+    appendLE( result, 0x06054B50, 4 );
+    appendLE( result, 0, 2 );
+    appendLE( result, 0, 2 );
+    appendLE( result, entries.size(), 2 );
+    appendLE( result, entries.size(), 2 );
+    appendLE( result, centralDir.size(), 4 );
+    appendLE( result, centralDirOffset, 4 );
+    appendLE( result, comment.size(), 2 );
+    result.insert( result.end(), comment.cbegin(), comment.cend() );
+    return result;
+}
+
+// Lists the entries of a zip archive made by makeZip, checking the consistency of its structures.
+auto listZip( const buffer_t& archive, const std::string& comment ) -> TestEntries {
+    const auto endRecordOffset = archive.size() - 22 - comment.size();
+    REQUIRE( readLE( archive, endRecordOffset, 4 ) == 0x06054B50 );
+    REQUIRE( std::string{ archive.cbegin() + static_cast< std::ptrdiff_t >( endRecordOffset + 22 ), archive.cend() } ==
+             comment );
+    const auto entries = readLE( archive, endRecordOffset + 10, 2 );
+    REQUIRE( readLE( archive, endRecordOffset + 8, 2 ) == entries );
+    const auto centralDirSize = readLE( archive, endRecordOffset + 12, 4 );
+    auto position = static_cast< std::size_t >( readLE( archive, endRecordOffset + 16, 4 ) );
+    REQUIRE( position + centralDirSize == endRecordOffset );
+
+    TestEntries result;
+    for ( std::uint64_t entry = 0; entry < entries; ++entry ) {
+        REQUIRE( readLE( archive, position, 4 ) == 0x02014B50 );
+        const auto crc = readLE( archive, position + 16, 4 );
+        const auto size = static_cast< std::size_t >( readLE( archive, position + 20, 4 ) );
+        const auto nameSize = static_cast< std::size_t >( readLE( archive, position + 28, 2 ) );
+        const auto localHeaderOffset = static_cast< std::size_t >( readLE( archive, position + 42, 4 ) );
+        const auto nameBegin = archive.cbegin() + static_cast< std::ptrdiff_t >( position + 46 );
+        std::string name{ nameBegin, nameBegin + static_cast< std::ptrdiff_t >( nameSize ) };
+
+        REQUIRE( readLE( archive, localHeaderOffset, 4 ) == 0x04034B50 );
+        const auto dataBegin = archive.cbegin() + static_cast< std::ptrdiff_t >( localHeaderOffset + 30 + nameSize );
+        buffer_t data{ dataBegin, dataBegin + static_cast< std::ptrdiff_t >( size ) };
+        REQUIRE( crc32( data ) == crc );
+
+        result.emplace_back( std::move( name ), std::move( data ) );
+        position += 46 + nameSize;
+    }
+    return result;
+}
+
+void writeToStream( IOutStream* stream, const buffer_t& content ) {
+    // Writing the second half first, as 7-Zip does when patching the headers after writing the items.
+    const auto half = content.size() / 2;
+    UInt32 processedSize = 0;
+    REQUIRE( stream->Seek( static_cast< Int64 >( half ), STREAM_SEEK_SET, nullptr ) == S_OK );
+    const auto secondHalfSize = static_cast< UInt32 >( content.size() - half );
+    REQUIRE( stream->Write( &content[ half ], secondHalfSize, &processedSize ) == S_OK );
+    REQUIRE( stream->Seek( 0, STREAM_SEEK_SET, nullptr ) == S_OK );
+    REQUIRE( stream->Write( content.data(), static_cast< UInt32 >( half ), &processedSize ) == S_OK );
+}
+
+const TestEntries kOldEntries{ // NOLINT(*-err58-cpp)
+    { "first.txt", buffer_t( 1000, 0x2A ) },
+    { "second.txt", buffer_t( 10, 0x42 ) }
+};
+
+const TestEntries kNewEntries{ // NOLINT(*-err58-cpp)
+    { "third.txt", buffer_t( 600, 0x33 ) },
+    { "folder/fourth.txt", buffer_t( 1, 0x44 ) }
+};
+} // namespace
+
+TEST_CASE( "InPlaceAppender: Appending items to a tar archive", "[inplaceappender]" ) {
+    const TempTestDirectory testDir{ "test_inplaceappender" };
+    INFO( "Test directory: " << testDir )
+
+    const auto originalArchive = makeTar( kOldEntries );
+    writeFile( "archive.tar", originalArchive );
+
+    auto appendPoint = findAppendPoint( "archive.tar", AppendableFormat::Tar );
+    REQUIRE( appendPoint );
+    REQUIRE( appendPoint->offset == 5 * kTarBlockSize ); // Two header blocks, and three data blocks.
+    REQUIRE( appendPoint->fileSize == originalArchive.size() );
+
+    const auto newArchive = makeTar( kNewEntries );
+    const std::uint32_t bufferSize = GENERATE( 0u, 4096u );
+    DYNAMIC_SECTION( "Write buffer size: " << bufferSize ) {
+        SECTION( "Committing the new items" ) {
+            {
+                const ArchiveFileLock archiveLock{ "archive.tar" };
+                InPlaceAppender appender{ archiveLock, std::move( *appendPoint ), bufferSize };
+                REQUIRE( fs::exists( "archive.tar.bit7z-journal" ) );
+                writeToStream( appender.stream(), newArchive );
+                REQUIRE_NOTHROW( appender.commit() );
+            }
+            REQUIRE_FALSE( fs::exists( "archive.tar.bit7z-journal" ) );
+
+            const auto result = loadFile( "archive.tar" );
+            REQUIRE( result.size() == 5 * kTarBlockSize + newArchive.size() );
+            const auto keptEnd = originalArchive.cbegin() + 5 * kTarBlockSize;
+            REQUIRE( std::equal( originalArchive.cbegin(), keptEnd, result.cbegin() ) );
+
+            TestEntries expectedEntries = kOldEntries;
+            expectedEntries.insert( expectedEntries.end(), kNewEntries.cbegin(), kNewEntries.cend() );
+            REQUIRE( listTar( result ) == expectedEntries );
+        }
+
+        SECTION( "Rolling back the new items" ) {
+            {
+                const ArchiveFileLock archiveLock{ "archive.tar" };
+                InPlaceAppender appender{ archiveLock, std::move( *appendPoint ), bufferSize };
+                writeToStream( appender.stream(), newArchive );
+            }
+            REQUIRE_FALSE( fs::exists( "archive.tar.bit7z-journal" ) );
+            REQUIRE( loadFile( "archive.tar" ) == originalArchive );
+        }
+    }
+}
+
+TEST_CASE( "InPlaceAppender: Appending items to a zip archive", "[inplaceappender]" ) {
+    const TempTestDirectory testDir{ "test_inplaceappender" };
+    INFO( "Test directory: " << testDir )
+
+    const std::string comment = GENERATE( as< std::string >(), "", "An archive comment" );
+    DYNAMIC_SECTION( "Archive comment: '" << comment << "'" ) {
+        const auto originalArchive = makeZip( kOldEntries, comment );
+        writeFile( "archive.zip", originalArchive );
+
+        auto appendPoint = findAppendPoint( "archive.zip", AppendableFormat::Zip );
+        REQUIRE( appendPoint );
+        const auto appendOffset = appendPoint->offset;
+        REQUIRE( appendOffset == readLE( originalArchive, originalArchive.size() - 22 - comment.size() + 16, 4 ) );
+
+        const auto newArchive = makeZip( kNewEntries );
+        {
+            const ArchiveFileLock archiveLock{ "archive.zip" };
+            InPlaceAppender appender{ archiveLock, std::move( *appendPoint ) };
+            writeToStream( appender.stream(), newArchive );
+            REQUIRE_NOTHROW( appender.commit() );
+        }
+        REQUIRE_FALSE( fs::exists( "archive.zip.bit7z-journal" ) );
+
+        // The old items are untouched, while the central directory lists both the old and the new items.
+        const auto result = loadFile( "archive.zip" );
+        REQUIRE( std::equal( originalArchive.cbegin(),
+                             originalArchive.cbegin() + static_cast< std::ptrdiff_t >( appendOffset ),
+                             result.cbegin() ) );
+
+        TestEntries expectedEntries = kOldEntries;
+        expectedEntries.insert( expectedEntries.end(), kNewEntries.cbegin(), kNewEntries.cend() );
+        REQUIRE( listZip( result, comment ) == expectedEntries );
+    }
+}
+
+TEST_CASE( "InPlaceAppender: Recovering an archive after an interrupted append", "[inplaceappender]" ) {
+    const TempTestDirectory testDir{ "test_inplaceappender" };
+    INFO( "Test directory: " << testDir )
+
+    const auto originalArchive = makeZip( kOldEntries );
+    writeFile( "archive.zip", originalArchive );
+
+    SECTION( "Interrupted after writing the journal" ) {
+        {
+            auto appendPoint = findAppendPoint( "archive.zip", AppendableFormat::Zip );
+            REQUIRE( appendPoint );
+            const ArchiveFileLock archiveLock{ "archive.zip" };
+            InPlaceAppender appender{ archiveLock, std::move( *appendPoint ) };
+            writeToStream( appender.stream(), makeZip( kNewEntries ) );
+
+            // Taking a snapshot of the files, as if the process crashed at this point.
+            fs::copy_file( "archive.zip", "crashed.zip" );
+            fs::copy_file( "archive.zip.bit7z-journal", "crashed.zip.bit7z-journal" );
+        }
+        REQUIRE( loadFile( "crashed.zip" ) != originalArchive );
+
+        REQUIRE_NOTHROW( InPlaceAppender::recover( ArchiveFileLock{ "crashed.zip" } ) );
+        REQUIRE_FALSE( fs::exists( "crashed.zip.bit7z-journal" ) );
+        REQUIRE( loadFile( "crashed.zip" ) == originalArchive );
+    }
+
+    SECTION( "Interrupted after committing" ) {
+        buffer_t journal;
+        {
+            auto appendPoint = findAppendPoint( "archive.zip", AppendableFormat::Zip );
+            REQUIRE( appendPoint );
+            const ArchiveFileLock archiveLock{ "archive.zip" };
+            InPlaceAppender appender{ archiveLock, std::move( *appendPoint ) };
+            writeToStream( appender.stream(), makeZip( kNewEntries ) );
+            journal = loadFile( "archive.zip.bit7z-journal" );
+            REQUIRE_NOTHROW( appender.commit() );
+        }
+        const auto committedArchive = loadFile( "archive.zip" );
+
+        // Taking a snapshot of the files, as if the process crashed right before deleting the committed journal.
+        writeFile( "committed.zip", committedArchive );
+        const std::string commitRecord = "BIT7ZCMT";
+        journal.insert( journal.end(), commitRecord.cbegin(), commitRecord.cend() );
+        writeFile( "committed.zip.bit7z-journal", journal );
+
+        REQUIRE_NOTHROW( InPlaceAppender::recover( ArchiveFileLock{ "committed.zip" } ) );
+        REQUIRE_FALSE( fs::exists( "committed.zip.bit7z-journal" ) );
+        REQUIRE( loadFile( "committed.zip" ) == committedArchive );
+    }
+
+    SECTION( "Interrupted while marking the journal as committed" ) {
+        {
+            auto appendPoint = findAppendPoint( "archive.zip", AppendableFormat::Zip );
+            REQUIRE( appendPoint );
+            const ArchiveFileLock archiveLock{ "archive.zip" };
+            InPlaceAppender appender{ archiveLock, std::move( *appendPoint ) };
+            writeToStream( appender.stream(), makeZip( kNewEntries ) );
+
+            // Taking a snapshot of the files, with only a part of the commit record written to the journal.
+            fs::copy_file( "archive.zip", "crashed.zip" );
+            auto journal = loadFile( "archive.zip.bit7z-journal" );
+            const std::string partialCommitRecord = "BIT7Z";
+            journal.insert( journal.end(), partialCommitRecord.cbegin(), partialCommitRecord.cend() );
+            writeFile( "crashed.zip.bit7z-journal", journal );
+        }
+
+        REQUIRE_NOTHROW( InPlaceAppender::recover( ArchiveFileLock{ "crashed.zip" } ) );
+        REQUIRE_FALSE( fs::exists( "crashed.zip.bit7z-journal" ) );
+        REQUIRE( loadFile( "crashed.zip" ) == originalArchive );
+    }
+
+    SECTION( "Archive replaced after the interruption" ) {
+        {
+            auto appendPoint = findAppendPoint( "archive.zip", AppendableFormat::Zip );
+            REQUIRE( appendPoint );
+            const ArchiveFileLock archiveLock{ "archive.zip" };
+            InPlaceAppender appender{ archiveLock, std::move( *appendPoint ) };
+            writeToStream( appender.stream(), makeZip( kNewEntries ) );
+            fs::copy_file( "archive.zip.bit7z-journal", "replaced.zip.bit7z-journal" );
+        }
+
+        // The journal does not belong to this archive, so it must be discarded without touching the archive.
+        TestEntries replacedEntries = kNewEntries;
+        replacedEntries.insert( replacedEntries.end(), kOldEntries.cbegin(), kOldEntries.cend() );
+        const auto replacedArchive = makeZip( replacedEntries );
+        REQUIRE( replacedArchive.size() > originalArchive.size() );
+        writeFile( "replaced.zip", replacedArchive );
+        REQUIRE_NOTHROW( InPlaceAppender::recover( ArchiveFileLock{ "replaced.zip" } ) );
+        REQUIRE_FALSE( fs::exists( "replaced.zip.bit7z-journal" ) );
+        REQUIRE( loadFile( "replaced.zip" ) == replacedArchive );
+    }
+
+    SECTION( "Interrupted while writing the journal" ) {
+        writeFile( "archive.zip.bit7z-journal", buffer_t( 10, 0x42 ) );
+
+        REQUIRE_NOTHROW( InPlaceAppender::recover( ArchiveFileLock{ "archive.zip" } ) );
+        REQUIRE_FALSE( fs::exists( "archive.zip.bit7z-journal" ) );
+        REQUIRE( loadFile( "archive.zip" ) == originalArchive );
+    }
+
+    SECTION( "No journal" ) {
+        REQUIRE_NOTHROW( InPlaceAppender::recover( ArchiveFileLock{ "archive.zip" } ) );
+        REQUIRE( loadFile( "archive.zip" ) == originalArchive );
+    }
+}
+
+TEST_CASE( "InPlaceAppender: Recovering an archive when opening it for reading", "[inplaceappender]" ) {
+    const TempTestDirectory testDir{ "test_inplaceappender" };
+    INFO( "Test directory: " << testDir )
+
+    const auto originalArchive = makeZip( kOldEntries );
+    writeFile( "archive.zip", originalArchive );
+
+    auto appendPoint = findAppendPoint( "archive.zip", AppendableFormat::Zip );
+    REQUIRE( appendPoint );
+    const ArchiveFileLock archiveLock{ "archive.zip" };
+    REQUIRE( archiveLock.isLocked() );
+    InPlaceAppender appender{ archiveLock, std::move( *appendPoint ) };
+    const auto newArchive = makeZip( kNewEntries );
+    writeToStream( appender.stream(), newArchive );
+
+    SECTION( "Append in progress" ) {
+        // The archive is locked by the appender, so the recovery must not touch it.
+        REQUIRE_FALSE( ArchiveFileLock( "archive.zip", false ).isLocked() );
+        InPlaceAppender::tryRecover( "archive.zip" );
+        REQUIRE( fs::exists( "archive.zip.bit7z-journal" ) );
+
+        REQUIRE_NOTHROW( appender.commit() );
+        REQUIRE_FALSE( fs::exists( "archive.zip.bit7z-journal" ) );
+        TestEntries expectedEntries = kOldEntries;
+        expectedEntries.insert( expectedEntries.end(), kNewEntries.cbegin(), kNewEntries.cend() );
+        REQUIRE( listZip( loadFile( "archive.zip" ), "" ) == expectedEntries );
+    }
+
+    SECTION( "Interrupted append" ) {
+        // Taking a snapshot of the files, as if the process crashed at this point.
+        fs::copy_file( "archive.zip", "crashed.zip" );
+        fs::copy_file( "archive.zip.bit7z-journal", "crashed.zip.bit7z-journal" );
+
+        InPlaceAppender::tryRecover( "crashed.zip" );
+        REQUIRE_FALSE( fs::exists( "crashed.zip.bit7z-journal" ) );
+        REQUIRE( loadFile( "crashed.zip" ) == originalArchive );
+    }
+}
+
+TEST_CASE( "InPlaceAppender: Archives that cannot be appended in place", "[inplaceappender]" ) {
+    const TempTestDirectory testDir{ "test_inplaceappender" };
+    INFO( "Test directory: " << testDir )
+
+    SECTION( "Tar archive with some data after the end-of-archive blocks" ) {
+        auto archive = makeTar( kOldEntries );
+        archive.back() = 0x42;
+        writeFile( "archive.tar", archive );
+        REQUIRE_FALSE( findAppendPoint( "archive.tar", AppendableFormat::Tar ) );
+    }
+
+    SECTION( "Tar archive with a corrupted header" ) {
+        auto archive = makeTar( kOldEntries );
+        archive[ 0 ] = 'F';
+        writeFile( "archive.tar", archive );
+        REQUIRE_FALSE( findAppendPoint( "archive.tar", AppendableFormat::Tar ) );
+    }
+
+    SECTION( "Zip archive with some data after the end record" ) {
+        auto archive = makeZip( kOldEntries );
+        archive.push_back( 0x42 );
+        writeFile( "archive.zip", archive );
+        REQUIRE_FALSE( findAppendPoint( "archive.zip", AppendableFormat::Zip ) );
+    }
+
+    SECTION( "Zip archive with some data before the archive" ) {
+        auto archive = makeZip( kOldEntries );
+        archive.insert( archive.begin(), 16, 0x42 );
+        writeFile( "archive.zip", archive );
+        REQUIRE_FALSE( findAppendPoint( "archive.zip", AppendableFormat::Zip ) );
+    }
+
+    SECTION( "Not an archive" ) {
+        writeFile( "archive.bin", buffer_t( 100, 0x42 ) );
+        REQUIRE_FALSE( findAppendPoint( "archive.bin", AppendableFormat::Tar ) );
+        REQUIRE_FALSE( findAppendPoint( "archive.bin", AppendableFormat::Zip ) );
+    }
+}
@@ -0,0 +1,89 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "utils/filesystem.hpp"
+
+#include <bit7z/bititemsvector.hpp>
+#include <bit7z/bitpropvariant.hpp>
+#include <bit7z/bittypes.hpp>
+#include <internal/inputitemsstore.hpp>
+
+#include <array>
+
+using namespace bit7z;
+using namespace bit7z::test::filesystem;
+
+namespace {
+constexpr std::array< BitProperty, 7 > kItemProperties = {
+    BitProperty::Path,
+    BitProperty::IsDir,
+    BitProperty::Size,
+    BitProperty::Attrib,
+    BitProperty::CTime,
+    BitProperty::ATime,
+    BitProperty::MTime
+};
+} // namespace
+
+TEST_CASE( "InputItemsStore: Storing items preserves their paths and properties", "[inputitemsstore]" ) {
+    static const TestDirectory testDir{ test_filesystem_dir };
+
+    const buffer_t buffer( 42, 0x2A );
+
+    BitItemsVector items;
+    indexDirectory( items, BIT7Z_STRING( "." ) );
+    indexBuffer( items, buffer, BIT7Z_STRING( "folder/buffer.bin" ) );
+    indexFile( items, BIT7Z_STRING( "folder/clouds.jpg" ), BIT7Z_STRING( "renamed/sky.jpg" ) );
+    indexFile( items, BIT7Z_STRING( "italy.svg" ) );
+    const BitItemsVector expectedItems = items;
+
+    InputItemsStore store;
+    store.append( items );
+    REQUIRE( items.empty() );
+    REQUIRE( store.size() == expectedItems.size() );
+
+    for ( std::size_t index = 0; index < expectedItems.size(); ++index ) {
+        const auto& expectedItem = expectedItems[ index ];
+        INFO( "Item index: " << index )
+        REQUIRE( store.itemPath( index ) == expectedItem.path() );
+        REQUIRE( store.inArchivePath( index ) == expectedItem.inArchivePath() );
+        for ( const auto property : kItemProperties ) {
+            REQUIRE( store.itemProperty( index, property ) == expectedItem.itemProperty( property ) );
+        }
+    }
+}
+
+TEST_CASE( "InputItemsStore: Appending items multiple times", "[inputitemsstore]" ) {
+    static const TestDirectory testDir{ test_filesystem_dir };
+
+    const buffer_t buffer( 42, 0x2A );
+
+    InputItemsStore store;
+    BitItemsVector items;
+    indexBuffer( items, buffer, BIT7Z_STRING( "buffer.bin" ) );
+    store.append( items );
+
+    indexDirectory( items, BIT7Z_STRING( "folder" ) );
+    const auto folderItemsCount = items.size();
+    const auto lastFolderItemPath = items.back().inArchivePath();
+    store.append( items );
+
+    indexBuffer( items, buffer, BIT7Z_STRING( "other.bin" ) );
+    store.append( items );
+
+    REQUIRE( store.size() == folderItemsCount + 2 );
+    REQUIRE( store.inArchivePath( 0 ) == L"buffer.bin" );
+    REQUIRE( store.inArchivePath( folderItemsCount ) == lastFolderItemPath );
+    REQUIRE( store.inArchivePath( folderItemsCount + 1 ) == L"other.bin" );
+}
@@ -14,6 +14,9 @@
 
 #include <catch2/catch.hpp>
 
+#include "utils/volumehandles.hpp"
+
+#include <bitvolumehandles.hpp>
 #include <bitwindows.hpp>
 #include <internal/guids.hpp>
 #include <internal/macros.hpp>
@@ -22,6 +25,8 @@
 
 #include <7zip/IStream.h>
 
+#include <future>
+#include <thread>
 #include <vector>
 
 namespace bit7z {
@@ -99,6 +104,8 @@ auto lruOrder( VolumesCache< MockStream, Policy >& cache ) -> std::vector< std::
 
 } // namespace
 
+using test::MaxVolumeHandlesGuard;
+
 // Container operations
 
 TEST_CASE( "VolumesCache: Empty cache", "[volumescache]" ) {
@@ -421,6 +428,67 @@ TEST_CASE( "VolumesCache: trackClosed delays eviction", "[volumescache][eviction
     REQUIRE( cache[ threshold ].stream != nullptr );
 }
 
+TEST_CASE( "VolumesCache: Caches share the process-wide budget of open handles", "[volumescache][eviction]" ) {
+    const auto initialStats = volumeHandlesStats();
+    REQUIRE( initialStats.openHandles == 0 );
+
+    const MaxVolumeHandlesGuard guard{ 4 };
+    REQUIRE( openHandlesThreshold() == 4 );
+    REQUIRE( volumeHandlesStats().maxOpenHandles == 4 );
+
+    VolumesCache< MockStream, EvictionPolicy::Oldest > firstCache;
+    addOpenVolume( firstCache );
+    addOpenVolume( firstCache );
+    {
+        VolumesCache< MockStream, EvictionPolicy::Oldest > secondCache;
+        addOpenVolume( secondCache );
+        REQUIRE( volumeHandlesStats().openHandles == 3 );
+
+        SECTION( "Opening a volume evicts the least recently used volume of another cache" ) {
+            addOpenVolume( secondCache );
+            REQUIRE( firstCache[ 0 ].stream == nullptr );
+            REQUIRE( firstCache[ 1 ].stream != nullptr );
+            REQUIRE( lruOrder( firstCache ) == std::vector< std::size_t >{ 1 } );
+            REQUIRE( lruOrder( secondCache ) == std::vector< std::size_t >{ 1, 0 } );
+
+            // The first cache's remaining volume becomes the most recently used one,
+            // so the next opening evicts the oldest volume of the second cache.
+            firstCache.promote( firstCache[ 1 ], 1 );
+            addOpenVolume( secondCache );
+            REQUIRE( firstCache[ 1 ].stream != nullptr );
+            REQUIRE( secondCache[ 0 ].stream == nullptr );
+            REQUIRE( lruOrder( secondCache ) == std::vector< std::size_t >{ 2, 1 } );
+
+            const auto stats = volumeHandlesStats();
+            REQUIRE( stats.openHandles == 3 );
+            REQUIRE( stats.opens - initialStats.opens == 5 );
+            REQUIRE( stats.evictions - initialStats.evictions == 2 );
+        }
+
+        SECTION( "Volumes of a cache locked by another thread are not evicted" ) {
+            std::promise< void > locked;
+            std::promise< void > unlock;
+            std::thread lockingThread{ [ & ]() {
+                const auto firstCacheLock = firstCache.lock();
+                locked.set_value();
+                unlock.get_future().wait();
+            } };
+            locked.get_future().wait();
+            addOpenVolume( secondCache );
+            unlock.set_value();
+            lockingThread.join();
+
+            REQUIRE( firstCache[ 0 ].stream != nullptr );
+            REQUIRE( firstCache[ 1 ].stream != nullptr );
+            REQUIRE( secondCache[ 0 ].stream == nullptr );
+            REQUIRE( volumeHandlesStats().openHandles == 3 );
+        }
+    }
+
+    // Destroying a cache releases its open handles from the budget.
+    REQUIRE( volumeHandlesStats().openHandles == 2 - ( firstCache[ 0 ].stream == nullptr ? 1u : 0u ) );
+}
+
 // Seek restoration
 
 TEST_CASE( "VolumesCache: trackReopen restores seek position", "[volumescache][seek]" ) {
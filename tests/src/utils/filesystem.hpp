@@ -139,6 +139,12 @@ inline auto loadFile( const fs::path& inFile ) -> buffer_t {
     return result;
 }
 
+inline void writeFile( const fs::path& outFile, const buffer_t& content ) {
+    fs::ofstream ofs{ outFile, fs::ofstream::binary };
+    // NOLINTNEXTLINE(*-pro-type-reinterpret-cast)
+    ofs.write( reinterpret_cast< const char* >( content.data() ), static_cast< std::streamsize >( content.size() ) );
+}
+
 #define REQUIRE_LOAD_FILE( var, in_file ) \
     const auto (var) = loadFile( in_file ); \
     REQUIRE_FALSE( (var).empty() )
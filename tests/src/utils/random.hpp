@@ -0,0 +1,35 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <bit7z/bittypes.hpp>
+
+#include <cstddef>
+#include <random>
+
+namespace bit7z { // NOLINT(modernize-concat-nested-namespaces)
+namespace test {
+
+// Incompressible content, which is the same at each call (for the same size).
+inline auto randomContent( std::size_t size ) -> buffer_t {
+    std::mt19937 generator{ 42 }; // NOLINT(*-msc51-cpp)
+    std::uniform_int_distribution< int > distribution{ 0, 255 };
+    buffer_t result( size );
+    for ( auto& byte : result ) {
+        byte = static_cast< byte_t >( distribution( generator ) );
+    }
+    return result;
+}
+
+} // namespace test
+} // namespace bit7z
+
+#endif //RANDOM_HPP
@@ -0,0 +1,69 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef STREAMS_HPP
+#define STREAMS_HPP
+
+#include <bit7z/bittypes.hpp>
+
+#include <cstddef>
+#include <streambuf>
+
+namespace bit7z { // NOLINT(*-concat-nested-namespaces)
+namespace test {
+
+// Stream buffer reading the given data, without supporting seeking (like a pipe or a socket).
+class NonSeekableInputBuffer final : public std::streambuf {
+    public:
+        explicit NonSeekableInputBuffer( const buffer_t& input ) : mInput{ input }, mPosition{ 0 } {}
+
+    protected:
+        auto underflow() -> int_type override {
+            if ( mPosition >= mInput.size() ) {
+                return traits_type::eof();
+            }
+            // Note: we provide one byte at a time, like a slow producer would do.
+            mCurrentChar = static_cast< char >( mInput[ mPosition ] );
+            ++mPosition;
+            setg( &mCurrentChar, &mCurrentChar, &mCurrentChar + 1 ); // NOLINT(*-pointer-arithmetic)
+            return traits_type::to_int_type( mCurrentChar );
+        }
+
+    private:
+        const buffer_t& mInput;
+        std::size_t mPosition;
+        char mCurrentChar{};
+};
+
+// Stream buffer appending the written data to a buffer, without supporting seeking (like a pipe or a socket).
+class NonSeekableOutputBuffer final : public std::streambuf {
+    public:
+        explicit NonSeekableOutputBuffer( buffer_t& output ) : mOutput{ output } {}
+
+    protected:
+        auto overflow( int_type character ) -> int_type override {
+            if ( !traits_type::eq_int_type( character, traits_type::eof() ) ) {
+                mOutput.push_back( static_cast< byte_t >( traits_type::to_char_type( character ) ) );
+            }
+            return traits_type::not_eof( character );
+        }
+
+        auto xsputn( const char* data, std::streamsize size ) -> std::streamsize override {
+            mOutput.insert( mOutput.end(), data, data + size ); // NOLINT(*-pointer-arithmetic)
+            return size;
+        }
+
+    private:
+        buffer_t& mOutput;
+};
+
+} // namespace test
+} // namespace bit7z
+
+#endif //STREAMS_HPP
@@ -0,0 +1,42 @@
+/*
+ * bit7z - A C++ static library to interface with the 7-zip shared libraries.
+ * Copyright (c) Riccardo Ostani - All Rights Reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef VOLUMEHANDLES_HPP
+#define VOLUMEHANDLES_HPP
+
+#include <bit7z/bitvolumehandles.hpp>
+
+#include <cstddef>
+
+namespace bit7z { // NOLINT(*-concat-nested-namespaces)
+namespace test {
+
+// Sets the budget of open volume handles, restoring the default one when going out of scope.
+struct MaxVolumeHandlesGuard final {
+    explicit MaxVolumeHandlesGuard( std::size_t maxHandles ) {
+        setMaxVolumeHandles( maxHandles );
+    }
+
+    MaxVolumeHandlesGuard( const MaxVolumeHandlesGuard& ) = delete;
+
+    MaxVolumeHandlesGuard( MaxVolumeHandlesGuard&& ) = delete;
+
+    auto operator=( const MaxVolumeHandlesGuard& ) -> MaxVolumeHandlesGuard& = delete;
+
+    auto operator=( MaxVolumeHandlesGuard&& ) -> MaxVolumeHandlesGuard& = delete;
+
+    ~MaxVolumeHandlesGuard() {
+        setMaxVolumeHandles( 0 );
+    }
+};
+
+} // namespace test
+} // namespace bit7z
+
+#endif //VOLUMEHANDLES_HPP